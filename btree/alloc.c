@@ -0,0 +1,246 @@
+/*
+ * Zásuvné alokátory: výchozí, aréna a počítající.
+ */
+
+#include "alloc.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <string.h>
+
+static void *allocator_default_allocate(void *context, size_t size)
+{
+  (void)context;
+  return malloc(size);
+}
+
+static void *allocator_default_reallocate(void *context, void *ptr,
+                                          size_t old_size, size_t size)
+{
+  (void)context;
+  (void)old_size;
+  return realloc(ptr, size);
+}
+
+static void allocator_default_release(void *context, void *ptr, size_t size)
+{
+  (void)context;
+  (void)size;
+  free(ptr);
+}
+
+const allocator_t allocator_default = {
+  allocator_default_allocate,
+  allocator_default_reallocate,
+  allocator_default_release,
+  NULL
+};
+
+/*
+ * Blok arény; data následují hned za hlavičkou.
+ */
+typedef struct arena_chunk
+{
+  struct arena_chunk *next;
+  size_t size;                  // velikost dat bloku
+  alignas(max_align_t) char data[];
+} arena_chunk_t;
+
+#define ARENA_ALIGN alignof(max_align_t)
+
+static size_t arena_round(size_t size)
+{
+  return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+/*
+ * Nový blok pro objekt velikosti size. Objekt větší než čtvrtina bloku
+ * dostane vlastní blok přesné velikosti, který se zařadí za aktuální, aby
+ * zbytek aktuálního bloku zůstal využitelný.
+ */
+static void *arena_grow(arena_t *arena, size_t size)
+{
+  bool dedicated = size > arena->chunk_size / 4;
+  size_t data_size = dedicated ? size : arena->chunk_size;
+  arena_chunk_t *chunk =
+      allocator_alloc(arena->parent, sizeof(arena_chunk_t) + data_size);
+  if (chunk == NULL)
+    return NULL;
+  chunk->size = data_size;
+  arena->reserved += sizeof(arena_chunk_t) + data_size;
+
+  if (dedicated && arena->chunks != NULL)
+  {
+    chunk->next = arena->chunks->next;
+    arena->chunks->next = chunk;
+  }
+  else
+  {
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->next = chunk->data + size;
+    arena->end = chunk->data + data_size;
+  }
+  arena->last = chunk->data;
+  arena->used += size;
+  return chunk->data;
+}
+
+static void *arena_allocate(void *context, size_t size)
+{
+  arena_t *arena = context;
+  size = arena_round(size > 0 ? size : 1);
+  if ((size_t)(arena->end - arena->next) < size)
+    return arena_grow(arena, size);
+  char *ptr = arena->next;
+  arena->next += size;
+  arena->last = ptr;
+  arena->used += size;
+  return ptr;
+}
+
+/*
+ * Poslední přidělený objekt se zvětší nebo zmenší na místě, pokud se vejde
+ * do aktuálního bloku; jinak se přesune a staré místo zůstane nevyužité.
+ */
+static void *arena_reallocate(void *context, void *ptr, size_t old_size,
+                              size_t size)
+{
+  arena_t *arena = context;
+  if (ptr == NULL)
+    return arena_allocate(arena, size);
+  old_size = arena_round(old_size);
+  size_t rounded = arena_round(size > 0 ? size : 1);
+  if (ptr == arena->last && (char *)ptr + old_size == arena->next &&
+      (size_t)(arena->end - (char *)ptr) >= rounded)
+  {
+    arena->next = (char *)ptr + rounded;
+    arena->used = arena->used - old_size + rounded;
+    return ptr;
+  }
+  void *moved = arena_allocate(arena, size);
+  if (moved != NULL)
+    memcpy(moved, ptr, old_size < size ? old_size : size);
+  return moved;
+}
+
+static void arena_release(void *context, void *ptr, size_t size)
+{
+  arena_t *arena = context;
+  size = arena_round(size > 0 ? size : 1);
+  if (ptr == arena->last && (char *)ptr + size == arena->next)
+  {
+    arena->next = ptr;
+    arena->last = NULL;
+    arena->used -= size;
+  }
+}
+
+void arena_init(arena_t *arena, size_t chunk_size, const allocator_t *parent)
+{
+  arena->allocator.allocate = arena_allocate;
+  arena->allocator.reallocate = arena_reallocate;
+  arena->allocator.release = arena_release;
+  arena->allocator.context = arena;
+  arena->parent = parent;
+  arena->chunk_size = arena_round(chunk_size > 0 ? chunk_size : 1);
+  arena->chunks = NULL;
+  arena->next = NULL;
+  arena->end = NULL;
+  arena->last = NULL;
+  arena->used = 0;
+  arena->reserved = 0;
+}
+
+/*
+ * Uvolnění všech objektů arény naráz. Aktuální blok se ponechá pro další
+ * alokace, ostatní se vrátí nadřazenému alokátoru.
+ */
+void arena_reset(arena_t *arena)
+{
+  arena_chunk_t *chunk = arena->chunks;
+  if (chunk == NULL)
+    return;
+  arena_chunk_t *next = chunk->next;
+  while (next != NULL)
+  {
+    arena_chunk_t *following = next->next;
+    arena->reserved -= sizeof(arena_chunk_t) + next->size;
+    allocator_free(arena->parent, next, sizeof(arena_chunk_t) + next->size);
+    next = following;
+  }
+  chunk->next = NULL;
+  arena->next = chunk->data;
+  arena->end = chunk->data + chunk->size;
+  arena->last = NULL;
+  arena->used = 0;
+}
+
+void arena_dispose(arena_t *arena)
+{
+  arena_reset(arena);
+  if (arena->chunks != NULL)
+    allocator_free(arena->parent, arena->chunks,
+                   sizeof(arena_chunk_t) + arena->chunks->size);
+  arena_init(arena, arena->chunk_size, arena->parent);
+}
+
+static void counting_add(counting_allocator_t *counting, long delta)
+{
+  long live = atomic_fetch_add(&counting->live_bytes, delta) + delta;
+  long peak = atomic_load(&counting->peak_bytes);
+  while (live > peak &&
+         !atomic_compare_exchange_weak(&counting->peak_bytes, &peak, live))
+    ;
+}
+
+static void *counting_allocate(void *context, size_t size)
+{
+  counting_allocator_t *counting = context;
+  void *ptr = allocator_alloc(counting->parent, size);
+  if (ptr != NULL)
+  {
+    atomic_fetch_add(&counting->allocations, 1);
+    atomic_fetch_add(&counting->bytes, (long)size);
+    counting_add(counting, (long)size);
+  }
+  return ptr;
+}
+
+static void *counting_reallocate(void *context, void *ptr, size_t old_size,
+                                 size_t size)
+{
+  counting_allocator_t *counting = context;
+  if (ptr == NULL)
+    return counting_allocate(counting, size);
+  void *moved = allocator_realloc(counting->parent, ptr, old_size, size);
+  if (moved != NULL && size > old_size)
+  {
+    atomic_fetch_add(&counting->bytes, (long)(size - old_size));
+    counting_add(counting, (long)(size - old_size));
+  }
+  else if (moved != NULL)
+    counting_add(counting, -(long)(old_size - size));
+  return moved;
+}
+
+static void counting_release(void *context, void *ptr, size_t size)
+{
+  counting_allocator_t *counting = context;
+  allocator_free(counting->parent, ptr, size);
+  atomic_fetch_add(&counting->releases, 1);
+  counting_add(counting, -(long)size);
+}
+
+void counting_init(counting_allocator_t *counting, const allocator_t *parent)
+{
+  counting->allocator.allocate = counting_allocate;
+  counting->allocator.reallocate = counting_reallocate;
+  counting->allocator.release = counting_release;
+  counting->allocator.context = counting;
+  counting->parent = parent;
+  atomic_init(&counting->allocations, 0);
+  atomic_init(&counting->releases, 0);
+  atomic_init(&counting->bytes, 0);
+  atomic_init(&counting->live_bytes, 0);
+  atomic_init(&counting->peak_bytes, 0);
+}
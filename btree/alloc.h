@@ -0,0 +1,96 @@
+/*
+ * Hlavičkový soubor pro zásuvné alokátory paměti stromu a tabulky.
+ */
+
+#ifndef IAL_BTREE_ALLOC_H
+#define IAL_BTREE_ALLOC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+ * Alokátor: tabulka funkcí a jejich kontext. Uvolnění a změna velikosti
+ * dostávají i původní velikost bloku, aby alokátor nemusel velikosti
+ * ukládat. Ukazatel NULL na alokátor znamená výchozí alokátor (malloc,
+ * realloc, free), volání přes allocator_* ho obslouží bez nepřímého skoku.
+ */
+typedef struct allocator
+{
+  void *(*allocate)(void *context, size_t size);
+  void *(*reallocate)(void *context, void *ptr, size_t old_size, size_t size);
+  void (*release)(void *context, void *ptr, size_t size);
+  void *context;
+} allocator_t;
+
+extern const allocator_t allocator_default;
+
+static inline void *allocator_alloc(const allocator_t *allocator, size_t size)
+{
+  if (allocator == NULL)
+    return malloc(size);
+  return allocator->allocate(allocator->context, size);
+}
+
+static inline void *allocator_realloc(const allocator_t *allocator, void *ptr,
+                                      size_t old_size, size_t size)
+{
+  if (allocator == NULL)
+    return realloc(ptr, size);
+  return allocator->reallocate(allocator->context, ptr, old_size, size);
+}
+
+static inline void allocator_free(const allocator_t *allocator, void *ptr,
+                                  size_t size)
+{
+  if (allocator == NULL)
+    free(ptr);
+  else if (ptr != NULL)
+    allocator->release(allocator->context, ptr, size);
+}
+
+/*
+ * Aréna: přiděluje posunem ukazatele v blocích velikosti chunk_size,
+ * získaných od nadřazeného alokátoru (parent, NULL = výchozí). Uvolnění
+ * vrátí místo jen u posledního přiděleného bloku, jinak paměť zůstává
+ * obsazená až do arena_reset nebo arena_dispose. Není vláknově bezpečná.
+ */
+struct arena_chunk;
+
+typedef struct arena
+{
+  allocator_t allocator;        // alokátor nad touto arénou
+  const allocator_t *parent;
+  size_t chunk_size;
+  struct arena_chunk *chunks;   // naposledy získaný blok jako první
+  char *next;                   // volné místo aktuálního bloku
+  char *end;
+  char *last;                   // poslední přidělený objekt
+  size_t used;                  // přidělené bajty od posledního resetu
+  size_t reserved;              // bajty bloků získané od parent
+} arena_t;
+
+void arena_init(arena_t *arena, size_t chunk_size, const allocator_t *parent);
+void arena_reset(arena_t *arena);
+void arena_dispose(arena_t *arena);
+
+/*
+ * Počítající alokátor: předává volání nadřazenému alokátoru a počítá
+ * alokace, uvolnění a živé bajty včetně jejich špičky. Čítače jsou
+ * atomické, alokátor je tak vláknově bezpečný, pokud je jím i parent.
+ */
+typedef struct counting_allocator
+{
+  allocator_t allocator;        // alokátor nad těmito čítači
+  const allocator_t *parent;
+  atomic_long allocations;      // alokace (zvětšení existujícího bloku ne)
+  atomic_long releases;         // uvolnění
+  atomic_long bytes;            // všechny přidělené bajty
+  atomic_long live_bytes;       // dosud neuvolněné bajty
+  atomic_long peak_bytes;       // nejvyšší hodnota live_bytes
+} counting_allocator_t;
+
+void counting_init(counting_allocator_t *counting, const allocator_t *parent);
+
+#endif
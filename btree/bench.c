@@ -0,0 +1,737 @@
+#include "btree.h"
+#include "alloc.h"
+#include "bench_util.h"
+#include "dump.h"
+#include "frozen.h"
+#include "parallel.h"
+#include "serial.h"
+#include "workload.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ITER
+#include "iter/stack.h"
+#endif // ITER
+
+const int traversal_sizes[] = {1000, 100000, 1000000};
+const int traversal_size_count = 3;
+
+void init_bench() {
+  printf("Binary Search Tree - benchmark\n");
+  printf("------------------------------\n");
+  printf("\n");
+}
+
+BENCH(bench_traversal_balanced, "Inorder traversal of a balanced tree")
+for (int i = 0; i < traversal_size_count; i++) {
+  bst_node_t *tree = bench_build_balanced(traversal_sizes[i]);
+  bst_items_t items = {NULL, 0, 0};
+  double start = bench_now();
+  bst_inorder(tree, &items);
+  char label[32];
+  snprintf(label, sizeof(label), "inorder n=%d", traversal_sizes[i]);
+  bench_report(label, items.size, bench_now() - start);
+  free(items.nodes);
+  bst_dispose(&tree);
+}
+ENDBENCH
+
+BENCH(bench_bulk_build, "Ascending inserts against a bulk build (n=127)")
+const int rounds = 20000;
+const int count = 127;
+char keys[127];
+bst_node_content_t values[127];
+for (int i = 0; i < count; i++)
+  keys[i] = (char)i;
+double elapsed = 0;
+for (int r = 0; r < rounds; r++) {
+  bst_node_t *tree;
+  bst_init(&tree);
+  for (int i = 0; i < count; i++) {
+    values[i].type = INTEGER;
+    values[i].value = malloc(sizeof(int));
+  }
+  double start = bench_now();
+  for (int i = 0; i < count; i++)
+    bst_insert(&tree, keys[i], values[i]);
+  elapsed += bench_now() - start;
+  bst_dispose(&tree);
+}
+bench_report("bst_insert ascending", (long)rounds * count, elapsed);
+elapsed = 0;
+for (int r = 0; r < rounds; r++) {
+  bst_node_t *tree;
+  for (int i = 0; i < count; i++) {
+    values[i].type = INTEGER;
+    values[i].value = malloc(sizeof(int));
+  }
+  double start = bench_now();
+  bst_build_from_sorted(&tree, keys, values, count);
+  elapsed += bench_now() - start;
+  bst_dispose(&tree);
+}
+bench_report("bst_build_from_sorted", (long)rounds * count, elapsed);
+ENDBENCH
+
+/*
+ * Zrychlení paralelního postorder průchodu a rušení podle počtu vláken.
+ * Degenerovaný strom jen pro iterativní variantu — rekurze by přetekla.
+ */
+BENCH(bench_parallel, "Parallel postorder and dispose against thread count")
+const int count = 4000000;
+const int thread_counts[] = {1, 2, 4, 8};
+#ifdef ITER
+const int shapes = 2;
+#else
+const int shapes = 1;
+#endif
+for (int shape = 0; shape < shapes; shape++) {
+  const char *name = shape == 0 ? "balanced" : "chain";
+  char label[48];
+  bst_node_t *tree =
+      shape == 0 ? bench_build_balanced(count) : bench_build_chain(count);
+  bst_items_t items = {NULL, 0, 0};
+  double start = bench_now();
+  bst_postorder(tree, &items);
+  double sequential = bench_now() - start;
+  snprintf(label, sizeof(label), "postorder %s sequential", name);
+  bench_report(label, items.size, sequential);
+  for (int t = 0; t < 4; t++) {
+    bst_pool_t *pool = bst_pool_create(thread_counts[t]);
+    items.size = 0;
+    start = bench_now();
+    bst_postorder_parallel(tree, &items, pool);
+    double elapsed = bench_now() - start;
+    snprintf(label, sizeof(label), "postorder %s threads=%d", name,
+             thread_counts[t]);
+    bench_report(label, items.size, elapsed);
+    printf("  %-32s %10.2fx\n", "speedup", sequential / elapsed);
+    bst_pool_destroy(pool);
+  }
+  free(items.nodes);
+
+  start = bench_now();
+  bst_dispose(&tree);
+  sequential = bench_now() - start;
+  snprintf(label, sizeof(label), "dispose %s sequential", name);
+  bench_report(label, count, sequential);
+  for (int t = 0; t < 4; t++) {
+    tree = shape == 0 ? bench_build_balanced(count) : bench_build_chain(count);
+    bst_pool_t *pool = bst_pool_create(thread_counts[t]);
+    start = bench_now();
+    bst_dispose_parallel(&tree, pool);
+    double elapsed = bench_now() - start;
+    snprintf(label, sizeof(label), "dispose %s threads=%d", name,
+             thread_counts[t]);
+    bench_report(label, count, elapsed);
+    printf("  %-32s %10.2fx\n", "speedup", sequential / elapsed);
+    bst_pool_destroy(pool);
+  }
+}
+ENDBENCH
+
+/*
+ * Vyhledávání se Zipfovým rozdělením nad všemi 128 nezápornými klíči typu
+ * char. Pořadí oblíbenosti klíčů je náhodné, aby horké klíče neležely
+ * systematicky u kořene. Strom se staví náhodným, nebo vzestupným
+ * vkládáním (degenerovaný strom pro rec a iter).
+ */
+BENCH(bench_zipf_search, "Zipf-distributed lookups over 128 keys")
+const int key_count = 128;
+const int lookups = 4000000;
+const double exponents[] = {0.0, 0.99, 1.2};
+char popular[128];
+char order[128];
+double cdf[128];
+char *samples = malloc(lookups);
+for (int e = 0; e < 3; e++) {
+  bench_seed(42);
+  for (int i = 0; i < key_count; i++)
+    popular[i] = (char)i;
+  for (int i = key_count - 1; i > 0; i--) {
+    int j = (int)(bench_rand() % (i + 1));
+    char swap = popular[i];
+    popular[i] = popular[j];
+    popular[j] = swap;
+  }
+  double total = 0;
+  for (int i = 0; i < key_count; i++) {
+    total += 1.0 / pow(i + 1, exponents[e]);
+    cdf[i] = total;
+  }
+  for (int i = 0; i < lookups; i++) {
+    double u = (bench_rand() >> 11) * (1.0 / 9007199254740992.0) * total;
+    int lo = 0;
+    int hi = key_count - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cdf[mid] < u)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    samples[i] = popular[lo];
+  }
+  for (int shape = 0; shape < 2; shape++) {
+    for (int i = 0; i < key_count; i++)
+      order[i] = (char)i;
+    for (int i = key_count - 1; shape == 0 && i > 0; i--) {
+      int j = (int)(bench_rand() % (i + 1));
+      char swap = order[i];
+      order[i] = order[j];
+      order[j] = swap;
+    }
+    bst_node_t *tree;
+    bst_init(&tree);
+    for (int i = 0; i < key_count; i++) {
+      bst_node_content_t value = {malloc(sizeof(int)), INTEGER};
+      *(int *)value.value = order[i];
+      bst_insert(&tree, order[i], value);
+    }
+    bst_node_content_t *value;
+    long found = 0;
+    double start = bench_now();
+    for (int i = 0; i < lookups; i++)
+      found += bst_search(tree, samples[i], &value);
+    char label[48];
+    snprintf(label, sizeof(label), "s=%.2f %s inserts", exponents[e],
+             shape == 0 ? "random" : "sorted");
+    bench_report(label, found, bench_now() - start);
+    bst_dispose(&tree);
+  }
+}
+free(samples);
+ENDBENCH
+
+/*
+ * Načtení uloženého stromu proti stavbě uzel po uzlu (malloc na uzel)
+ * a vyhledávání v namapovaném souboru proti vyhledávání ve stromu.
+ */
+BENCH(bench_save_load, "Load from a file against a node-by-node rebuild")
+const int sizes[] = {100000, 1000000};
+const int lookups = 2000000;
+for (int s = 0; s < 2; s++) {
+  char label[48];
+  double start = bench_now();
+  bst_node_t *tree = bench_build_balanced(sizes[s]);
+  snprintf(label, sizeof(label), "rebuild n=%d", sizes[s]);
+  bench_report(label, sizes[s], bench_now() - start);
+
+  start = bench_now();
+  if (!bst_save(tree, "bench_tree.bin")) {
+    printf("  %-32s %10s\n", "bst_save", "error");
+    bst_dispose(&tree);
+    continue;
+  }
+  snprintf(label, sizeof(label), "bst_save n=%d", sizes[s]);
+  bench_report(label, sizes[s], bench_now() - start);
+
+  bst_node_t *loaded;
+  bst_init(&loaded);
+  start = bench_now();
+  if (bst_load(&loaded, "bench_tree.bin")) {
+    snprintf(label, sizeof(label), "bst_load n=%d", sizes[s]);
+    bench_report(label, sizes[s], bench_now() - start);
+  } else
+    printf("  %-32s %10s\n", "bst_load", "error");
+  bst_dispose(&loaded);
+
+  bench_seed(7);
+  bst_mapped_t *mapped = bst_map("bench_tree.bin");
+  long found = 0;
+  if (mapped != NULL) {
+    start = bench_now();
+    for (int i = 0; i < lookups; i++) {
+      bst_node_content_t value;
+      found += bst_mapped_search(mapped, (int)(bench_rand() % sizes[s]),
+                                 &value, NULL);
+    }
+    snprintf(label, sizeof(label), "mapped search n=%d", sizes[s]);
+    bench_report(label, found, bench_now() - start);
+    bst_unmap(&mapped);
+  } else
+    printf("  %-32s %10s\n", "bst_map", "error");
+  remove("bench_tree.bin");
+
+  // Stejne hledani v puvodnim strome pres bst_search_key
+  bench_seed(7);
+  found = 0;
+  start = bench_now();
+  for (int i = 0; i < lookups; i++) {
+    bst_node_content_t *value;
+    found += bst_search_key(tree, (int)(bench_rand() % sizes[s]), &value,
+                            NULL);
+  }
+  snprintf(label, sizeof(label), "tree search n=%d", sizes[s]);
+  bench_report(label, found, bench_now() - start);
+  bst_dispose(&tree);
+}
+ENDBENCH
+
+// Prirodzene usporiadanie cez ukazatel na funkciu, pre porovnanie s NULL
+static int bench_compare(bst_key_t a, bst_key_t b) { return (a > b) - (a < b); }
+
+BENCH(bench_wide_keys, "Full-width integer keys, natural order and comparator")
+const int sizes[] = {1000000, 2000000};
+for (int s = 0; s < 2; s++) {
+  bst_key_t *keys = malloc(sizes[s] * sizeof(bst_key_t));
+  for (int c = 0; c < 2; c++) {
+    bst_compare_t compare = c == 0 ? NULL : bench_compare;
+    const char *name = c == 0 ? "natural" : "comparator";
+    char label[48];
+    bench_seed(11);
+    for (int i = 0; i < sizes[s]; i++)
+      keys[i] = (bst_key_t)bench_rand();
+    bst_node_t *tree;
+    bst_init(&tree);
+    double start = bench_now();
+    for (int i = 0; i < sizes[s]; i++) {
+      bst_node_content_t value = {malloc(sizeof(int)), INTEGER};
+      *(int *)value.value = i;
+      bst_insert_key(&tree, keys[i], value, compare);
+    }
+    snprintf(label, sizeof(label), "%s insert n=%d", name, sizes[s]);
+    bench_report(label, sizes[s], bench_now() - start);
+
+    // Hladanie v nahodnom poradi, polovica klucov vo strome nie je
+    for (int i = 0; i < sizes[s]; i += 2)
+      keys[i] = (bst_key_t)bench_rand();
+    bst_node_content_t *value;
+    long found = 0;
+    start = bench_now();
+    for (int i = 0; i < sizes[s]; i++)
+      found += bst_search_key(tree, keys[i], &value, compare);
+    snprintf(label, sizeof(label), "%s search n=%d", name, sizes[s]);
+    bench_report(label, sizes[s], bench_now() - start);
+
+    start = bench_now();
+    for (int i = 1; i < sizes[s]; i += 2)
+      bst_delete_key(&tree, keys[i], compare);
+    snprintf(label, sizeof(label), "%s delete n=%d", name, sizes[s] / 2);
+    bench_report(label, sizes[s] / 2, bench_now() - start);
+    bst_dispose(&tree);
+  }
+  free(keys);
+}
+ENDBENCH
+
+// Strom s klucmi offset..offset+count-1
+static bst_node_t *bench_build_shifted(int count, int offset) {
+  bst_node_t *tree = bench_build_balanced(count);
+  bst_items_t items = {NULL, 0, 0};
+  bst_inorder(tree, &items);
+  for (int i = 0; i < items.size; i++)
+    items.nodes[i]->key += offset;
+  free(items.nodes);
+  return tree;
+}
+
+BENCH(bench_union_split_join, "Union against repeated inserts, split and join")
+const int sizes[] = {10000, 1000000};
+for (int s = 0; s < 2; s++) {
+  char label[48];
+  int n = sizes[s];
+  // Polovica klucov druheho stromu je aj v prvom
+  bst_node_t *tree = bench_build_balanced(n);
+  bst_node_t *other = bench_build_shifted(n, n / 2);
+  // Preorder vyvazeneho stromu, aby opakovane vkladanie nevytvorilo retaz
+  double start = bench_now();
+  bst_items_t items = {NULL, 0, 0};
+  bst_preorder(other, &items);
+  for (int i = 0; i < items.size; i++) {
+    bst_node_content_t value = {malloc(sizeof(int)), INTEGER};
+    *(int *)value.value = *(int *)items.nodes[i]->content.value;
+    bst_insert_key(&tree, items.nodes[i]->key, value, NULL);
+  }
+  free(items.nodes);
+  snprintf(label, sizeof(label), "inserts n=%d+%d", n, n);
+  bench_report(label, 2 * n, bench_now() - start);
+  bst_dispose(&tree);
+
+  tree = bench_build_balanced(n);
+  start = bench_now();
+  bst_union(&tree, &other);
+  snprintf(label, sizeof(label), "union n=%d+%d", n, n);
+  bench_report(label, 2 * n, bench_now() - start);
+
+  // Rozdelenie na nahodnom kluci a opatovne spojenie
+  const int rounds = 100000;
+  bench_seed(5);
+  bst_node_t *lo;
+  bst_node_t *hi;
+  start = bench_now();
+  for (int i = 0; i < rounds; i++) {
+    bst_split(&tree, (bst_key_t)(bench_rand() % (3 * n / 2)), &lo, &hi);
+    bst_join(&tree, &lo, &hi);
+  }
+  snprintf(label, sizeof(label), "split+join n=%d", 3 * n / 2);
+  bench_report(label, rounds, bench_now() - start);
+  bst_stats_t stats;
+  bst_stats(tree, &stats);
+  printf("  %-32s %10d\n", "height after split+join", stats.height);
+  bst_dispose(&tree);
+}
+ENDBENCH
+
+// Puvodni vypis: dva prefixy alokovane pro kazdy uzel a printf po castech
+void bench_print_subtree(FILE *out, bst_node_t *tree, const char *prefix,
+                         int from) {
+  if (tree == NULL)
+    return;
+  char *subtree = malloc(strlen(prefix) + 4);
+  char *space = malloc(strlen(prefix) + 4);
+  strcat(strcpy(subtree, prefix), "  |");
+  strcat(strcpy(space, prefix), "   ");
+  if (from == 0)
+    fprintf(out, "%s\n", subtree);
+  bench_print_subtree(out, tree->right, from == 0 ? subtree : space, 1);
+  fprintf(out, "%s  +-", prefix);
+  fprintf(out, "[%c,", (int)tree->key);
+  fprintf(out, "%d", *(int *)tree->content.value);
+  fprintf(out, "]");
+  fprintf(out, "\n");
+  bench_print_subtree(out, tree->left, from == 1 ? subtree : space, 0);
+  if (from == 1)
+    fprintf(out, "%s\n", subtree);
+  free(space);
+  free(subtree);
+}
+
+BENCH(bench_dump, "Buffered dump against the printf-based tree printer")
+FILE *out = fopen("/dev/null", "w");
+const int sizes[] = {1000, 1000000};
+for (int s = 0; s < 2 && out != NULL; s++) {
+  char label[48];
+  bst_node_t *tree = bench_build_balanced(sizes[s]);
+  double start = bench_now();
+  bench_print_subtree(out, tree, "", 2);
+  fflush(out);
+  double printed = bench_now() - start;
+  snprintf(label, sizeof(label), "printf text n=%d", sizes[s]);
+  bench_report(label, sizes[s], printed);
+
+  dump_buffer_t dump;
+  dump_init(&dump, out);
+  start = bench_now();
+  bst_dump_tree(&dump, tree);
+  dump_flush(&dump);
+  fflush(out);
+  double dumped = bench_now() - start;
+  snprintf(label, sizeof(label), "dump text n=%d", sizes[s]);
+  bench_report(label, sizes[s], dumped);
+  printf("  %-32s %10.2fx\n", "speedup", printed / dumped);
+
+  start = bench_now();
+  bst_dump_json(&dump, tree);
+  dump_flush(&dump);
+  fflush(out);
+  snprintf(label, sizeof(label), "dump json n=%d", sizes[s]);
+  bench_report(label, sizes[s], bench_now() - start);
+  dump_dispose(&dump);
+  bst_dispose(&tree);
+}
+if (out != NULL)
+  fclose(out);
+ENDBENCH
+
+/*
+ * Vkládání náhodných klíčů (bez hodnot, měří se jen alokace uzlů), inorder
+ * průchod do pole a zrušení stromu pro jednotlivé alokátory. Aréna se mezi
+ * koly resetuje, takže od druhého kola bloky znovu používá.
+ */
+BENCH(bench_allocators, "Node allocation under each allocator (n=200000)")
+const int count = 200000;
+const int rounds = 5;
+counting_allocator_t counting;
+counting_init(&counting, NULL);
+arena_t arena;
+arena_init(&arena, 1 << 20, NULL);
+const char *names[] = {"default", "counting", "arena"};
+const allocator_t *allocators[] = {NULL, &counting.allocator, &arena.allocator};
+for (int a = 0; a < 3; a++) {
+  double insert = 0;
+  double traverse = 0;
+  double dispose = 0;
+  for (int r = 0; r < rounds; r++) {
+    bst_node_t *tree;
+    bst_init(&tree);
+    bst_node_content_t value = {NULL, INTEGER};
+    bench_seed(r + 1);
+    double start = bench_now();
+    for (int i = 0; i < count; i++)
+      bst_insert_key_with(&tree, (bst_key_t)(bench_rand() >> 33), value, NULL,
+                          allocators[a]);
+    insert += bench_now() - start;
+
+    bst_items_t items = {NULL, 0, 0, allocators[a]};
+    start = bench_now();
+    bst_inorder(tree, &items);
+    traverse += bench_now() - start;
+    bst_items_dispose(&items);
+
+    start = bench_now();
+    bst_dispose_with(&tree, allocators[a]);
+    if (allocators[a] == &arena.allocator)
+      arena_reset(&arena);
+    dispose += bench_now() - start;
+  }
+  char label[48];
+  snprintf(label, sizeof(label), "%s insert", names[a]);
+  bench_report(label, (long)rounds * count, insert);
+  snprintf(label, sizeof(label), "%s inorder", names[a]);
+  bench_report(label, (long)rounds * count, traverse);
+  snprintf(label, sizeof(label), "%s dispose", names[a]);
+  bench_report(label, (long)rounds * count, dispose);
+}
+printf("  counting: %ld allocations, %ld releases, peak %ld KB\n",
+       atomic_load(&counting.allocations), atomic_load(&counting.releases),
+       atomic_load(&counting.peak_bytes) / 1024);
+printf("  arena: %zu KB reserved after reset\n", arena.reserved / 1024);
+arena_dispose(&arena);
+ENDBENCH
+
+#if defined(SPLAY)
+#define BENCH_VARIANT "splay"
+#elif defined(ITER)
+#define BENCH_VARIANT "iter"
+#else
+#define BENCH_VARIANT "rec"
+#endif
+
+// Cil zataze: strom s celociselnymi klucmi a hodnotami typu INTEGER
+void *bench_tree_create(void *data, const wl_spec_t *spec) {
+  bst_node_t **tree = malloc(sizeof(bst_node_t *));
+  if (tree != NULL)
+    bst_init(tree);
+  return tree;
+}
+
+bool bench_tree_apply(void *state, wl_kind_t kind, int32_t key) {
+  bst_node_t **tree = state;
+  bst_node_content_t *found;
+  bst_node_content_t value = {NULL, INTEGER};
+  switch (kind) {
+  case WL_READ:
+#ifdef SPLAY
+    return bst_search_splay(tree, key, &found, NULL);
+#else
+    return bst_search_key(*tree, key, &found, NULL);
+#endif // SPLAY
+  case WL_INSERT:
+    value.value = malloc(sizeof(int));
+    *(int *)value.value = key;
+    bst_insert_key(tree, key, value, NULL);
+    return false;
+  default:
+    bst_delete_key(tree, key, NULL);
+    return false;
+  }
+}
+
+void bench_tree_destroy(void *state) {
+  bst_dispose(state);
+  free(state);
+}
+
+const wl_target_t bench_tree_target = {"bst", bench_tree_create,
+                                       bench_tree_apply, bench_tree_destroy,
+                                       NULL};
+
+BENCH(bench_workloads, "Seeded workloads (keys=65536, 1M ops per run)")
+wl_run_suite(BENCH_VARIANT, &bench_tree_target, 65536, 1000000, NULL);
+ENDBENCH
+
+#ifdef ITER
+
+BENCH(bench_frozen_search, "Eytzinger snapshot against pointer-chasing search")
+const int sizes[] = {1000, 100000, 10000000};
+const int lookups = 5000000;
+int *keys = malloc(lookups * sizeof(int));
+for (int s = 0; s < 3; s++) {
+  char label[48];
+  bst_node_t *tree;
+  bst_init(&tree);
+  // Nahodne poradie alokacii uzlov ako po postupnom vkladani
+  int *order = malloc(sizeof(int) * sizes[s]);
+  for (int i = 0; i < sizes[s]; i++)
+    order[i] = i;
+  bench_seed(7);
+  for (int i = sizes[s] - 1; i > 0; i--) {
+    int j = bench_rand() % (i + 1);
+    int swap = order[i];
+    order[i] = order[j];
+    order[j] = swap;
+  }
+  bst_node_t **nodes = malloc(sizeof(bst_node_t *) * sizes[s]);
+  for (int i = 0; i < sizes[s]; i++)
+    nodes[order[i]] = bench_new_node(order[i]);
+  free(order);
+  for (int i = 0; i + 1 < sizes[s]; i++)
+    nodes[i]->right = nodes[i + 1];
+  tree = nodes[0];
+  free(nodes);
+  bst_balance(&tree);
+
+  for (int i = 0; i < lookups; i++)
+    keys[i] = bench_rand() % (2 * sizes[s]);
+  bst_node_content_t *value;
+  long found = 0;
+  double start = bench_now();
+  for (int i = 0; i < lookups; i++)
+    found += bst_search_key(tree, keys[i], &value, NULL);
+  double pointer = bench_now() - start;
+  snprintf(label, sizeof(label), "pointer search n=%d", sizes[s]);
+  bench_report(label, lookups, pointer);
+
+  bst_frozen_t *frozen = bst_freeze(tree);
+  start = bench_now();
+  for (int i = 0; i < lookups; i++)
+    found -= bst_frozen_search(frozen, keys[i], &value);
+  double eytzinger = bench_now() - start;
+  snprintf(label, sizeof(label), "frozen search n=%d", sizes[s]);
+  bench_report(label, lookups, eytzinger);
+  printf("  %-32s %10.2fx\n", "speedup", pointer / eytzinger);
+  if (found != 0)
+    printf("  results differ\n");
+  bst_frozen_dispose(&frozen);
+  bst_dispose(&tree);
+}
+free(keys);
+ENDBENCH
+
+BENCH(bench_stack_shallow, "Push/pop within the inline stack buffer")
+const long rounds = 2000000;
+const int depth = 20;
+stack_bst_t stack;
+stack_bst_init(&stack);
+bst_node_t *sink = NULL;
+double start = bench_now();
+for (long r = 0; r < rounds; r++) {
+  for (int i = 0; i < depth; i++)
+    stack_bst_push(&stack, (bst_node_t *)&stack);
+  for (int i = 0; i < depth; i++)
+    sink = stack_bst_pop(&stack);
+}
+bench_report("push+pop depth=20", rounds * depth, bench_now() - start);
+stack_bst_dispose(&stack);
+if (sink == NULL)
+  printf("unreachable\n");
+ENDBENCH
+
+BENCH(bench_stack_deep, "Push/pop spilling to the heap buffer")
+const int depth = 10000000;
+stack_bst_t stack;
+stack_bst_init(&stack);
+double start = bench_now();
+for (int i = 0; i < depth; i++)
+  stack_bst_push(&stack, (bst_node_t *)&stack);
+while (!stack_bst_empty(&stack))
+  stack_bst_pop(&stack);
+bench_report("push+pop depth=10M", depth, bench_now() - start);
+stack_bst_dispose(&stack);
+ENDBENCH
+
+BENCH(bench_traversal_chain, "Traversal and dispose of a degenerate tree")
+const int count = 1000000;
+bst_node_t *tree = bench_build_chain(count);
+bst_items_t items = {NULL, 0, 0};
+double start = bench_now();
+bst_inorder(tree, &items);
+bench_report("inorder chain n=1M", items.size, bench_now() - start);
+items.size = 0;
+start = bench_now();
+bst_postorder(tree, &items);
+bench_report("postorder chain n=1M", items.size, bench_now() - start);
+free(items.nodes);
+start = bench_now();
+bst_dispose(&tree);
+bench_report("dispose chain n=1M", count, bench_now() - start);
+ENDBENCH
+
+BENCH(bench_traversal_morris, "Morris traversal against the stack-based one")
+const int count = 1000000;
+for (int shape = 0; shape < 2; shape++) {
+  bst_node_t *tree =
+      shape == 0 ? bench_build_balanced(count) : bench_build_chain(count);
+  const char *name = shape == 0 ? "balanced" : "chain";
+  char label[32];
+  bst_items_t items = {NULL, 0, 0};
+  double start = bench_now();
+  bst_inorder(tree, &items);
+  snprintf(label, sizeof(label), "inorder %s", name);
+  bench_report(label, items.size, bench_now() - start);
+  items.size = 0;
+  start = bench_now();
+  bst_inorder_morris(tree, &items);
+  snprintf(label, sizeof(label), "inorder_morris %s", name);
+  bench_report(label, items.size, bench_now() - start);
+  items.size = 0;
+  start = bench_now();
+  bst_preorder(tree, &items);
+  snprintf(label, sizeof(label), "preorder %s", name);
+  bench_report(label, items.size, bench_now() - start);
+  items.size = 0;
+  start = bench_now();
+  bst_preorder_morris(tree, &items);
+  snprintf(label, sizeof(label), "preorder_morris %s", name);
+  bench_report(label, items.size, bench_now() - start);
+  free(items.nodes);
+  bst_dispose(&tree);
+}
+ENDBENCH
+
+BENCH(bench_dispose_flatten, "Rotation-based dispose against the stack-based one")
+const int count = 1000000;
+for (int shape = 0; shape < 2; shape++) {
+  const char *name = shape == 0 ? "balanced" : "chain";
+  char label[32];
+  bst_node_t *tree =
+      shape == 0 ? bench_build_balanced(count) : bench_build_chain(count);
+  double start = bench_now();
+  bst_dispose(&tree);
+  snprintf(label, sizeof(label), "dispose %s", name);
+  bench_report(label, count, bench_now() - start);
+  tree = shape == 0 ? bench_build_balanced(count) : bench_build_chain(count);
+  start = bench_now();
+  bst_dispose_flatten(&tree);
+  snprintf(label, sizeof(label), "dispose_flatten %s", name);
+  bench_report(label, count, bench_now() - start);
+}
+ENDBENCH
+
+#endif // ITER
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && strcmp(argv[1], "--json") == 0) {
+    dump_buffer_t json;
+    dump_init(&json, stdout);
+    wl_run_suite(BENCH_VARIANT, &bench_tree_target, 65536, 1000000, &json);
+    dump_flush(&json);
+    dump_dispose(&json);
+    return 0;
+  }
+
+  init_bench();
+
+  bench_traversal_balanced();
+  bench_bulk_build();
+  bench_parallel();
+  bench_zipf_search();
+  bench_save_load();
+  bench_wide_keys();
+  bench_union_split_join();
+  bench_dump();
+  bench_allocators();
+  bench_workloads();
+
+#ifdef ITER
+  bench_frozen_search();
+  bench_stack_shallow();
+  bench_stack_deep();
+  bench_traversal_chain();
+  bench_traversal_morris();
+  bench_dispose_flatten();
+#endif // ITER
+}
@@ -0,0 +1,77 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include <stdlib.h>
+#include <time.h>
+
+static uint64_t bench_state = 88172645463325252ull;
+
+double bench_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void bench_report(const char *label, long ops, double seconds) {
+  printf("  %-32s %12ld ops %10.3f ms %10.2f ns/op\n", label, ops,
+         seconds * 1e3, ops > 0 ? seconds * 1e9 / ops : 0.0);
+}
+
+void bench_seed(uint64_t seed) { bench_state = seed != 0 ? seed : 1; }
+
+/*
+ * xorshift64* — stejná posloupnost pro stejné semínko, aby byla měření
+ * mezi běhy a variantami porovnatelná.
+ */
+uint64_t bench_rand() {
+  bench_state ^= bench_state >> 12;
+  bench_state ^= bench_state << 25;
+  bench_state ^= bench_state >> 27;
+  return bench_state * 2685821657736338717ull;
+}
+
+bst_node_t *bench_new_node(int key) {
+  bst_node_t *node = malloc(sizeof(bst_node_t));
+  node->key = key;
+  node->content.type = INTEGER;
+  node->content.value = malloc(sizeof(int));
+  *(int *)node->content.value = key;
+  node->left = NULL;
+  node->right = NULL;
+  node->block = NULL;
+  bst_update_size(node);
+  return node;
+}
+
+/*
+ * Strom degenerovaný na lineární seznam doprava (klíče 0..count-1), tedy
+ * nejhorší případ pro hloubku zásobníku i rekurze.
+ */
+bst_node_t *bench_build_chain(int count) {
+  bst_node_t *root = NULL;
+  for (int i = count - 1; i >= 0; i--) {
+    bst_node_t *node = bench_new_node(i);
+    node->right = root;
+    bst_update_size(node);
+    root = node;
+  }
+  return root;
+}
+
+static bst_node_t *bench_build_range(int lo, int hi) {
+  if (lo > hi)
+    return NULL;
+  int mid = lo + (hi - lo) / 2;
+  bst_node_t *node = bench_new_node(mid);
+  node->left = bench_build_range(lo, mid - 1);
+  node->right = bench_build_range(mid + 1, hi);
+  bst_update_size(node);
+  return node;
+}
+
+/*
+ * Dokonale vyvážený strom s klíči 0..count-1.
+ */
+bst_node_t *bench_build_balanced(int count) {
+  return bench_build_range(0, count - 1);
+}
@@ -0,0 +1,25 @@
+#ifndef IAL_BTREE_BENCH_UTIL_H
+#define IAL_BTREE_BENCH_UTIL_H
+
+#include "btree.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCH(NAME, DESCRIPTION)                                               \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);
+
+#define ENDBENCH                                                               \
+  printf("\n");                                                                \
+  }
+
+double bench_now();
+void bench_report(const char *label, long ops, double seconds);
+
+void bench_seed(uint64_t seed);
+uint64_t bench_rand();
+
+bst_node_t *bench_new_node(int key);
+bst_node_t *bench_build_chain(int count);
+bst_node_t *bench_build_balanced(int count);
+#endif
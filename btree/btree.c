@@ -1,14 +1,18 @@
 #include "btree.h"
+#include "alloc.h"
 #include "character.h"
+#include <limits.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /*
  * Pomocná funkce pro výpis uzlu stromu.
  */
 void bst_print_node(bst_node_t *node)
 {
-  printf("[%c,", node->key);
+  printf("[%c,", (int)node->key);
   bst_print_node_content(&node->content);
   printf("]");
 }
@@ -31,6 +35,7 @@ void bst_print_node_content(bst_node_content_t *content)
 
   case CHARACTER_T:
     print_character((character_t*)content->value);
+    break;
 
   default:
     printf("Unknown");
@@ -46,9 +51,663 @@ void bst_add_node_to_items(bst_node_t *node, bst_items_t *items)
 {
   if (items->capacity < items->size + 1)
   {
-    items->capacity = items->capacity * 2 + 8;
-    items->nodes = realloc(items->nodes, items->capacity * (sizeof(bst_node_t *)));
+    int capacity = items->capacity * 2 + 8;
+    items->nodes = allocator_realloc(items->allocator, items->nodes,
+                                     items->capacity * sizeof(bst_node_t *),
+                                     capacity * sizeof(bst_node_t *));
+    items->capacity = capacity;
   }
   items->nodes[items->size] = node;
   items->size++;
-}
\ No newline at end of file
+}
+
+/*
+ * Uvolnění pole uzlů jeho alokátorem; pole zůstane prázdné.
+ */
+void bst_items_dispose(bst_items_t *items)
+{
+  allocator_free(items->allocator, items->nodes,
+                 items->capacity * sizeof(bst_node_t *));
+  items->nodes = NULL;
+  items->capacity = 0;
+  items->size = 0;
+}
+
+/*
+ * Souvislé bloky uzlů alokované naráz funkcí bst_alloc_nodes.
+ *
+ * Uzly bloku se uvolňují funkcí bst_free_node stejně jako samostatně
+ * alokované. Každý uzel bloku ukazuje polem block na hlavičku svého bloku,
+ * bst_free_node ho tak najde přímo z uzlu bez zámku a uzel od bloku
+ * odečte atomicky; blok se vrátí svému alokátoru s posledním živým uzlem.
+ */
+typedef struct bst_block {
+  size_t size;     // velikost bloku včetně této hlavičky
+  atomic_int live; // počet dosud neuvolněných uzlů
+  const allocator_t *allocator;
+  bst_node_t nodes[];
+} bst_block_t;
+
+/*
+ * Alokace jednoho bloku pro count uzlů.
+ *
+ * Vrací ukazatel na první uzel nebo NULL, pokud alokace selže.
+ */
+bst_node_t *bst_alloc_nodes(int count)
+{
+  return bst_alloc_nodes_with(NULL, count);
+}
+
+/*
+ * Totéž s daným alokátorem (NULL = výchozí).
+ */
+bst_node_t *bst_alloc_nodes_with(const allocator_t *allocator, int count)
+{
+  if (count <= 0)
+    return NULL;
+
+  size_t size = sizeof(bst_block_t) + (size_t)count * sizeof(bst_node_t);
+  bst_block_t *block = allocator_alloc(allocator, size);
+  if (block == NULL)
+    return NULL;
+  block->size = size;
+  atomic_init(&block->live, count);
+  block->allocator = allocator;
+  for (int i = 0; i < count; i++)
+    block->nodes[i].block = block;
+  return block->nodes;
+}
+
+/*
+ * Uvolnění hodnoty uzlu.
+ */
+void bst_free(void *ptr)
+{
+  free(ptr);
+}
+
+bst_node_t *bst_alloc_node(const allocator_t *allocator)
+{
+  bst_node_t *node = allocator_alloc(allocator, sizeof(bst_node_t));
+  if (node != NULL)
+    node->block = NULL;
+  return node;
+}
+
+/*
+ * Uvolnění uzlu alokátorem stromu. Uzel z bloku se jen odečte od počtu
+ * živých uzlů bloku a blok se uvolní spolu s posledním z nich.
+ */
+void bst_free_node(const allocator_t *allocator, bst_node_t *node)
+{
+  if (node == NULL)
+    return;
+  bst_block_t *block = node->block;
+  if (block == NULL)
+    allocator_free(allocator, node, sizeof(bst_node_t));
+  else if (atomic_fetch_sub(&block->live, 1) == 1)
+    allocator_free(block->allocator, block, block->size);
+}
+
+/*
+ * Propojení souvislého pole uzlů seřazených podle klíče do dokonale
+ * vyváženého stromu; kořenem úseku <lo, hi> je jeho prostřední uzel.
+ */
+static bst_node_t *bst_link_block(bst_node_t *nodes, int lo, int hi)
+{
+  if (lo > hi)
+    return NULL;
+  int mid = lo + (hi - lo) / 2;
+  nodes[mid].left = bst_link_block(nodes, lo, mid - 1);
+  nodes[mid].right = bst_link_block(nodes, mid + 1, hi);
+  bst_update_size(&nodes[mid]);
+  return &nodes[mid];
+}
+
+/*
+ * Totéž pro pole ukazatelů na již existující uzly.
+ */
+static bst_node_t *bst_link_nodes(bst_node_t **nodes, int lo, int hi)
+{
+  if (lo > hi)
+    return NULL;
+  int mid = lo + (hi - lo) / 2;
+  nodes[mid]->left = bst_link_nodes(nodes, lo, mid - 1);
+  nodes[mid]->right = bst_link_nodes(nodes, mid + 1, hi);
+  bst_update_size(nodes[mid]);
+  return nodes[mid];
+}
+
+/*
+ * Vytvoření dokonale vyváženého stromu ze seřazených dat.
+ *
+ * Klíče musí být ostře rostoucí. Všechny uzly se alokují jedním blokem a
+ * strom převezme vlastnictví hodnot; pokud se blok nepodaří alokovat,
+ * hodnoty se uvolní a strom zůstane prázdný. Složitost je lineární. Funkce
+ * strom nejdříve inicializuje, případný předchozí obsah je třeba zrušit
+ * předem.
+ */
+void bst_build_from_sorted(bst_node_t **tree, const char keys[],
+                           const bst_node_content_t values[], int count)
+{
+  bst_build_from_sorted_with(tree, keys, values, count, NULL);
+}
+
+void bst_build_from_sorted_with(bst_node_t **tree, const char keys[],
+                                const bst_node_content_t values[], int count,
+                                const allocator_t *allocator)
+{
+  bst_init(tree);
+  bst_node_t *nodes = bst_alloc_nodes_with(allocator, count);
+  if (nodes == NULL)
+  {
+    for (int i = 0; i < count; i++)
+      bst_free(values[i].value);
+    return;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    nodes[i].key = keys[i];
+    nodes[i].content = values[i];
+  }
+  *tree = bst_link_block(nodes, 0, count - 1);
+}
+
+/*
+ * Vyvážení stromu.
+ *
+ * Uzly se projdou v pořadí inorder a znovu propojí do dokonale vyváženého
+ * stromu; žádný uzel se nealokuje ani neuvolňuje. Složitost je lineární.
+ */
+void bst_balance(bst_node_t **tree)
+{
+  bst_items_t items = {NULL, 0, 0};
+  bst_inorder(*tree, &items);
+  *tree = bst_link_nodes(items.nodes, 0, items.size - 1);
+  free(items.nodes);
+}
+
+#ifdef BST_COUNTERS
+bst_counters_t bst_counters;
+#endif
+
+/*
+ * Statistika tvaru stromu.
+ *
+ * Prochází strom do šířky s pomocným polem, takže nepotřebuje rekurzi ani
+ * zásobník variant a funguje i pro degenerovaný strom.
+ */
+void bst_stats(bst_node_t *tree, bst_stats_t *stats)
+{
+  memset(stats, 0, sizeof(bst_stats_t));
+  stats->max_depth = -1;
+  if (tree == NULL)
+    return;
+
+  // Uzly jednej urovne za druhou; pole rastie podla potreby
+  int capacity = 64;
+  bst_node_t **level = malloc(capacity * sizeof(bst_node_t *));
+  if (level == NULL)
+    return;
+  int begin = 0;
+  int end = 1;
+  level[0] = tree;
+  long depth_total = 0;
+
+  for (int depth = 0; begin < end; depth++)
+  {
+    int bucket = depth < BST_STATS_DEPTHS ? depth : BST_STATS_DEPTHS - 1;
+    stats->histogram[bucket] += end - begin;
+    stats->count += end - begin;
+    depth_total += (long)depth * (end - begin);
+    stats->max_depth = depth;
+
+    int next = end;
+    for (int i = begin; i < end; i++)
+    {
+      if (next + 2 > capacity)
+      {
+        capacity *= 2;
+        bst_node_t **grown = realloc(level, capacity * sizeof(bst_node_t *));
+        if (grown == NULL)
+        {
+          free(level);
+          return;
+        }
+        level = grown;
+      }
+      if (level[i]->left != NULL)
+        level[next++] = level[i]->left;
+      if (level[i]->right != NULL)
+        level[next++] = level[i]->right;
+    }
+    begin = end;
+    end = next;
+  }
+
+  stats->height = stats->max_depth + 1;
+  stats->average_depth = (double)depth_total / stats->count;
+  free(level);
+}
+
+/*
+ * Nejmenší možná výška stromu s count uzly, tj. ceil(log2(count + 1)).
+ */
+static int bst_min_height(int count)
+{
+  int height = 0;
+  while (count > 0)
+  {
+    height++;
+    count >>= 1;
+  }
+  return height;
+}
+
+/*
+ * Počet uzlů podstromu. S pořadovými statistikami ho dává velikost uzlu,
+ * jinak průchod s pomocným polem; pokud se pole nepodaří alokovat, vrátí -1.
+ */
+static int bst_count_nodes(bst_node_t *tree)
+{
+#ifdef BST_ORDER_STATISTICS
+  return bst_size(tree);
+#else
+  if (tree == NULL)
+    return 0;
+  int capacity = 64;
+  bst_node_t **pending = malloc(capacity * sizeof(bst_node_t *));
+  if (pending == NULL)
+    return -1;
+  int size = 0;
+  pending[size++] = tree;
+  int count = 0;
+  while (size > 0)
+  {
+    bst_node_t *node = pending[--size];
+    count++;
+    if (size + 2 > capacity)
+    {
+      capacity *= 2;
+      bst_node_t **grown = realloc(pending, capacity * sizeof(bst_node_t *));
+      if (grown == NULL)
+      {
+        count = -1;
+        break;
+      }
+      pending = grown;
+    }
+    if (node->left != NULL)
+      pending[size++] = node->left;
+    if (node->right != NULL)
+      pending[size++] = node->right;
+  }
+  free(pending);
+  return count;
+#endif
+}
+
+/*
+ * Kontrola po vložení uzlu s klíčem key do hloubky depth (-1 = nový uzel
+ * nevznikl).
+ *
+ * Mez výšky je factor-násobek nejmenší možné výšky, ceil(log2(n + 1)).
+ * Přestaví se nejhlubší podstrom na cestě, po jehož vyvážení cesta mez
+ * splní — obvykle malý podstrom, celý strom jen v krajním případě.
+ * Velikosti podstromů na cestě se sčítají zdola, takže se spočítá jen
+ * přestavovaný podstrom. Velikosti předků se nemění, protože počet uzlů
+ * podstromu zůstává.
+ */
+void bst_rebalance_if_deep(bst_node_t **tree, bst_key_t key, int depth,
+                           bst_compare_t compare, bst_rebalance_t *policy)
+{
+  if (policy == NULL || depth < 0)
+    return;
+#ifdef BST_ORDER_STATISTICS
+  policy->count = bst_size(*tree);
+#else
+  policy->count++;
+#endif
+  double limit = policy->factor * bst_min_height(policy->count);
+  if (policy->factor <= 0 || depth + 1 <= limit)
+    return;
+
+  bst_node_t ***path = malloc((depth + 1) * sizeof(bst_node_t **));
+  if (path == NULL)
+    return;
+  bst_node_t **slot = tree;
+  for (int i = 0; i <= depth; i++)
+  {
+    path[i] = slot;
+    if (i < depth)
+      slot = bst_compare(compare, key, (*slot)->key) < 0 ? &(*slot)->left
+                                                          : &(*slot)->right;
+  }
+
+  // Novy uzol je list, kazdy predok prida seba a druheho potomka
+  int size = 1;
+  for (int i = depth; i >= 0; i--)
+  {
+    if (i < depth)
+    {
+      bst_node_t *node = *path[i];
+      int other = bst_count_nodes(path[i + 1] == &node->left ? node->right
+                                                             : node->left);
+      if (other < 0)
+        break;
+      size += 1 + other;
+    }
+    if (i == 0)
+      policy->count = size;
+    if (i + bst_min_height(size) <= limit)
+    {
+      bst_balance(path[i]);
+      break;
+    }
+  }
+  free(path);
+}
+
+/*
+ * Vložení dávky neseřazených položek do stromu.
+ *
+ * Dávka se seřadí stabilním počítacím tříděním podle klíče (pro stejný klíč
+ * platí poslední hodnota dávky), slije se s inorder posloupností stromu a
+ * výsledek se propojí do vyváženého stromu. Nové uzly se alokují jedním
+ * blokem, existujícím uzlům se jen nahradí hodnota. Složitost je
+ * O(n + m) místo m samostatných sestupů; strom je poté vyvážený.
+ *
+ * Dávka se slévá podle přirozeného uspořádání klíčů, funkce proto nepřijímá
+ * porovnávací funkci a strom vytvořený s jinou porovnávací funkcí než NULL
+ * se jí měnit nesmí. Strom převezme vlastnictví hodnot dávky; pokud se
+ * nepodaří alokovat paměť, hodnoty dávky se uvolní a strom zůstane beze
+ * změny.
+ */
+void bst_insert_batch(bst_node_t **tree, const char keys[],
+                      const bst_node_content_t values[], int count)
+{
+  bst_insert_batch_with(tree, keys, values, count, NULL);
+}
+
+void bst_insert_batch_with(bst_node_t **tree, const char keys[],
+                           const bst_node_content_t values[], int count,
+                           const allocator_t *allocator)
+{
+  if (count <= 0)
+    return;
+
+  // Pocitacie triedenie indexov podla kluca (stabilne)
+  int buckets[UCHAR_MAX + 2] = {0};
+  for (int i = 0; i < count; i++)
+    buckets[(unsigned char)(keys[i] - CHAR_MIN) + 1]++;
+  for (int b = 1; b <= UCHAR_MAX + 1; b++)
+    buckets[b] += buckets[b - 1];
+  int *order = malloc(count * sizeof(int));
+  if (order == NULL)
+  {
+    for (int i = 0; i < count; i++)
+      bst_free(values[i].value);
+    return;
+  }
+  for (int i = 0; i < count; i++)
+    order[buckets[(unsigned char)(keys[i] - CHAR_MIN)]++] = i;
+
+  // Z rovnakych klucov v davke plati posledny, ostatne hodnoty sa uvolnia
+  int unique = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (i + 1 < count && keys[order[i]] == keys[order[i + 1]])
+      bst_free(values[order[i]].value);
+    else
+      order[unique++] = order[i];
+  }
+
+  bst_items_t items = {NULL, 0, 0};
+  bst_inorder(*tree, &items);
+  bst_node_t **merged = malloc((items.size + unique) * sizeof(bst_node_t *));
+  bst_node_t *fresh = bst_alloc_nodes_with(allocator, unique);
+  if (merged == NULL || fresh == NULL)
+  {
+    // Hodnoty, ktore sa nevlozia, aj uzly bloku sa uvolnia po jednom
+    for (int u = 0; u < unique; u++)
+    {
+      bst_free(values[order[u]].value);
+      if (fresh != NULL)
+        bst_free_node(allocator, &fresh[u]);
+    }
+    free(merged);
+    free(items.nodes);
+    free(order);
+    return;
+  }
+
+  int size = 0;
+  int used = 0;
+  int t = 0;
+  for (int u = 0; u < unique; u++)
+  {
+    int key = keys[order[u]];
+    while (t < items.size && items.nodes[t]->key < key)
+      merged[size++] = items.nodes[t++];
+    if (t < items.size && items.nodes[t]->key == key)
+    {
+      // Kluc uz vo strome je, nahradi sa len hodnota
+      bst_free(items.nodes[t]->content.value);
+      items.nodes[t]->content = values[order[u]];
+      merged[size++] = items.nodes[t++];
+    }
+    else
+    {
+      fresh[used].key = key;
+      fresh[used].content = values[order[u]];
+      merged[size++] = &fresh[used++];
+    }
+  }
+  while (t < items.size)
+    merged[size++] = items.nodes[t++];
+
+  // Nevyuzite uzly bloku sa uvolnia, aby blok mohol zaniknut
+  for (int i = used; i < unique; i++)
+    bst_free_node(allocator, &fresh[i]);
+
+  *tree = bst_link_nodes(merged, 0, size - 1);
+  free(merged);
+  free(items.nodes);
+  free(order);
+}
+
+/*
+ * Sjednocení stromů.
+ *
+ * Uzly obou stromů se slijí podle inorder posloupností a propojí do
+ * vyváženého stromu v tree, strom other zůstane prázdný. Pro klíč, který je
+ * v obou stromech, platí hodnota z other a uzel z other se uvolní. Žádný uzel
+ * se nealokuje, složitost je O(m + n).
+ */
+void bst_union(bst_node_t **tree, bst_node_t **other)
+{
+  bst_union_with(tree, other, NULL);
+}
+
+void bst_union_with(bst_node_t **tree, bst_node_t **other,
+                    const allocator_t *allocator)
+{
+  bst_items_t items = {NULL, 0, 0};
+  bst_items_t others = {NULL, 0, 0};
+  bst_inorder(*tree, &items);
+  bst_inorder(*other, &others);
+  bst_node_t **merged =
+      malloc((items.size + others.size + 1) * sizeof(bst_node_t *));
+  if (merged == NULL)
+  {
+    free(items.nodes);
+    free(others.nodes);
+    return;
+  }
+
+  int size = 0;
+  int t = 0;
+  int o = 0;
+  while (t < items.size || o < others.size)
+  {
+    if (o == others.size ||
+        (t < items.size && items.nodes[t]->key < others.nodes[o]->key))
+      merged[size++] = items.nodes[t++];
+    else if (t == items.size || others.nodes[o]->key < items.nodes[t]->key)
+      merged[size++] = others.nodes[o++];
+    else
+    {
+      // Kluc je v oboch stromoch, uzol z other odovzda hodnotu a zanikne
+      bst_free(items.nodes[t]->content.value);
+      items.nodes[t]->content = others.nodes[o]->content;
+      bst_free_node(allocator, others.nodes[o++]);
+      merged[size++] = items.nodes[t++];
+    }
+  }
+
+  *other = NULL;
+  *tree = bst_link_nodes(merged, 0, size - 1);
+  free(merged);
+  free(items.nodes);
+  free(others.nodes);
+}
+
+/*
+ * Rozdělení stromu podle klíče.
+ *
+ * Uzly s klíčem menším než key přejdou do stromu lo, ostatní do hi; strom
+ * tree zůstane prázdný. Prochází se jen cesta hledání klíče key: uzly na ní
+ * se střídavě připojují na pravou páteř lo a levou páteř hi, jejich
+ * podstromy z druhé strany zůstávají beze změny. Složitost je O(výška).
+ */
+void bst_split(bst_node_t **tree, bst_key_t key, bst_node_t **lo,
+               bst_node_t **hi)
+{
+  bst_node_t *node = *tree;
+  bst_node_t *lo_root = NULL;
+  bst_node_t *hi_root = NULL;
+  bst_node_t **lo_slot = &lo_root;
+  bst_node_t **hi_slot = &hi_root;
+#ifdef BST_ORDER_STATISTICS
+  int lo_size = 0;
+  int hi_size = 0;
+#endif
+
+  while (node != NULL)
+  {
+    if (node->key < key)
+    {
+      // Uzol s lavym podstromom patri do lo, pokracuje sa doprava
+      *lo_slot = node;
+      lo_slot = &node->right;
+#ifdef BST_ORDER_STATISTICS
+      lo_size += 1 + bst_size(node->left);
+#endif
+      node = node->right;
+    }
+    else
+    {
+      // Uzol s pravym podstromom patri do hi, pokracuje sa dolava
+      *hi_slot = node;
+      hi_slot = &node->left;
+#ifdef BST_ORDER_STATISTICS
+      hi_size += 1 + bst_size(node->right);
+#endif
+      node = node->left;
+    }
+  }
+  *lo_slot = NULL;
+  *hi_slot = NULL;
+
+#ifdef BST_ORDER_STATISTICS
+  // Uzol patere obsahuje nizsie uzly patere a ich bocne podstromy
+  for (node = lo_root; node != NULL; node = node->right)
+  {
+    node->size = lo_size;
+    lo_size -= 1 + bst_size(node->left);
+  }
+  for (node = hi_root; node != NULL; node = node->left)
+  {
+    node->size = hi_size;
+    hi_size -= 1 + bst_size(node->right);
+  }
+#endif
+
+  *tree = NULL;
+  *lo = lo_root;
+  *hi = hi_root;
+}
+
+/*
+ * Spojení stromů.
+ *
+ * Všechny klíče stromu lo musí být menší než klíče stromu hi. Největší uzel
+ * lo se vyjme a stane se spojovacím uzlem s lo vlevo a hi vpravo; výsledek
+ * je v tree, lo a hi zůstanou prázdné. S pořadovými statistikami se
+ * spojovací uzel nevkládá do kořene, ale sestupuje po páteři většího stromu
+ * k podstromu velikostí srovnatelnému s menším stromem, takže opakované
+ * spojování výšku nezvyšuje. Složitost je O(výška).
+ */
+void bst_join(bst_node_t **tree, bst_node_t **lo, bst_node_t **hi)
+{
+  bst_node_t *left = *lo;
+  bst_node_t *right = *hi;
+  *lo = NULL;
+  *hi = NULL;
+  if (left == NULL || right == NULL)
+  {
+    *tree = left != NULL ? left : right;
+    return;
+  }
+
+  // Vyjatie najvacsieho uzla lo
+  bst_node_t **rightmost = &left;
+  while ((*rightmost)->right != NULL)
+  {
+#ifdef BST_ORDER_STATISTICS
+    (*rightmost)->size--;
+#endif
+    rightmost = &(*rightmost)->right;
+  }
+  bst_node_t *pivot = *rightmost;
+  *rightmost = pivot->left;
+
+  bst_node_t *root = NULL;
+  bst_node_t **top = &root;
+  bst_node_t **slot = &root;
+#ifdef BST_ORDER_STATISTICS
+  // Zostup po pravej patere lo alebo lavej patere hi, kym podstrom nie je
+  // najviac taky velky ako druhy strom; uzly cestou narastu o pripojene uzly
+  if (bst_size(left) >= bst_size(right))
+  {
+    slot = &left;
+    while (bst_size(*slot) > bst_size(right))
+    {
+      (*slot)->size += 1 + bst_size(right);
+      slot = &(*slot)->right;
+    }
+    top = &left;
+    pivot->left = *slot;
+    pivot->right = right;
+  }
+  else
+  {
+    slot = &right;
+    while (bst_size(*slot) > bst_size(left))
+    {
+      (*slot)->size += 1 + bst_size(left);
+      slot = &(*slot)->left;
+    }
+    top = &right;
+    pivot->left = left;
+    pivot->right = *slot;
+  }
+#else
+  pivot->left = left;
+  pivot->right = right;
+#endif
+  bst_update_size(pivot);
+  *slot = pivot;
+  *tree = *top;
+}
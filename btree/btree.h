@@ -7,6 +7,8 @@
 #define IAL_BTREE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // výčet datových typů hodnoty
 typedef enum {
@@ -20,12 +22,23 @@ typedef struct bst_node_content {
     bst_node_content_type_t type;   // datový typ hodnoty
 } bst_node_content_t;
 
+// Klíč uzlu: 32bitové celé číslo, při překladu s -DBST_KEY64 64bitové
+#ifdef BST_KEY64
+typedef int64_t bst_key_t;
+#else
+typedef int32_t bst_key_t;
+#endif
+
 // Uzel stromu
 typedef struct bst_node {
-  int key;                     // klíč
+  bst_key_t key;               // klíč
+#ifdef BST_ORDER_STATISTICS
+  int size;                    // počet uzlů podstromu včetně tohoto uzlu
+#endif
   bst_node_content_t content;  // hodnota
   struct bst_node *left;       // levý potomek
   struct bst_node *right;      // pravý potomek
+  struct bst_block *block;     // blok uzlu (bst_alloc_nodes), jinak NULL
 } bst_node_t;
 
 void bst_init(bst_node_t **tree);
@@ -34,14 +47,50 @@ bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value);
 void bst_delete(bst_node_t **tree, char key);
 void bst_dispose(bst_node_t **tree);
 
+/*
+ * Rozhraní s klíči plné šířky (bst_key_t). Funkce pro klíče typu char
+ * je volají s compare == NULL.
+ *
+ * Porovnávací funkce vrací záporné číslo, nulu nebo kladné číslo podle
+ * toho, zda je a menší, rovno nebo větší než b (jako strcmp), a umožňuje
+ * složené klíče zakódované do bst_key_t nebo jiné uspořádání. NULL znamená
+ * přirozené uspořádání celých čísel. Strom se smí měnit i prohledávat jen
+ * se stejnou porovnávací funkcí; ostatní funkce (intervaly, pořadové
+ * statistiky, dávkové operace) předpokládají přirozené uspořádání.
+ */
+typedef int (*bst_compare_t)(bst_key_t a, bst_key_t b);
+
+static inline int bst_compare(bst_compare_t compare, bst_key_t a, bst_key_t b)
+{
+  if (compare != NULL)
+    return compare(a, b);
+  return (a > b) - (a < b);
+}
+
+void bst_insert_key(bst_node_t **tree, bst_key_t key, bst_node_content_t value,
+                    bst_compare_t compare);
+bool bst_search_key(bst_node_t *tree, bst_key_t key,
+                    bst_node_content_t **value, bst_compare_t compare);
+void bst_delete_key(bst_node_t **tree, bst_key_t key, bst_compare_t compare);
+
+#ifdef SPLAY
+// Rozvíjený strom: hledání, které přesune nalezený uzel do kořene *tree
+bool bst_search_splay(bst_node_t **tree, bst_key_t key,
+                      bst_node_content_t **value, bst_compare_t compare);
+#endif // SPLAY
+
+struct allocator;
+
 // Pole uzlu
 typedef struct bst_items {
   bst_node_t **nodes;     // pole uzlu
   int capacity;           // kapacita alokované paměti v počtu položek
   int size;               // aktuální velikost pole v počtu položek
+  const struct allocator *allocator; // alokátor pole, NULL = výchozí
 } bst_items_t;
 
 void bst_add_node_to_items(bst_node_t* node, bst_items_t *items);
+void bst_items_dispose(bst_items_t *items);
 
 void bst_preorder(bst_node_t *tree, bst_items_t *items);
 void bst_inorder(bst_node_t *tree, bst_items_t *items);
@@ -49,10 +98,194 @@ void bst_postorder(bst_node_t *tree, bst_items_t *items);
 
 void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree);
 
+// Funkce volaná pro každý uzel navštívený při průchodu intervalem
+typedef void (*bst_visit_t)(bst_node_t *node, void *data);
+
+void bst_range(bst_node_t *tree, char lo, char hi, bst_visit_t visit,
+               void *data);
+bst_node_t *bst_floor(bst_node_t *tree, char key);
+bst_node_t *bst_ceil(bst_node_t *tree, char key);
+bst_node_t *bst_predecessor(bst_node_t *tree, char key);
+bst_node_t *bst_successor(bst_node_t *tree, char key);
+
+// Průchody a rušení bez pomocné paměti (pouze iterativní varianta)
+void bst_preorder_morris(bst_node_t *tree, bst_items_t *items);
+void bst_inorder_morris(bst_node_t *tree, bst_items_t *items);
+void bst_dispose_flatten(bst_node_t **tree);
+
+/*
+ * Pořadové statistiky (překlad s -DBST_ORDER_STATISTICS).
+ *
+ * Každý uzel si pamatuje velikost svého podstromu, kterou udržují
+ * bst_insert, bst_delete a bst_replace_by_rightmost. Funkce bst_update_size
+ * přepočítá velikost uzlu z jeho potomků; bez přepínače nedělá nic, takže ji
+ * kód měnící tvar stromu může volat bezpodmínečně.
+ */
+#ifdef BST_ORDER_STATISTICS
+static inline int bst_size(bst_node_t *tree)
+{
+  return tree != NULL ? tree->size : 0;
+}
+
+static inline void bst_update_size(bst_node_t *node)
+{
+  node->size = 1 + bst_size(node->left) + bst_size(node->right);
+}
+
+bst_node_t *bst_select(bst_node_t *tree, int k);
+int bst_rank(bst_node_t *tree, char key);
+int bst_count_range(bst_node_t *tree, char lo, char hi);
+#else
+static inline void bst_update_size(bst_node_t *node)
+{
+  (void)node;
+}
+#endif
+
+/*
+ * Automatické vyvažování: pokud nový uzel v hloubce depth (kořen má
+ * hloubku 0) prodlouží výšku stromu nad factor * log2(n), přestaví se
+ * nejmenší podstrom na cestě k uzlu, jehož vyvážení výšku vrátí pod mez.
+ *
+ * Pravidlo patří jednomu stromu a předává se každým vkládáním; ostatní
+ * funkce vkládají bez něj. Počet uzlů n dává s pořadovými statistikami
+ * velikost kořene, jinak počítadlo count, které vkládání s pravidlem
+ * zvyšuje. Mazání ho nesnižuje: vyšší n mez jen zvolní, a jakmile
+ * přestavba dojde ke kořeni, nastaví se count na skutečný počet (stejně
+ * se opraví i počáteční nula pro neprázdný strom). Rozvíjený strom (SPLAY)
+ * se vyvažuje sám a pravidlo nepoužívá.
+ */
+typedef struct bst_rebalance {
+  double factor;               // c; 0 vyvažování vypíná
+  int count;                   // počet uzlů stromu (bez pořadových statistik)
+} bst_rebalance_t;
+
+void bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                              bst_node_content_t value, bst_compare_t compare,
+                              const struct allocator *allocator,
+                              bst_rebalance_t *policy);
+void bst_rebalance_if_deep(bst_node_t **tree, bst_key_t key, int depth,
+                           bst_compare_t compare, bst_rebalance_t *policy);
+
+/*
+ * Čítače porovnání klíčů a navštívených uzlů v bst_search a bst_insert
+ * (překlad s -DBST_COUNTERS). Slouží k měření, nejsou vláknově bezpečné.
+ */
+#ifdef BST_COUNTERS
+typedef struct bst_counters {
+  long comparisons;            // porovnání klíčů
+  long visits;                 // navštívené uzly
+} bst_counters_t;
+
+extern bst_counters_t bst_counters;
+
+#define BST_COUNT_VISIT() (bst_counters.visits++)
+#define BST_COUNT_COMPARISONS(count) (bst_counters.comparisons += (count))
+#else
+#define BST_COUNT_VISIT() ((void)0)
+#define BST_COUNT_COMPARISONS(count) ((void)0)
+#endif
+
+// Tvar stromu; hloubka kořene je 0, vyhledání uzlu v hloubce d navštíví
+// d + 1 uzlů
+#define BST_STATS_DEPTHS 64
+
+typedef struct bst_stats {
+  int count;                   // počet uzlů
+  int height;                  // počet úrovní (0 pro prázdný strom)
+  int max_depth;               // hloubka nejhlubšího uzlu (-1 pro prázdný)
+  double average_depth;        // průměrná hloubka uzlu
+  int histogram[BST_STATS_DEPTHS]; // uzly podle hloubky, poslední prvek
+                                   // zahrnuje i všechny hlubší
+} bst_stats_t;
+
+void bst_stats(bst_node_t *tree, bst_stats_t *stats);
+
 void bst_print_node_content(bst_node_content_t *content);
 void bst_print_node(bst_node_t *node);
 
+bst_node_t *bst_alloc_nodes(int count);
+void bst_free(void *ptr);
+
+/*
+ * Alokátor uzlů stromu (viz alloc.h). Strom si alokátor nepamatuje: funkce
+ * s příponou _with ho dostávají parametrem (NULL = malloc a free), funkce
+ * bez přípony používají výchozí alokátor. Strom se proto mění i ruší
+ * stejným alokátorem, jakým vznikl, a stromy, mezi kterými přecházejí uzly
+ * (bst_union, bst_split, bst_join), musí mít stejný alokátor. Hodnoty uzlů
+ * alokuje volající a uvolňují se funkcí bst_free jako dosud.
+ */
+bst_node_t *bst_alloc_node(const struct allocator *allocator);
+void bst_free_node(const struct allocator *allocator, bst_node_t *node);
+bst_node_t *bst_alloc_nodes_with(const struct allocator *allocator,
+                                 int count);
+void bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_node_content_t value, bst_compare_t compare,
+                         const struct allocator *allocator);
+void bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_compare_t compare,
+                         const struct allocator *allocator);
+void bst_replace_by_rightmost_with(bst_node_t *target, bst_node_t **tree,
+                                   const struct allocator *allocator);
+void bst_dispose_with(bst_node_t **tree, const struct allocator *allocator);
+void bst_dispose_flatten_with(bst_node_t **tree,
+                              const struct allocator *allocator);
+void bst_build_from_sorted_with(bst_node_t **tree, const char keys[],
+                                const bst_node_content_t values[], int count,
+                                const struct allocator *allocator);
+void bst_insert_batch_with(bst_node_t **tree, const char keys[],
+                           const bst_node_content_t values[], int count,
+                           const struct allocator *allocator);
+void bst_union_with(bst_node_t **tree, bst_node_t **other,
+                    const struct allocator *allocator);
+
+void bst_build_from_sorted(bst_node_t **tree, const char keys[],
+                           const bst_node_content_t values[], int count);
+void bst_insert_batch(bst_node_t **tree, const char keys[],
+                      const bst_node_content_t values[], int count);
 void bst_balance(bst_node_t **tree);
+void bst_union(bst_node_t **tree, bst_node_t **other);
+void bst_split(bst_node_t **tree, bst_key_t key, bst_node_t **lo,
+               bst_node_t **hi);
+void bst_join(bst_node_t **tree, bst_node_t **lo, bst_node_t **hi);
 void letter_count(bst_node_t **letter_frequency_tree, char *input);
+void letter_count_with(bst_node_t **letter_frequency_tree, char *input,
+                       const struct allocator *allocator);
+
+/*
+ * Histogram pro letter_count: přičte do histogram[c] počty normalizovaných
+ * znaků (a-z, ' ', '_') prvních length bajtů vstupu. Jádro se vybírá za běhu
+ * podle procesoru; letter_count_set_kernel vynutí konkrétní jádro (např. pro
+ * měření) a vrací false, pokud ho procesor nepodporuje.
+ */
+typedef enum {
+  LETTER_KERNEL_AUTO = 0,      // nejlepší podporované
+  LETTER_KERNEL_SCALAR,        // po jednom bajtu
+  LETTER_KERNEL_SSE2,          // 16 bajtů na krok
+  LETTER_KERNEL_AVX2           // 32 bajtů na krok
+} letter_kernel_t;
+
+bool letter_count_set_kernel(letter_kernel_t kernel);
+void letter_histogram(const char *input, size_t length, int histogram[256]);
+
+/*
+ * Proudové varianty letter_count pro vstup, který se nevejde do paměti jako
+ * jeden řetězec (soubor, roura, standardní vstup). Části vstupu počítají
+ * vlákna fondu (viz pool.h) do vlastních histogramů, které se na konci
+ * sečtou. Bajt 0 se počítá jako ostatní znak. Vrací false při chybě čtení;
+ * strom pak zůstane prázdný.
+ */
+struct bst_pool;
+
+bool letter_count_fd(bst_node_t **letter_frequency_tree, int fd,
+                     struct bst_pool *pool);
+bool letter_count_file(bst_node_t **letter_frequency_tree, const char *path,
+                       struct bst_pool *pool);
+bool letter_count_fd_with(bst_node_t **letter_frequency_tree, int fd,
+                          struct bst_pool *pool,
+                          const struct allocator *allocator);
+bool letter_count_file_with(bst_node_t **letter_frequency_tree,
+                            const char *path, struct bst_pool *pool,
+                            const struct allocator *allocator);
 
 #endif
@@ -0,0 +1,93 @@
+#define _GNU_SOURCE
+
+#include "ibst.h"
+#include "../bench_util.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void init_bench() {
+  printf("Compact Binary Search Tree - benchmark\n");
+  printf("--------------------------------------\n");
+  printf("\n");
+}
+
+// Bajty haldy aktualne pridelene programu (vratane mmap blokov)
+static size_t bench_heap() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+BENCH(bench_compact_against_rec, "Index-linked array nodes against btree/rec")
+const int sizes[] = {100000, 1000000, 4000000};
+const int lookups = 4000000;
+bst_key_t *lookup_keys = malloc(lookups * sizeof(bst_key_t));
+for (int s = 0; s < 3; s++) {
+  int n = sizes[s];
+  char label[48];
+  bst_key_t *keys = malloc(n * sizeof(bst_key_t));
+  bench_seed(21);
+  for (int i = 0; i < n; i++)
+    keys[i] = (bst_key_t)(bench_rand() % (2 * (uint64_t)n));
+  for (int i = 0; i < lookups; i++)
+    lookup_keys[i] = (bst_key_t)(bench_rand() % (2 * (uint64_t)n));
+  // Hodnoty su NULL, meria sa len struktura stromu
+  bst_node_content_t empty = {NULL, INTEGER};
+  bst_node_content_t *value;
+
+  size_t heap = bench_heap();
+  bst_node_t *tree;
+  bst_init(&tree);
+  double start = bench_now();
+  for (int i = 0; i < n; i++)
+    bst_insert_key(&tree, keys[i], empty, NULL);
+  snprintf(label, sizeof(label), "rec insert n=%d", n);
+  bench_report(label, n, bench_now() - start);
+  size_t rec_bytes = bench_heap() - heap;
+  long found = 0;
+  start = bench_now();
+  for (int i = 0; i < lookups; i++)
+    found += bst_search_key(tree, lookup_keys[i], &value, NULL);
+  double rec_search = bench_now() - start;
+  snprintf(label, sizeof(label), "rec search n=%d", n);
+  bench_report(label, lookups, rec_search);
+
+  heap = bench_heap();
+  ibst_t compact;
+  ibst_init(&compact);
+  start = bench_now();
+  for (int i = 0; i < n; i++)
+    ibst_insert(&compact, keys[i], empty);
+  snprintf(label, sizeof(label), "compact insert n=%d", n);
+  bench_report(label, n, bench_now() - start);
+  size_t compact_bytes = bench_heap() - heap;
+  start = bench_now();
+  for (int i = 0; i < lookups; i++)
+    found -= ibst_search(&compact, lookup_keys[i], &value);
+  double compact_search = bench_now() - start;
+  snprintf(label, sizeof(label), "compact search n=%d", n);
+  bench_report(label, lookups, compact_search);
+
+  printf("  %-32s %10.1f B\n", "rec bytes/node",
+         (double)rec_bytes / compact.count);
+  printf("  %-32s %10.1f B\n", "compact bytes/node",
+         (double)compact_bytes / compact.count);
+  printf("  %-32s %10.1f B\n", "compact bytes/node (no slack)",
+         (double)(sizeof(ibst_node_t) + sizeof(bst_node_content_t)));
+  printf("  %-32s %10.2fx\n", "search speedup",
+         rec_search / compact_search);
+  if (found != 0)
+    printf("  results differ\n");
+
+  ibst_dispose(&compact);
+  bst_dispose(&tree);
+  free(keys);
+}
+free(lookup_keys);
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_compact_against_rec();
+}
@@ -0,0 +1,272 @@
+/*
+ * Binární vyhledávací strom s uzly v poli
+ *
+ * Uzly leží v jednom rostoucím poli a odkazují na potomky 32bitovými
+ * indexy místo ukazatelů. Hodnoty uzlů jsou v souběžném poli na stejných
+ * indexech, takže hledání čte jen klíč a dva indexy (12 B místo 40 B
+ * uzlu bst_node_t s vlastní alokací) a do řádku cache se vejde víc uzlů.
+ * Uvolněné indexy se řetězí do seznamu a znovu použijí.
+ *
+ * Pole se při růstu realokují, ukazatele na obsah vrácené ibst_search proto
+ * platí jen do dalšího vložení.
+ */
+
+#include "ibst.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define IBST_INITIAL_CAPACITY 16
+
+/*
+ * Inicializace prázdného stromu.
+ */
+void ibst_init(ibst_t *tree)
+{
+  tree->nodes = NULL;
+  tree->contents = NULL;
+  tree->root = IBST_NIL;
+  tree->count = 0;
+  tree->used = 1;
+  tree->capacity = 0;
+  tree->free_list = IBST_NIL;
+}
+
+/*
+ * Zvětšení obou polí alespoň na capacity položek (včetně nepoužitého
+ * indexu 0). Vrací false při nedostatku paměti; strom zůstane beze změny.
+ */
+bool ibst_reserve(ibst_t *tree, ibst_index_t capacity)
+{
+  if (capacity <= tree->capacity)
+    return true;
+
+  ibst_node_t *nodes = realloc(tree->nodes, capacity * sizeof(ibst_node_t));
+  if (nodes == NULL)
+    return false;
+  tree->nodes = nodes;
+  bst_node_content_t *contents =
+      realloc(tree->contents, capacity * sizeof(bst_node_content_t));
+  if (contents == NULL)
+    return false;
+  tree->contents = contents;
+  tree->capacity = capacity;
+  return true;
+}
+
+/*
+ * Přidělení indexu pro nový uzel; přednostně z uvolněných. Vrací IBST_NIL
+ * při nedostatku paměti.
+ */
+static ibst_index_t ibst_alloc(ibst_t *tree)
+{
+  if (tree->free_list != IBST_NIL)
+  {
+    ibst_index_t index = tree->free_list;
+    tree->free_list = tree->nodes[index].left;
+    return index;
+  }
+  if (tree->used >= tree->capacity)
+  {
+    ibst_index_t capacity = tree->capacity < IBST_INITIAL_CAPACITY
+                                ? IBST_INITIAL_CAPACITY
+                                : tree->capacity;
+    // Zdvojnasobenie, pri preteceni 32-bitoveho indexu aspon o jeden
+    capacity = capacity * 2 > capacity ? capacity * 2 : capacity + 1;
+    if (capacity <= tree->capacity || !ibst_reserve(tree, capacity))
+      return IBST_NIL;
+  }
+  return tree->used++;
+}
+
+/*
+ * Vrácení indexu do seznamu uvolněných.
+ */
+static void ibst_release(ibst_t *tree, ibst_index_t index)
+{
+  tree->contents[index].value = NULL;
+  tree->nodes[index].left = tree->free_list;
+  tree->free_list = index;
+}
+
+/*
+ * Odkaz na uzel: kořen stromu, nebo levý či pravý odkaz rodiče.
+ */
+static ibst_index_t *ibst_link(ibst_t *tree, ibst_index_t parent, bool left)
+{
+  if (parent == IBST_NIL)
+    return &tree->root;
+  return left ? &tree->nodes[parent].left : &tree->nodes[parent].right;
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíčem už ve stromu existuje, nahradí se jeho
+ * hodnota. Jinak se vloží nový listový uzel.
+ */
+void ibst_insert(ibst_t *tree, bst_key_t key, bst_node_content_t value)
+{
+  ibst_index_t parent = IBST_NIL;
+  ibst_index_t current = tree->root;
+  bool left = false;
+
+  while (current != IBST_NIL)
+  {
+    ibst_node_t *node = &tree->nodes[current];
+    if (key == node->key)
+    {
+      free(tree->contents[current].value);
+      tree->contents[current] = value;
+      return;
+    }
+    parent = current;
+    left = key < node->key;
+    current = left ? node->left : node->right;
+  }
+
+  // Pridelenie moze presunut polia, odkaz rodica sa ziska az potom
+  ibst_index_t index = ibst_alloc(tree);
+  if (index == IBST_NIL)
+  {
+    free(value.value);
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+    return;
+  }
+  tree->nodes[index] = (ibst_node_t){key, IBST_NIL, IBST_NIL};
+  tree->contents[index] = value;
+  *ibst_link(tree, parent, left) = index;
+  tree->count++;
+}
+
+/*
+ * Vyhledání uzlu ve stromu.
+ *
+ * V případě úspěchu vrátí true a do value zapíše ukazatel na obsah uzlu,
+ * jinak vrátí false a value nemění.
+ */
+bool ibst_search(ibst_t *tree, bst_key_t key, bst_node_content_t **value)
+{
+  const ibst_node_t *nodes = tree->nodes;
+  ibst_index_t current = tree->root;
+
+  while (current != IBST_NIL)
+  {
+    if (key < nodes[current].key)
+      current = nodes[current].left;
+    else if (key > nodes[current].key)
+      current = nodes[current].right;
+    else
+    {
+      *value = &tree->contents[current];
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá. Uzel se dvěma
+ * podstromy se nahradí nejpravějším uzlem levého podstromu, jako v
+ * bst_delete.
+ */
+void ibst_delete(ibst_t *tree, bst_key_t key)
+{
+  ibst_index_t parent = IBST_NIL;
+  ibst_index_t current = tree->root;
+  bool left = false;
+
+  while (current != IBST_NIL && tree->nodes[current].key != key)
+  {
+    parent = current;
+    left = key < tree->nodes[current].key;
+    current = left ? tree->nodes[current].left : tree->nodes[current].right;
+  }
+  if (current == IBST_NIL)
+    return;
+
+  ibst_node_t *target = &tree->nodes[current];
+  free(tree->contents[current].value);
+
+  if (target->left != IBST_NIL && target->right != IBST_NIL)
+  {
+    // Najpravejsi uzol laveho podstromu prevezme miesto ruseneho
+    ibst_index_t *link = &target->left;
+    while (tree->nodes[*link].right != IBST_NIL)
+      link = &tree->nodes[*link].right;
+    ibst_index_t rightmost = *link;
+    target->key = tree->nodes[rightmost].key;
+    tree->contents[current] = tree->contents[rightmost];
+    *link = tree->nodes[rightmost].left;
+    current = rightmost;
+  }
+  else
+  {
+    *ibst_link(tree, parent, left) =
+        target->left != IBST_NIL ? target->left : target->right;
+  }
+
+  ibst_release(tree, current);
+  tree->count--;
+}
+
+/*
+ * Zrušení celého stromu včetně hodnot. Strom zůstane ve stavu po
+ * inicializaci.
+ */
+void ibst_dispose(ibst_t *tree)
+{
+  // Uvolnene indexy maju hodnotu NULL, staci prejst cele pole
+  for (ibst_index_t i = 1; i < tree->used; i++)
+    free(tree->contents[i].value);
+  free(tree->nodes);
+  free(tree->contents);
+  ibst_init(tree);
+}
+
+/*
+ * Inorder průchod stromem; pro každý uzel zavolá funkci visit. Zásobník
+ * indexů roste podle výšky stromu.
+ */
+void ibst_inorder(ibst_t *tree, ibst_visit_t visit, void *data)
+{
+  ibst_index_t *stack = NULL;
+  int size = 0;
+  int capacity = 0;
+  ibst_index_t current = tree->root;
+
+  while (current != IBST_NIL || size > 0)
+  {
+    while (current != IBST_NIL)
+    {
+      if (size == capacity)
+      {
+        capacity = capacity > 0 ? 2 * capacity : 32;
+        ibst_index_t *grown = realloc(stack, capacity * sizeof(ibst_index_t));
+        if (grown == NULL)
+        {
+          free(stack);
+          return;
+        }
+        stack = grown;
+      }
+      stack[size++] = current;
+      current = tree->nodes[current].left;
+    }
+    current = stack[--size];
+    visit(tree->nodes[current].key, &tree->contents[current], data);
+    current = tree->nodes[current].right;
+  }
+  free(stack);
+}
+
+/*
+ * Paměť obsazená strukturou stromu v bajtech (bez hodnot uzlů).
+ */
+size_t ibst_memory(ibst_t *tree)
+{
+  return sizeof(ibst_t) + (size_t)tree->capacity *
+                              (sizeof(ibst_node_t) + sizeof(bst_node_content_t));
+}
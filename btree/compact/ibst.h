@@ -0,0 +1,47 @@
+/*
+ * Hlavičkový soubor pro binární vyhledávací strom s uzly v poli.
+ */
+
+#ifndef IAL_BTREE_IBST_H
+#define IAL_BTREE_IBST_H
+
+#include "../btree.h"
+#include <stdint.h>
+
+// Index uzlu; index 0 se nepoužívá a znamená chybějícího potomka
+typedef uint32_t ibst_index_t;
+
+#define IBST_NIL 0
+
+// Uzel stromu — jen data potřebná pro hledání
+typedef struct ibst_node {
+  bst_key_t key;               // klíč
+  ibst_index_t left;           // index levého potomka
+  ibst_index_t right;          // index pravého potomka
+} ibst_node_t;
+
+// Strom — uzly a jejich hodnoty ve dvou souběžných polích
+typedef struct ibst {
+  ibst_node_t *nodes;           // uzly na indexech 1..used-1
+  bst_node_content_t *contents; // hodnota uzlu na stejném indexu
+  ibst_index_t root;            // index kořene
+  ibst_index_t count;           // počet uzlů ve stromu
+  ibst_index_t used;            // první dosud nepoužitý index
+  ibst_index_t capacity;        // délka obou polí
+  ibst_index_t free_list;       // uvolněné indexy zřetězené přes left
+} ibst_t;
+
+// Funkce volaná pro každý uzel při průchodu
+typedef void (*ibst_visit_t)(bst_key_t key, bst_node_content_t *content,
+                             void *data);
+
+void ibst_init(ibst_t *tree);
+bool ibst_reserve(ibst_t *tree, ibst_index_t capacity);
+void ibst_insert(ibst_t *tree, bst_key_t key, bst_node_content_t value);
+bool ibst_search(ibst_t *tree, bst_key_t key, bst_node_content_t **value);
+void ibst_delete(ibst_t *tree, bst_key_t key);
+void ibst_dispose(ibst_t *tree);
+void ibst_inorder(ibst_t *tree, ibst_visit_t visit, void *data);
+size_t ibst_memory(ibst_t *tree);
+
+#endif
@@ -0,0 +1,135 @@
+#include "ibst.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+const int base_data_count = 15;
+const char base_keys[] = {'H', 'D', 'L', 'B', 'F', 'J', 'N', 'A',
+                          'C', 'E', 'G', 'I', 'K', 'M', 'O'};
+const int base_values[] = {8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7, 9, 11, 13, 16};
+
+void init_test() {
+  printf("Compact Binary Search Tree - testing script\n");
+  printf("-------------------------------------------\n");
+  printf("\n");
+}
+
+TEST(test_tree_init, "Initialize the tree")
+ibst_print_tree(&test_tree);
+ENDTEST
+
+TEST(test_tree_insert_many, "Insert many values")
+ibst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+ibst_print_tree(&test_tree);
+printf("Count: %u, used indexes: %u\n", test_tree.count, test_tree.used - 1);
+ENDTEST
+
+TEST(test_tree_update, "Replace the value of an existing key (F)")
+ibst_insert_many(&test_tree, base_keys, base_values, 7);
+ibst_insert(&test_tree, 'F', create_integer_content(60));
+ibst_print_items(&test_tree);
+printf("Count: %u\n", test_tree.count);
+ENDTEST
+
+TEST(test_tree_search, "Search for items (A, O, X)")
+ibst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_node_content_t *result = NULL;
+const char keys[] = {'A', 'O', 'X'};
+for (int i = 0; i < 3; i++) {
+  result = NULL;
+  ibst_search(&test_tree, keys[i], &result);
+  ibst_print_search_result(result);
+}
+ENDTEST
+
+TEST(test_tree_delete, "Delete a leaf, a one-child node and a two-child node (A, B, L)")
+ibst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+ibst_delete(&test_tree, 'A');
+ibst_delete(&test_tree, 'B');
+ibst_delete(&test_tree, 'L');
+ibst_delete(&test_tree, 'X');
+ibst_print_tree(&test_tree);
+printf("Count: %u\n", test_tree.count);
+ENDTEST
+
+TEST(test_tree_delete_root, "Delete the root until the tree is empty")
+ibst_insert_many(&test_tree, base_keys, base_values, 3);
+ibst_delete(&test_tree, 'H');
+ibst_print_tree(&test_tree);
+ibst_delete(&test_tree, 'D');
+ibst_delete(&test_tree, 'L');
+ibst_print_tree(&test_tree);
+ENDTEST
+
+TEST(test_tree_reuse_indexes, "Reuse freed indexes without growing the arrays")
+ibst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+ibst_index_t capacity = test_tree.capacity;
+for (int i = 0; i < base_data_count; i += 2) {
+  ibst_delete(&test_tree, base_keys[i]);
+}
+for (int i = 0; i < base_data_count; i += 2) {
+  ibst_insert(&test_tree, base_keys[i], create_integer_content(i));
+}
+ibst_print_items(&test_tree);
+printf("Used indexes: %u, capacity unchanged: %s\n", test_tree.used - 1,
+       test_tree.capacity == capacity ? "yes" : "no");
+ENDTEST
+
+typedef struct order_check {
+  long long previous;
+  int count;
+  int errors;
+} order_check_t;
+
+static void check_order(bst_key_t key, bst_node_content_t *content,
+                        void *data) {
+  order_check_t *check = data;
+  if (key <= check->previous || *(int *)content->value != (int)key)
+    check->errors++;
+  check->previous = key;
+  check->count++;
+}
+
+TEST(test_tree_random, "Compare random inserts and deletes with a bitmap")
+char present[1024] = {0};
+unsigned int seed = 4242;
+int errors = 0;
+for (int i = 0; i < 20000; i++) {
+  seed = seed * 1103515245 + 12345;
+  int key = (seed >> 8) % 1024;
+  if ((seed >> 20) % 3 == 0) {
+    ibst_delete(&test_tree, key);
+    present[key] = 0;
+  } else {
+    ibst_insert(&test_tree, key, create_integer_content(key));
+    present[key] = 1;
+  }
+}
+int expected = 0;
+for (int key = 0; key < 1024; key++) {
+  bst_node_content_t *result;
+  expected += present[key];
+  if (ibst_search(&test_tree, key, &result) != present[key])
+    errors++;
+}
+order_check_t check = {-1, 0, 0};
+ibst_inorder(&test_tree, check_order, &check);
+printf("Count matches: %s, mismatches: %d\n",
+       check.count == expected && test_tree.count == (ibst_index_t)expected
+           ? "yes"
+           : "no",
+       errors + check.errors);
+ENDTEST
+
+int main(int argc, char *argv[]) {
+  init_test();
+
+  test_tree_init();
+  test_tree_insert_many();
+  test_tree_update();
+  test_tree_search();
+  test_tree_delete();
+  test_tree_delete_root();
+  test_tree_reuse_indexes();
+  test_tree_random();
+}
@@ -0,0 +1,93 @@
+#include "test_util.h"
+#include "../dump.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void ibst_print_content(bst_node_content_t *content) {
+  if (content == NULL) {
+    printf("NULL");
+  } else if (content->type == INTEGER) {
+    printf("%d", *(int *)content->value);
+  } else {
+    printf("Unknown");
+  }
+}
+
+void ibst_print_node(bst_key_t key, bst_node_content_t *content) {
+  printf("[%c,", (int)key);
+  ibst_print_content(content);
+  printf("]");
+}
+
+// Uzel ve výpisu je ukazatel do tree->nodes, chybějící potomek je NULL
+static const void *ibst_shape_child(ibst_t *tree, ibst_index_t index) {
+  return index == IBST_NIL ? NULL : &tree->nodes[index];
+}
+
+static const void *ibst_shape_left(const void *node, void *data) {
+  return ibst_shape_child(data, ((const ibst_node_t *)node)->left);
+}
+
+static const void *ibst_shape_right(const void *node, void *data) {
+  return ibst_shape_child(data, ((const ibst_node_t *)node)->right);
+}
+
+static void ibst_shape_node(dump_buffer_t *dump, const void *node, void *data) {
+  ibst_t *tree = data;
+  const ibst_node_t *tree_node = node;
+  dump_char(dump, '[');
+  dump_char(dump, (char)tree_node->key);
+  dump_char(dump, ',');
+  bst_dump_content(dump, &tree->contents[tree_node - tree->nodes]);
+  dump_char(dump, ']');
+}
+
+void ibst_print_tree(ibst_t *tree) {
+  dump_buffer_t dump;
+  dump_init(&dump, stdout);
+  dump_text(&dump, "Binary tree structure:\n\n");
+  if (tree->root != IBST_NIL) {
+    dump_shape_t shape = {ibst_shape_left, ibst_shape_right,
+                         ibst_shape_node, tree};
+    dump_shape(&dump, &tree->nodes[tree->root], &shape);
+  } else {
+    dump_text(&dump, "Tree is empty\n");
+  }
+  dump_char(&dump, '\n');
+  dump_flush(&dump);
+  dump_dispose(&dump);
+}
+
+void ibst_print_search_result(bst_node_content_t *content) {
+  printf("Search result: ");
+  ibst_print_content(content);
+  printf("\n");
+}
+
+static void ibst_print_visit(bst_key_t key, bst_node_content_t *content,
+                             void *data) {
+  (void)data;
+  ibst_print_node(key, content);
+}
+
+void ibst_print_items(ibst_t *tree) {
+  printf("Traversed items:\n");
+  ibst_inorder(tree, ibst_print_visit, NULL);
+  printf("\n");
+}
+
+bst_node_content_t create_integer_content(int value) {
+  bst_node_content_t result = {
+    .type = INTEGER,
+    .value = malloc(sizeof(int))
+  };
+  *((int *)(result.value)) = value;
+  return result;
+}
+
+void ibst_insert_many(ibst_t *tree, const char keys[], const int values[],
+                      int count) {
+  for (int i = 0; i < count; i++) {
+    ibst_insert(tree, keys[i], create_integer_content(values[i]));
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef IAL_BTREE_IBST_TEST_UTIL_H
+#define IAL_BTREE_IBST_TEST_UTIL_H
+
+#include "ibst.h"
+#include <stdio.h>
+
+#define TEST(NAME, DESCRIPTION)                                                \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    ibst_t test_tree;                                                          \
+    ibst_init(&test_tree);
+
+#define ENDTEST                                                                \
+  printf("\n");                                                                \
+  ibst_dispose(&test_tree);                                                    \
+  }
+
+void ibst_print_tree(ibst_t *tree);
+void ibst_print_search_result(bst_node_content_t *content);
+void ibst_print_items(ibst_t *tree);
+bst_node_content_t create_integer_content(int value);
+void ibst_insert_many(ibst_t *tree, const char keys[], const int values[],
+                      int count);
+#endif
@@ -0,0 +1,134 @@
+#include "cbst.h"
+#include "../bench_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+const int total_ops = 2000000;
+
+typedef struct bench_worker {
+  void *tree;
+  pthread_mutex_t *lock;  // NULL: strom se zamykáním po uzlech
+  int key_space;
+  int ops;
+  uint64_t seed;
+} bench_worker_t;
+
+void init_bench() {
+  printf("Concurrent Binary Search Tree - benchmark\n");
+  printf("-----------------------------------------\n");
+  printf("\n");
+}
+
+static bst_node_content_t bench_content(int key) {
+  bst_node_content_t content = {.type = INTEGER, .value = malloc(sizeof(int))};
+  *(int *)content.value = key;
+  return content;
+}
+
+static uint64_t bench_worker_rand(uint64_t *x) {
+  *x ^= *x >> 12;
+  *x ^= *x << 25;
+  *x ^= *x >> 27;
+  return *x * 2685821657736338717ull;
+}
+
+/*
+ * Směs 80 % vyhledávání, 10 % vložení a 10 % mazání nad náhodnými klíči.
+ */
+static void *bench_cbst_worker(void *arg) {
+  bench_worker_t *worker = arg;
+  for (int i = 0; i < worker->ops; i++) {
+    uint64_t r = bench_worker_rand(&worker->seed);
+    int key = (int)((r >> 8) % worker->key_space);
+    bst_node_content_t value;
+    if (r % 10 == 0)
+      cbst_insert(worker->tree, key, bench_content(key));
+    else if (r % 10 == 1)
+      cbst_delete(worker->tree, key);
+    else
+      cbst_search(worker->tree, key, &value);
+  }
+  return NULL;
+}
+
+// Stejná směs nad btree/iter chráněným jedním zámkem
+static void *bench_mutex_worker(void *arg) {
+  bench_worker_t *worker = arg;
+  for (int i = 0; i < worker->ops; i++) {
+    uint64_t r = bench_worker_rand(&worker->seed);
+    char key = (char)((r >> 8) % worker->key_space);
+    bst_node_content_t *value;
+    pthread_mutex_lock(worker->lock);
+    if (r % 10 == 0)
+      bst_insert(worker->tree, key, bench_content(key));
+    else if (r % 10 == 1)
+      bst_delete(worker->tree, key);
+    else
+      bst_search(*(bst_node_t **)worker->tree, key, &value);
+    pthread_mutex_unlock(worker->lock);
+  }
+  return NULL;
+}
+
+static void bench_run(const char *mode, int threads, int key_space,
+                      void *tree, pthread_mutex_t *lock) {
+  pthread_t ids[8];
+  bench_worker_t workers[8];
+  double start = bench_now();
+  for (int t = 0; t < threads; t++) {
+    workers[t] = (bench_worker_t){tree, lock, key_space, total_ops / threads,
+                                  0x9E3779B97F4A7C15ull * (t + 1)};
+    pthread_create(&ids[t], NULL,
+                   lock != NULL ? bench_mutex_worker : bench_cbst_worker,
+                   &workers[t]);
+  }
+  for (int t = 0; t < threads; t++)
+    pthread_join(ids[t], NULL);
+  char label[48];
+  snprintf(label, sizeof(label), "%s keys=%d threads=%d", mode, key_space,
+           threads);
+  bench_report(label, (long)(total_ops / threads) * threads,
+               bench_now() - start);
+}
+
+BENCH(bench_threads, "Mixed 80/10/10 workload against thread count")
+const int thread_counts[] = {1, 2, 4, 8};
+const int key_spaces[] = {128, 65536};
+for (int k = 0; k < 2; k++) {
+  for (int i = 0; i < 4; i++) {
+    cbst_t tree;
+    cbst_init(&tree);
+    bench_seed(42);
+    for (int j = 0; j < key_spaces[k] / 2; j++) {
+      int key = (int)(bench_rand() % key_spaces[k]);
+      cbst_insert(&tree, key, bench_content(key));
+    }
+    bench_run("cbst", thread_counts[i], key_spaces[k], &tree, NULL);
+    cbst_dispose(&tree);
+    pthread_mutex_destroy(&tree.root_lock);
+  }
+  // btree/iter má klíč typu char
+  if (key_spaces[k] > 128)
+    continue;
+  for (int i = 0; i < 4; i++) {
+    bst_node_t *tree;
+    pthread_mutex_t lock;
+    bst_init(&tree);
+    pthread_mutex_init(&lock, NULL);
+    bench_seed(42);
+    for (int j = 0; j < key_spaces[k] / 2; j++) {
+      char key = (char)(bench_rand() % key_spaces[k]);
+      bst_insert(&tree, key, bench_content(key));
+    }
+    bench_run("mutex iter", thread_counts[i], key_spaces[k], &tree, &lock);
+    bst_dispose(&tree);
+    pthread_mutex_destroy(&lock);
+  }
+}
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_threads();
+}
@@ -0,0 +1,294 @@
+/*
+ * Binární vyhledávací strom se zamykáním po uzlech
+ *
+ * Každý uzel má vlastní zámek a operace sestupují od kořene metodou
+ * hand-over-hand: zámek potomka se vezme dřív, než se uvolní zámek rodiče.
+ * Vlákno tak drží nejvýše dva (při mazání uzlu se dvěma podstromy tři)
+ * zámky po sobě jdoucích uzlů jedné cesty a zámky se berou vždy shora dolů,
+ * takže nemůže dojít k uváznutí. Operace nad různými částmi klíčového
+ * prostoru se rozejdou hned pod kořenem a dál běží souběžně.
+ *
+ * Každá operace je linearizovatelná v okamžiku, kdy drží zámek uzlu, ve
+ * kterém hledání skončí (nebo rodiče prázdného ukazatele).
+ */
+
+#include "cbst.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Nový uzel, který převezme hodnotu; při nedostatku paměti hodnotu uvolní
+ * a vrátí NULL.
+ */
+static cbst_node_t *cbst_new_node(int key, bst_node_content_t value)
+{
+  cbst_node_t *node = malloc(sizeof(cbst_node_t));
+  if (node == NULL)
+  {
+    free(value.value);
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+    return NULL;
+  }
+  node->key = key;
+  node->content = value;
+  node->left = NULL;
+  node->right = NULL;
+  pthread_mutex_init(&node->lock, NULL);
+  return node;
+}
+
+static void cbst_free_node(cbst_node_t *node)
+{
+  pthread_mutex_destroy(&node->lock);
+  free(node->content.value);
+  free(node);
+}
+
+/*
+ * Inicializace stromu.
+ */
+void cbst_init(cbst_t *tree)
+{
+  tree->root = NULL;
+  pthread_mutex_init(&tree->root_lock, NULL);
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíčem už ve stromu existuje, nahraďte jeho hodnotu
+ * a vraťte false. Jinak vraťte true. Strom převezme vlastnictví hodnoty;
+ * pokud se uzel nepodaří alokovat, hodnota se uvolní, strom se nezmění a
+ * funkce vrátí false.
+ */
+bool cbst_insert(cbst_t *tree, int key, bst_node_content_t value)
+{
+  pthread_mutex_lock(&tree->root_lock);
+  if (tree->root == NULL)
+  {
+    tree->root = cbst_new_node(key, value);
+    bool inserted = tree->root != NULL;
+    pthread_mutex_unlock(&tree->root_lock);
+    return inserted;
+  }
+
+  cbst_node_t *node = tree->root;
+  pthread_mutex_lock(&node->lock);
+  pthread_mutex_unlock(&tree->root_lock);
+
+  while (node->key != key)
+  {
+    cbst_node_t **next = key < node->key ? &node->left : &node->right;
+    if (*next == NULL)
+    {
+      *next = cbst_new_node(key, value);
+      bool inserted = *next != NULL;
+      pthread_mutex_unlock(&node->lock);
+      return inserted;
+    }
+    cbst_node_t *child = *next;
+    pthread_mutex_lock(&child->lock);
+    pthread_mutex_unlock(&node->lock);
+    node = child;
+  }
+
+  free(node->content.value);
+  node->content = value;
+  pthread_mutex_unlock(&node->lock);
+  return false;
+}
+
+/*
+ * Vyhledání uzlu ve stromu.
+ *
+ * V případě úspěchu vrátí true a do value zkopíruje obal hodnoty uzlu.
+ * Hodnota, na kterou obal ukazuje, zůstává platná jen do smazání nebo
+ * přepsání klíče jiným vláknem.
+ */
+bool cbst_search(cbst_t *tree, int key, bst_node_content_t *value)
+{
+  pthread_mutex_lock(&tree->root_lock);
+  cbst_node_t *node = tree->root;
+  if (node == NULL)
+  {
+    pthread_mutex_unlock(&tree->root_lock);
+    return false;
+  }
+  pthread_mutex_lock(&node->lock);
+  pthread_mutex_unlock(&tree->root_lock);
+
+  while (node->key != key)
+  {
+    cbst_node_t *next = key < node->key ? node->left : node->right;
+    if (next == NULL)
+    {
+      pthread_mutex_unlock(&node->lock);
+      return false;
+    }
+    pthread_mutex_lock(&next->lock);
+    pthread_mutex_unlock(&node->lock);
+    node = next;
+  }
+
+  *value = node->content;
+  pthread_mutex_unlock(&node->lock);
+  return true;
+}
+
+/*
+ * Pomocná funkce, která nahradí uzel target nejpravějším uzlem levého
+ * podstromu (obdoba bst_replace_by_rightmost).
+ *
+ * Volající drží zámek target. Zámky se po cestě berou dál shora dolů;
+ * vlákna, která target minula před námi, jsou na cestě vždy před námi,
+ * takže hledání klíče nejpravějšího uzlu skončí dřív, než ho přesuneme.
+ */
+static void cbst_replace_by_rightmost(cbst_node_t *target)
+{
+  pthread_mutex_t *parent_lock = &target->lock;
+  cbst_node_t **link = &target->left;
+  cbst_node_t *rightmost = *link;
+  pthread_mutex_lock(&rightmost->lock);
+
+  while (rightmost->right != NULL)
+  {
+    pthread_mutex_lock(&rightmost->right->lock);
+    if (parent_lock != &target->lock)
+      pthread_mutex_unlock(parent_lock);
+    parent_lock = &rightmost->lock;
+    link = &rightmost->right;
+    rightmost = rightmost->right;
+  }
+
+  free(target->content.value);
+  target->key = rightmost->key;
+  target->content = rightmost->content;
+  *link = rightmost->left;
+
+  pthread_mutex_unlock(&rightmost->lock);
+  if (parent_lock != &target->lock)
+    pthread_mutex_unlock(parent_lock);
+  pthread_mutex_destroy(&rightmost->lock);
+  free(rightmost);
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Vrátí true, pokud uzel se zadaným klíčem existoval. Uzel se dvěma
+ * podstromy se nahradí nejpravějším uzlem levého podstromu.
+ *
+ * Na odpojovaný uzel nemůže nikdo čekat: zámek potomka se bere jen se
+ * zámkem rodiče, který drží mazající vlákno.
+ */
+bool cbst_delete(cbst_t *tree, int key)
+{
+  pthread_mutex_t *parent_lock = &tree->root_lock;
+  pthread_mutex_lock(parent_lock);
+  cbst_node_t **link = &tree->root;
+  cbst_node_t *node = *link;
+  if (node == NULL)
+  {
+    pthread_mutex_unlock(parent_lock);
+    return false;
+  }
+  pthread_mutex_lock(&node->lock);
+
+  while (node->key != key)
+  {
+    cbst_node_t **next = key < node->key ? &node->left : &node->right;
+    if (*next == NULL)
+    {
+      pthread_mutex_unlock(&node->lock);
+      pthread_mutex_unlock(parent_lock);
+      return false;
+    }
+    pthread_mutex_lock(&(*next)->lock);
+    pthread_mutex_unlock(parent_lock);
+    parent_lock = &node->lock;
+    link = next;
+    node = *next;
+  }
+
+  if (node->left != NULL && node->right != NULL)
+  {
+    // Uzol zostava na svojom mieste, rodic uz nie je potrebny
+    pthread_mutex_unlock(parent_lock);
+    cbst_replace_by_rightmost(node);
+    pthread_mutex_unlock(&node->lock);
+    return true;
+  }
+
+  *link = node->left != NULL ? node->left : node->right;
+  pthread_mutex_unlock(parent_lock);
+  pthread_mutex_unlock(&node->lock);
+  cbst_free_node(node);
+  return true;
+}
+
+/*
+ * Zrušení stromu.
+ *
+ * Strom nesmí současně používat žádné jiné vlákno. Po zrušení je strom ve
+ * stavu po inicializaci.
+ */
+void cbst_dispose(cbst_t *tree)
+{
+  cbst_node_t *node = tree->root;
+
+  // Rotacie doprava rozvinu strom do zoznamu bez pomocnej pamate
+  while (node != NULL)
+  {
+    if (node->left != NULL)
+    {
+      cbst_node_t *left = node->left;
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    }
+    else
+    {
+      cbst_node_t *next = node->right;
+      cbst_free_node(node);
+      node = next;
+    }
+  }
+  tree->root = NULL;
+}
+
+/*
+ * Inorder průchod; pro každý uzel zavolá funkci visit.
+ *
+ * Průchod není atomický — strom nesmí během něj měnit jiné vlákno.
+ */
+void cbst_inorder(cbst_t *tree, void (*visit)(cbst_node_t *, void *),
+                  void *data)
+{
+  cbst_node_t *node = tree->root;
+
+  // Morrisov prechod, vlakna v pravych ukazateloch sa po navsteve zrusia
+  while (node != NULL)
+  {
+    if (node->left == NULL)
+    {
+      visit(node, data);
+      node = node->right;
+      continue;
+    }
+    cbst_node_t *pred = node->left;
+    while (pred->right != NULL && pred->right != node)
+      pred = pred->right;
+    if (pred->right == NULL)
+    {
+      pred->right = node;
+      node = node->left;
+    }
+    else
+    {
+      pred->right = NULL;
+      visit(node, data);
+      node = node->right;
+    }
+  }
+}
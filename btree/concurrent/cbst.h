@@ -0,0 +1,36 @@
+/*
+ * Hlavičkový soubor pro binární vyhledávací strom bezpečný pro souběžný
+ * přístup z více vláken.
+ */
+
+#ifndef IAL_BTREE_CBST_H
+#define IAL_BTREE_CBST_H
+
+#include "../btree.h"
+#include <pthread.h>
+
+// Uzel stromu
+typedef struct cbst_node {
+  int key;                     // klíč
+  bst_node_content_t content;  // hodnota
+  struct cbst_node *left;      // levý potomek
+  struct cbst_node *right;     // pravý potomek
+  pthread_mutex_t lock;        // chrání klíč, hodnotu a oba ukazatele na potomky
+} cbst_node_t;
+
+// Strom
+typedef struct cbst {
+  cbst_node_t *root;           // kořen
+  pthread_mutex_t root_lock;   // chrání ukazatel na kořen
+} cbst_t;
+
+void cbst_init(cbst_t *tree);
+bool cbst_insert(cbst_t *tree, int key, bst_node_content_t value);
+bool cbst_search(cbst_t *tree, int key, bst_node_content_t *value);
+bool cbst_delete(cbst_t *tree, int key);
+void cbst_dispose(cbst_t *tree);
+
+void cbst_inorder(cbst_t *tree, void (*visit)(cbst_node_t *, void *),
+                  void *data);
+
+#endif
@@ -0,0 +1,179 @@
+#include "cbst.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+const int base_data_count = 15;
+const char base_keys[] = {'H', 'D', 'L', 'B', 'F', 'J', 'N', 'A',
+                          'C', 'E', 'G', 'I', 'K', 'M', 'O'};
+const int base_values[] = {8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7, 9, 11, 13, 16};
+
+void init_test() {
+  printf("Concurrent Binary Search Tree - testing script\n");
+  printf("----------------------------------------------\n");
+  printf("\n");
+}
+
+TEST(test_tree_init, "Initialize the tree")
+cbst_print_tree(test_tree.root);
+ENDTEST
+
+TEST(test_tree_insert_many, "Insert many values")
+cbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+cbst_print_tree(test_tree.root);
+ENDTEST
+
+TEST(test_tree_insert_replace, "Replace a value (H,20)")
+cbst_insert_many(&test_tree, base_keys, base_values, 3);
+printf("New key: %s\n",
+       cbst_insert(&test_tree, 'H', create_integer_content(20)) ? "yes" : "no");
+cbst_print_tree(test_tree.root);
+ENDTEST
+
+TEST(test_tree_search, "Search for an existing and a missing key (A, X)")
+cbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_node_content_t result;
+if (cbst_search(&test_tree, 'A', &result))
+  cbst_print_search_result(&result);
+if (!cbst_search(&test_tree, 'X', &result))
+  cbst_print_search_result(NULL);
+ENDTEST
+
+TEST(test_tree_delete, "Delete a leaf, an inner node and a missing key (A, B, X)")
+cbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+cbst_delete(&test_tree, 'A');
+cbst_delete(&test_tree, 'B');
+printf("Deleted X: %s\n", cbst_delete(&test_tree, 'X') ? "yes" : "no");
+cbst_print_tree(test_tree.root);
+ENDTEST
+
+TEST(test_tree_delete_two_children, "Delete nodes with two subtrees (L, H)")
+cbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+cbst_delete(&test_tree, 'L');
+cbst_delete(&test_tree, 'H');
+cbst_print_tree(test_tree.root);
+cbst_print_items(&test_tree);
+ENDTEST
+
+/*
+ * Zátěžový test linearizovatelnosti.
+ *
+ * Každé vlákno vlastní klíče s indexem t (mod počet vláken) a vede si jejich
+ * sekvenční model; protože vlastní klíče nikdo jiný nemění, musí výsledek
+ * každé operace přesně odpovídat modelu i při souběžných změnách tvaru
+ * stromu ostatními vlákny. Sdílené klíče (záporné) mění všechna vlákna a
+ * kontroluje se bilance: úspěšná vložení minus úspěšná mazání musí na konci
+ * dát jejich počet ve stromu.
+ */
+#define STRESS_THREADS 4
+#define STRESS_OWNED 64
+#define STRESS_SHARED 16
+
+typedef struct stress_state {
+  cbst_t *tree;
+  int thread;
+  unsigned seed;
+  int errors;
+  int shared_balance;
+} stress_state_t;
+
+static unsigned stress_rand(unsigned *seed) {
+  *seed = *seed * 1103515245u + 12345u;
+  return *seed >> 8;
+}
+
+static void *stress_worker(void *arg) {
+  stress_state_t *state = arg;
+  int model[STRESS_OWNED];
+  for (int i = 0; i < STRESS_OWNED; i++)
+    model[i] = -1;
+
+  for (int op = 0; op < 20000; op++) {
+    unsigned r = stress_rand(&state->seed);
+    int slot = r % STRESS_OWNED;
+    int key = slot * STRESS_THREADS + state->thread;
+    bst_node_content_t value;
+    switch ((r >> 8) % 4) {
+    case 0:
+      if (cbst_insert(state->tree, key, create_integer_content(op)) !=
+          (model[slot] < 0))
+        state->errors++;
+      model[slot] = op;
+      break;
+    case 1:
+      if (cbst_delete(state->tree, key) != (model[slot] >= 0))
+        state->errors++;
+      model[slot] = -1;
+      break;
+    case 2:
+      if (cbst_search(state->tree, key, &value) != (model[slot] >= 0) ||
+          (model[slot] >= 0 && *(int *)value.value != model[slot]))
+        state->errors++;
+      break;
+    default:
+      key = -1 - (int)(r % STRESS_SHARED);
+      if (r & 1 << 20)
+        state->shared_balance +=
+            cbst_insert(state->tree, key, create_integer_content(key));
+      else
+        state->shared_balance -= cbst_delete(state->tree, key);
+      break;
+    }
+  }
+
+  for (int slot = 0; slot < STRESS_OWNED; slot++) {
+    bst_node_content_t value;
+    int key = slot * STRESS_THREADS + state->thread;
+    if (cbst_search(state->tree, key, &value) != (model[slot] >= 0))
+      state->errors++;
+  }
+  return NULL;
+}
+
+typedef struct order_check {
+  int previous;
+  int shared;
+  int errors;
+} order_check_t;
+
+static void check_order(cbst_node_t *node, void *data) {
+  order_check_t *check = data;
+  if (node->key <= check->previous)
+    check->errors++;
+  check->previous = node->key;
+  check->shared += node->key < 0;
+}
+
+TEST(test_concurrent_stress, "Linearizability stress test (4 threads)")
+pthread_t threads[STRESS_THREADS];
+stress_state_t states[STRESS_THREADS];
+for (int t = 0; t < STRESS_THREADS; t++) {
+  states[t] = (stress_state_t){&test_tree, t, 7919u * (t + 1), 0, 0};
+  pthread_create(&threads[t], NULL, stress_worker, &states[t]);
+}
+int errors = 0;
+int shared_balance = 0;
+for (int t = 0; t < STRESS_THREADS; t++) {
+  pthread_join(threads[t], NULL);
+  errors += states[t].errors;
+  shared_balance += states[t].shared_balance;
+}
+order_check_t check = {-1 - STRESS_SHARED, 0, 0};
+cbst_inorder(&test_tree, check_order, &check);
+printf("Operation errors: %d\n", errors);
+printf("Order errors: %d\n", check.errors);
+printf("Shared keys balanced: %s\n",
+       shared_balance == check.shared ? "yes" : "no");
+ENDTEST
+
+int main(int argc, char *argv[]) {
+  init_test();
+
+  test_tree_init();
+  test_tree_insert_many();
+  test_tree_insert_replace();
+  test_tree_search();
+  test_tree_delete();
+  test_tree_delete_two_children();
+  test_concurrent_stress();
+}
@@ -0,0 +1,89 @@
+#include "test_util.h"
+#include "../dump.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void cbst_print_content(bst_node_content_t *content) {
+  if (content == NULL) {
+    printf("NULL");
+  } else if (content->type == INTEGER) {
+    printf("%d", *(int *)content->value);
+  } else {
+    printf("Unknown");
+  }
+}
+
+void cbst_print_node(cbst_node_t *node) {
+  printf("[%c,", node->key);
+  cbst_print_content(&node->content);
+  printf("]");
+}
+
+static const void *cbst_shape_left(const void *node, void *data) {
+  (void)data;
+  return ((const cbst_node_t *)node)->left;
+}
+
+static const void *cbst_shape_right(const void *node, void *data) {
+  (void)data;
+  return ((const cbst_node_t *)node)->right;
+}
+
+static void cbst_shape_node(dump_buffer_t *dump, const void *node, void *data) {
+  const cbst_node_t *tree_node = node;
+  (void)data;
+  dump_char(dump, '[');
+  dump_char(dump, (char)tree_node->key);
+  dump_char(dump, ',');
+  bst_dump_content(dump, (bst_node_content_t *)&tree_node->content);
+  dump_char(dump, ']');
+}
+
+void cbst_print_tree(cbst_node_t *tree) {
+  dump_buffer_t dump;
+  dump_init(&dump, stdout);
+  dump_text(&dump, "Binary tree structure:\n\n");
+  if (tree != NULL) {
+    dump_shape_t shape = {cbst_shape_left, cbst_shape_right,
+                         cbst_shape_node, NULL};
+    dump_shape(&dump, tree, &shape);
+  } else {
+    dump_text(&dump, "Tree is empty\n");
+  }
+  dump_char(&dump, '\n');
+  dump_flush(&dump);
+  dump_dispose(&dump);
+}
+
+void cbst_print_search_result(bst_node_content_t *content) {
+  printf("Search result: ");
+  cbst_print_content(content);
+  printf("\n");
+}
+
+static void cbst_print_visit(cbst_node_t *node, void *data) {
+  (void)data;
+  cbst_print_node(node);
+}
+
+void cbst_print_items(cbst_t *tree) {
+  printf("Traversed items:\n");
+  cbst_inorder(tree, cbst_print_visit, NULL);
+  printf("\n");
+}
+
+bst_node_content_t create_integer_content(int value) {
+  bst_node_content_t result = {
+    .type = INTEGER,
+    .value = malloc(sizeof(int))
+  };
+  *((int *)(result.value)) = value;
+  return result;
+}
+
+void cbst_insert_many(cbst_t *tree, const char keys[], const int values[],
+                      int count) {
+  for (int i = 0; i < count; i++) {
+    cbst_insert(tree, keys[i], create_integer_content(values[i]));
+  }
+}
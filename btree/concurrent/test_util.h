@@ -0,0 +1,25 @@
+#ifndef IAL_BTREE_CBST_TEST_UTIL_H
+#define IAL_BTREE_CBST_TEST_UTIL_H
+
+#include "cbst.h"
+#include <stdio.h>
+
+#define TEST(NAME, DESCRIPTION)                                                \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    cbst_t test_tree;                                                          \
+    cbst_init(&test_tree);
+
+#define ENDTEST                                                                \
+  printf("\n");                                                                \
+  cbst_dispose(&test_tree);                                                    \
+  pthread_mutex_destroy(&test_tree.root_lock);                                 \
+  }
+
+void cbst_print_tree(cbst_node_t *tree);
+void cbst_print_search_result(bst_node_content_t *content);
+void cbst_print_items(cbst_t *tree);
+bst_node_content_t create_integer_content(int value);
+void cbst_insert_many(cbst_t *tree, const char keys[], const int values[],
+                      int count);
+#endif
@@ -0,0 +1,488 @@
+/*
+ * Výpis stromu do výstupního bufferu
+ *
+ * Textový výpis má stejný tvar jako bst_print_tree, uzly se ale neprochází
+ * rekurzí a prefix řádku se neskládá pro každý uzel znovu: prefix uzlu v
+ * hloubce d je prvních 3 * d znaků jednoho pole, potomek k němu jen připíše
+ * svůj úsek. Výstup se místo printf skládá v bufferu a zapisuje po velkých
+ * blocích, takže výpis nezávisí na hloubce stromu ani na počtu volání stdio.
+ */
+
+#include "dump.h"
+#include "character.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Úseky prefixu textového výpisu, každý má DUMP_SEGMENT znaků
+#define DUMP_SEGMENT 3
+static const char dump_subtree_segment[] = "  |";
+static const char dump_space_segment[] = "   ";
+
+// Směr, ze kterého se do uzlu přišlo
+typedef enum dump_from
+{
+  DUMP_FROM_LEFT,
+  DUMP_FROM_RIGHT,
+  DUMP_FROM_ROOT
+} dump_from_t;
+
+// Rozpracovaný uzel: phase říká, kolik částí výpisu uzlu už je hotových
+typedef struct dump_frame
+{
+  const void *node;
+  dump_from_t from;
+  int phase;
+} dump_frame_t;
+
+void dump_init(dump_buffer_t *dump, FILE *out)
+{
+  dump->data = NULL;
+  dump->size = 0;
+  dump->capacity = 0;
+  dump->out = out;
+  dump->failed = false;
+  dump->prefix = NULL;
+  dump->prefix_capacity = 0;
+  dump->frames = NULL;
+  dump->frame_capacity = 0;
+}
+
+/*
+ * Místo pro dalších length bajtů výstupu. Vrací NULL, pokud se buffer
+ * nepodařilo zvětšit; výpis pak dál nic nezapisuje.
+ */
+static char *dump_reserve(dump_buffer_t *dump, size_t length)
+{
+  if (dump->failed)
+    return NULL;
+  if (dump->capacity - dump->size < length)
+  {
+    size_t capacity = dump->capacity * 2 + 256;
+    if (capacity < dump->size + length)
+      capacity = dump->size + length;
+    char *data = realloc(dump->data, capacity);
+    if (data == NULL)
+    {
+      dump->failed = true;
+      return NULL;
+    }
+    dump->data = data;
+    dump->capacity = capacity;
+  }
+  return dump->data + dump->size;
+}
+
+// Potvrzení length zapsaných bajtů, při výpisu do souboru případné vyprázdnění
+static void dump_commit(dump_buffer_t *dump, size_t length)
+{
+  dump->size += length;
+  if (dump->out != NULL && dump->size >= DUMP_FLUSH_SIZE)
+    dump_flush(dump);
+}
+
+void dump_bytes(dump_buffer_t *dump, const char *bytes, size_t length)
+{
+  char *target = dump_reserve(dump, length);
+  if (target == NULL)
+    return;
+  memcpy(target, bytes, length);
+  dump_commit(dump, length);
+}
+
+void dump_text(dump_buffer_t *dump, const char *text)
+{
+  dump_bytes(dump, text, strlen(text));
+}
+
+void dump_char(dump_buffer_t *dump, char c)
+{
+  char *target = dump_reserve(dump, 1);
+  if (target == NULL)
+    return;
+  *target = c;
+  dump_commit(dump, 1);
+}
+
+void dump_integer(dump_buffer_t *dump, long long value)
+{
+  char digits[24];
+  int length = 0;
+  unsigned long long magnitude =
+      value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+  do
+  {
+    digits[sizeof(digits) - 1 - length++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (value < 0)
+    digits[sizeof(digits) - 1 - length++] = '-';
+  dump_bytes(dump, digits + sizeof(digits) - length, (size_t)length);
+}
+
+/*
+ * Zápis čísla podle formátu printf. Většina čísel se vejde do první
+ * rezervace, delší výstup (např. %.2f velkého čísla) se zapíše znovu.
+ */
+static void dump_format(dump_buffer_t *dump, const char *format, int precision,
+                        double value)
+{
+  size_t length = 32;
+  for (;;)
+  {
+    char *target = dump_reserve(dump, length);
+    if (target == NULL)
+      return;
+    int written = snprintf(target, length, format, precision, value);
+    if (written < 0)
+    {
+      dump->failed = true;
+      return;
+    }
+    if ((size_t)written < length)
+    {
+      dump_commit(dump, (size_t)written);
+      return;
+    }
+    length = (size_t)written + 1;
+  }
+}
+
+// Číslo s pevným počtem desetinných míst, jako printf("%.*f")
+void dump_fixed(dump_buffer_t *dump, double value, int decimals)
+{
+  dump_format(dump, "%.*f", decimals, value);
+}
+
+// Číslo pro JSON na digits platných číslic; nekonečno a NaN jako null
+void dump_number(dump_buffer_t *dump, double value, int digits)
+{
+  if (!isfinite(value))
+  {
+    dump_text(dump, "null");
+    return;
+  }
+  dump_format(dump, "%.*g", digits, value);
+}
+
+void dump_json_string(dump_buffer_t *dump, const char *text)
+{
+  static const char hex[] = "0123456789abcdef";
+  dump_char(dump, '"');
+  const char *run = text;
+  for (const char *c = text; *c != '\0'; c++)
+  {
+    unsigned char byte = (unsigned char)*c;
+    if (byte >= 0x20 && byte != '"' && byte != '\\')
+      continue;
+    dump_bytes(dump, run, (size_t)(c - run));
+    run = c + 1;
+    switch (byte)
+    {
+    case '"':
+      dump_text(dump, "\\\"");
+      break;
+    case '\\':
+      dump_text(dump, "\\\\");
+      break;
+    case '\n':
+      dump_text(dump, "\\n");
+      break;
+    case '\r':
+      dump_text(dump, "\\r");
+      break;
+    case '\t':
+      dump_text(dump, "\\t");
+      break;
+    default:
+    {
+      char escape[6] = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 15]};
+      dump_bytes(dump, escape, sizeof(escape));
+      break;
+    }
+    }
+  }
+  dump_text(dump, run);
+  dump_char(dump, '"');
+}
+
+/*
+ * Zápis obsahu bufferu do souboru. Bez souboru jen vrátí, zda se dosud
+ * vše podařilo; výstup pak zůstává v data.
+ */
+bool dump_flush(dump_buffer_t *dump)
+{
+  if (dump->out == NULL || dump->failed)
+    return !dump->failed;
+  if (dump->size > 0 &&
+      fwrite(dump->data, 1, dump->size, dump->out) != dump->size)
+    dump->failed = true;
+  dump->size = 0;
+  return !dump->failed;
+}
+
+void dump_dispose(dump_buffer_t *dump)
+{
+  free(dump->data);
+  free(dump->prefix);
+  free(dump->frames);
+  dump_init(dump, dump->out);
+}
+
+/*
+ * Vložení uzlu na zásobník v hloubce depth. Se zásobníkem roste i pole
+ * prefixu, aby se do něj vešel prefix každého uloženého uzlu.
+ */
+static bool dump_push(dump_buffer_t *dump, size_t depth, const void *node,
+                      dump_from_t from)
+{
+  if (depth == dump->frame_capacity)
+  {
+    size_t capacity = dump->frame_capacity * 2 + 64;
+    dump_frame_t *frames = realloc(dump->frames, capacity * sizeof(dump_frame_t));
+    if (frames == NULL)
+    {
+      dump->failed = true;
+      return false;
+    }
+    dump->frames = frames;
+    dump->frame_capacity = capacity;
+
+    char *prefix = realloc(dump->prefix, capacity * DUMP_SEGMENT);
+    if (prefix == NULL)
+    {
+      dump->failed = true;
+      return false;
+    }
+    dump->prefix = prefix;
+    dump->prefix_capacity = capacity * DUMP_SEGMENT;
+  }
+  dump->frames[depth].node = node;
+  dump->frames[depth].from = from;
+  dump->frames[depth].phase = 0;
+  return true;
+}
+
+// Obsah uzlu ve tvaru bst_print_node_content
+void bst_dump_content(dump_buffer_t *dump, bst_node_content_t *content)
+{
+  if (content->value == NULL)
+  {
+    dump_text(dump, "NULL");
+    return;
+  }
+  switch (content->type)
+  {
+  case INTEGER:
+    dump_integer(dump, *(int *)content->value);
+    break;
+
+  case CHARACTER_T:
+  {
+    character_t *character = content->value;
+    dump_text(dump, character->name);
+    dump_text(dump, ", ");
+    dump_text(dump, character_class_to_string(character->character_class));
+    dump_text(dump, ", ");
+    dump_integer(dump, character->level);
+    break;
+  }
+
+  default:
+    dump_text(dump, "Unknown");
+    break;
+  }
+}
+
+/*
+ * Uzel ve tvaru bst_print_node: [klíč,obsah].
+ */
+void bst_dump_node(dump_buffer_t *dump, bst_node_t *node)
+{
+  dump_char(dump, '[');
+  dump_char(dump, (char)node->key);
+  dump_char(dump, ',');
+  bst_dump_content(dump, &node->content);
+  dump_char(dump, ']');
+}
+
+// Řádek s prefixem uzlu v hloubce depth, za kterým následuje text
+static void dump_line(dump_buffer_t *dump, size_t depth, const char *text)
+{
+  dump_bytes(dump, dump->prefix, depth * DUMP_SEGMENT);
+  dump_text(dump, text);
+}
+
+/*
+ * Textový výpis stromu, řádek po řádku stejný jako bst_print_subtree:
+ * pravý podstrom nad uzlem, levý pod ním. Uzly a jejich potomky zpřístupní
+ * shape. Prázdný strom nezapíše nic.
+ */
+void dump_shape(dump_buffer_t *dump, const void *root,
+                const dump_shape_t *shape)
+{
+  if (root == NULL || !dump_push(dump, 0, root, DUMP_FROM_ROOT))
+    return;
+
+  size_t depth = 0;
+  for (;;)
+  {
+    dump_frame_t *frame = &dump->frames[depth];
+    const void *node = frame->node;
+    dump_from_t from = frame->from;
+    const void *child;
+    dump_from_t side;
+    const char *segment;
+
+    switch (frame->phase++)
+    {
+    case 0:
+      if (from == DUMP_FROM_LEFT)
+        dump_line(dump, depth, "  |\n");
+      child = shape->right(node, shape->data);
+      side = DUMP_FROM_RIGHT;
+      segment = from == DUMP_FROM_LEFT ? dump_subtree_segment
+                                       : dump_space_segment;
+      break;
+
+    case 1:
+      dump_line(dump, depth, "  +-");
+      shape->node(dump, node, shape->data);
+      dump_char(dump, '\n');
+      child = shape->left(node, shape->data);
+      side = DUMP_FROM_LEFT;
+      segment = from == DUMP_FROM_RIGHT ? dump_subtree_segment
+                                        : dump_space_segment;
+      break;
+
+    default:
+      if (from == DUMP_FROM_RIGHT)
+        dump_line(dump, depth, "  |\n");
+      if (depth == 0)
+        return;
+      depth--;
+      continue;
+    }
+
+    if (dump->failed)
+      return;
+    if (child != NULL)
+    {
+      if (!dump_push(dump, depth + 1, child, side))
+        return;
+      memcpy(dump->prefix + depth * DUMP_SEGMENT, segment, DUMP_SEGMENT);
+      depth++;
+    }
+  }
+}
+
+static const void *bst_dump_left(const void *node, void *data)
+{
+  (void)data;
+  return ((const bst_node_t *)node)->left;
+}
+
+static const void *bst_dump_right(const void *node, void *data)
+{
+  (void)data;
+  return ((const bst_node_t *)node)->right;
+}
+
+static void bst_dump_shape_node(dump_buffer_t *dump, const void *node,
+                                void *data)
+{
+  (void)data;
+  bst_dump_node(dump, (bst_node_t *)node);
+}
+
+void bst_dump_tree(dump_buffer_t *dump, bst_node_t *tree)
+{
+  static const dump_shape_t shape = {bst_dump_left, bst_dump_right,
+                                     bst_dump_shape_node, NULL};
+  dump_shape(dump, tree, &shape);
+}
+
+/*
+ * Výpis stromu jako JSON: uzel je objekt {"key", "value", "left", "right"},
+ * chybějící potomek i prázdný strom jsou null. Hodnota typu INTEGER je
+ * číslo, postava objekt {"name", "class", "level"}.
+ */
+void bst_dump_json(dump_buffer_t *dump, bst_node_t *tree)
+{
+  if (tree == NULL || !dump_push(dump, 0, tree, DUMP_FROM_ROOT))
+  {
+    dump_text(dump, "null");
+    return;
+  }
+
+  size_t depth = 0;
+  for (;;)
+  {
+    dump_frame_t *frame = &dump->frames[depth];
+    const bst_node_t *node = frame->node;
+    bst_node_t *child;
+    dump_from_t side;
+
+    switch (frame->phase++)
+    {
+    case 0:
+      dump_text(dump, "{\"key\":");
+      dump_integer(dump, node->key);
+      dump_text(dump, ",\"value\":");
+      if (node->content.value == NULL)
+      {
+        dump_text(dump, "null");
+      }
+      else if (node->content.type == INTEGER)
+      {
+        dump_integer(dump, *(int *)node->content.value);
+      }
+      else if (node->content.type == CHARACTER_T)
+      {
+        character_t *character = node->content.value;
+        dump_text(dump, "{\"name\":");
+        dump_json_string(dump, character->name);
+        dump_text(dump, ",\"class\":");
+        dump_json_string(dump,
+                         character_class_to_string(character->character_class));
+        dump_text(dump, ",\"level\":");
+        dump_integer(dump, character->level);
+        dump_char(dump, '}');
+      }
+      else
+      {
+        dump_text(dump, "null");
+      }
+      dump_text(dump, ",\"left\":");
+      child = node->left;
+      side = DUMP_FROM_LEFT;
+      break;
+
+    case 1:
+      dump_text(dump, ",\"right\":");
+      child = node->right;
+      side = DUMP_FROM_RIGHT;
+      break;
+
+    default:
+      dump_char(dump, '}');
+      if (depth == 0)
+        return;
+      depth--;
+      continue;
+    }
+
+    if (dump->failed)
+      return;
+    if (child == NULL)
+    {
+      dump_text(dump, "null");
+    }
+    else
+    {
+      if (!dump_push(dump, depth + 1, child, side))
+        return;
+      depth++;
+    }
+  }
+}
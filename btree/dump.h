@@ -0,0 +1,68 @@
+/*
+ * Hlavičkový soubor pro výpis stromu do výstupního bufferu.
+ */
+
+#ifndef IAL_BTREE_DUMP_H
+#define IAL_BTREE_DUMP_H
+
+#include "btree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Při výpisu do souboru se buffer vyprázdní, jakmile naroste nad tuto mez
+#define DUMP_FLUSH_SIZE (64 * 1024)
+
+struct dump_frame;
+
+/*
+ * Výstupní buffer. Výpis zapisuje do jednoho rostoucího pole; je-li zadán
+ * soubor, buffer se do něj průběžně vyprazdňuje, jinak zůstává celý
+ * výstup v data. Zásobník rámců a prefixů pro výpis stromu se mezi výpisy
+ * nepouští, opakovaný výpis tak po zahřátí nealokuje vůbec.
+ */
+typedef struct dump_buffer {
+  char *data;                   // výstup (bez koncové nuly)
+  size_t size;
+  size_t capacity;
+  FILE *out;                    // cíl vyprazdňování, NULL = jen do paměti
+  bool failed;                  // alokace nebo zápis selhaly
+
+  char *prefix;                 // prefix řádku textového výpisu stromu
+  size_t prefix_capacity;
+  struct dump_frame *frames;    // zásobník rozpracovaných uzlů
+  size_t frame_capacity;
+} dump_buffer_t;
+
+void dump_init(dump_buffer_t *dump, FILE *out);
+void dump_bytes(dump_buffer_t *dump, const char *bytes, size_t length);
+void dump_text(dump_buffer_t *dump, const char *text);
+void dump_char(dump_buffer_t *dump, char c);
+void dump_integer(dump_buffer_t *dump, long long value);
+void dump_fixed(dump_buffer_t *dump, double value, int decimals);
+void dump_number(dump_buffer_t *dump, double value, int digits);
+void dump_json_string(dump_buffer_t *dump, const char *text);
+bool dump_flush(dump_buffer_t *dump);
+void dump_dispose(dump_buffer_t *dump);
+
+/*
+ * Přístup k uzlům stromu jiné reprezentace (perzistentní, souběžný nebo
+ * kompaktní strom) pro textový výpis dump_shape. Uzel je neprůhledný
+ * ukazatel, chybějící potomek je NULL; data se předávají všem funkcím.
+ */
+typedef struct dump_shape {
+  const void *(*left)(const void *node, void *data);
+  const void *(*right)(const void *node, void *data);
+  void (*node)(dump_buffer_t *dump, const void *node, void *data);
+  void *data;
+} dump_shape_t;
+
+void dump_shape(dump_buffer_t *dump, const void *root,
+                const dump_shape_t *shape);
+
+void bst_dump_content(dump_buffer_t *dump, bst_node_content_t *content);
+void bst_dump_node(dump_buffer_t *dump, bst_node_t *node);
+void bst_dump_tree(dump_buffer_t *dump, bst_node_t *tree);
+void bst_dump_json(dump_buffer_t *dump, bst_node_t *tree);
+
+#endif
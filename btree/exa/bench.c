@@ -0,0 +1,124 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../btree.h"
+#include "../bench_util.h"
+#include "../pool.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+const size_t input_size = 16 << 20;
+const int rounds = 8;
+
+void init_bench() {
+  printf("Letter count - benchmark\n");
+  printf("------------------------\n");
+  printf("\n");
+}
+
+static const char *english =
+    "It was the best of times, it was the worst of times, it was the age of "
+    "wisdom, it was the age of foolishness, it was the epoch of belief, it "
+    "was the epoch of incredulity, it was the season of Light, it was the "
+    "season of Darkness, it was the spring of hope, it was the winter of "
+    "despair, we had everything before us, we had nothing before us. ";
+
+/*
+ * Vstup: opakovaný anglický text, nebo náhodné nenulové bajty.
+ */
+static char *bench_input(bool random) {
+  char *input = malloc(input_size + 1);
+  size_t length = strlen(english);
+  bench_seed(3);
+  for (size_t i = 0; i < input_size; i++) {
+    if (random) {
+      uint64_t r = bench_rand();
+      input[i] = (char)(r % 255 + 1);
+    } else {
+      input[i] = english[i % length];
+    }
+  }
+  input[input_size] = '\0';
+  return input;
+}
+
+BENCH(bench_letter_kernels, "Histogram kernels over 16 MB of English text and random bytes")
+const letter_kernel_t kernels[] = {LETTER_KERNEL_SCALAR, LETTER_KERNEL_SSE2,
+                                   LETTER_KERNEL_AVX2};
+const char *names[] = {"scalar", "sse2", "avx2"};
+for (int shape = 0; shape < 2; shape++) {
+  char *input = bench_input(shape == 1);
+  double scalar = 0;
+  for (int k = 0; k < 3; k++) {
+    char label[48];
+    if (!letter_count_set_kernel(kernels[k])) {
+      printf("  %-32s %s\n", names[k], "not supported");
+      continue;
+    }
+    int histogram[256] = {0};
+    double start = bench_now();
+    for (int r = 0; r < rounds; r++)
+      letter_histogram(input, input_size, histogram);
+    double seconds = bench_now() - start;
+    if (k == 0)
+      scalar = seconds;
+    snprintf(label, sizeof(label), "%s %s", names[k],
+             shape == 0 ? "english" : "random");
+    bench_report(label, (long)input_size * rounds, seconds);
+    printf("  %-32s %10.0f MB/s %6.2fx\n", "throughput",
+           input_size * rounds / seconds / 1e6, scalar / seconds);
+  }
+  letter_count_set_kernel(LETTER_KERNEL_AUTO);
+  bst_node_t *tree;
+  double start = bench_now();
+  letter_count(&tree, input);
+  bench_report(shape == 0 ? "letter_count english" : "letter_count random",
+               (long)input_size, bench_now() - start);
+  bst_dispose(&tree);
+  free(input);
+}
+ENDBENCH
+
+BENCH(bench_letter_stream, "Count a 64 MB file: mapped and read in chunks, 1-4 threads")
+const char *path = "bench_letters.txt";
+const int copies = 4;
+char *input = bench_input(false);
+FILE *file = fopen(path, "w");
+for (int i = 0; i < copies; i++)
+  fwrite(input, 1, input_size, file);
+fclose(file);
+free(input);
+for (int threads = 1; threads <= 4; threads *= 2) {
+  bst_pool_t *pool = bst_pool_create(threads);
+  for (int mode = 0; mode < 2; mode++) {
+    char label[48];
+    bst_node_t *tree;
+    double start = bench_now();
+    if (mode == 0) {
+      letter_count_file(&tree, path, pool);
+    } else {
+      int fd = open(path, O_RDONLY);
+      letter_count_fd(&tree, fd, pool);
+      close(fd);
+    }
+    double seconds = bench_now() - start;
+    snprintf(label, sizeof(label), "%s %d threads",
+             mode == 0 ? "mmap" : "read", threads);
+    bench_report(label, (long)input_size * copies, seconds);
+    printf("  %-32s %10.0f MB/s\n", "throughput",
+           input_size * copies / seconds / 1e6);
+    bst_dispose(&tree);
+  }
+  bst_pool_destroy(pool);
+}
+remove(path);
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_letter_kernels();
+  bench_letter_stream();
+}
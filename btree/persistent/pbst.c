@@ -0,0 +1,410 @@
+/*
+ * Perzistentní binární vyhledávací strom
+ *
+ * Uzly se po zveřejnění nikdy nemění. Vložení i smazání zkopíruje jen uzly
+ * na cestě od kořene k místu změny (O(výška)), ostatní podstromy nová verze
+ * sdílí se starou. Nový kořen se zveřejní atomickou výměnou, takže čtenář,
+ * který si funkcí pbst_acquire vzal kořen, prochází konzistentní snímek bez
+ * jakéhokoli zamykání, i když zapisovatelé mezitím vytvářejí další verze.
+ *
+ * Staré verze se uvolňují počítáním odkazů: kořen stromu i každý získaný
+ * snímek drží jeden odkaz na svůj kořen, každý uzel jeden odkaz na každého
+ * potomka. Uzel zanikne s posledním odkazem.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "pbst.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Pomocný zásobník uzlů (cesta od kořene, rozpracované uzly)
+typedef struct pbst_path {
+  pbst_node_t **nodes;
+  int size;
+  int capacity;
+} pbst_path_t;
+
+/*
+ * Vložení uzlu na zásobník. Při nedostatku paměti vrátí false a zásobník
+ * zůstane beze změny.
+ */
+static bool pbst_path_push(pbst_path_t *path, pbst_node_t *node)
+{
+  if (path->capacity < path->size + 1)
+  {
+    int capacity = path->capacity * 2 + 16;
+    pbst_node_t **nodes =
+        realloc(path->nodes, capacity * sizeof(pbst_node_t *));
+    if (nodes == NULL)
+      return false;
+    path->nodes = nodes;
+    path->capacity = capacity;
+  }
+  path->nodes[path->size++] = node;
+  return true;
+}
+
+static pbst_node_t *pbst_retain(pbst_node_t *node)
+{
+  if (node != NULL)
+    atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+  return node;
+}
+
+static pbst_value_t *pbst_retain_value(pbst_value_t *value)
+{
+  atomic_fetch_add_explicit(&value->refs, 1, memory_order_relaxed);
+  return value;
+}
+
+static void pbst_release_value(pbst_value_t *value)
+{
+  if (atomic_fetch_sub_explicit(&value->refs, 1, memory_order_acq_rel) == 1)
+  {
+    free(value->content.value);
+    free(value);
+  }
+}
+
+/*
+ * Vytvoření nového uzlu. Uzel převezme odkazy na value, left a right,
+ * které mu volající předává. Při nedostatku paměti vrátí NULL a předané
+ * odkazy uvolní.
+ */
+static pbst_node_t *pbst_make(int key, pbst_value_t *value, pbst_node_t *left,
+                              pbst_node_t *right)
+{
+  pbst_node_t *node = malloc(sizeof(pbst_node_t));
+  if (node == NULL)
+  {
+    pbst_release_value(value);
+    pbst_release(left);
+    pbst_release(right);
+    return NULL;
+  }
+  node->key = key;
+  atomic_init(&node->refs, 1);
+  node->value = value;
+  node->left = left;
+  node->right = right;
+  return node;
+}
+
+/*
+ * Kopie uzlu cesty, ve které je potomek na straně klíče key nahrazen
+ * uzlem fresh. Druhý potomek se sdílí.
+ */
+static pbst_node_t *pbst_copy_towards(pbst_node_t *node, int key,
+                                      pbst_node_t *fresh)
+{
+  if (key < node->key)
+    return pbst_make(node->key, pbst_retain_value(node->value), fresh,
+                     pbst_retain(node->right));
+  return pbst_make(node->key, pbst_retain_value(node->value),
+                   pbst_retain(node->left), fresh);
+}
+
+/*
+ * Zveřejnění nového kořene a uvolnění odkazu na starý.
+ *
+ * Starý kořen se smí uvolnit až poté, co ho žádný čtenář nemůže právě
+ * získávat; čtenář, který začne později, už uvidí nový kořen. Získání
+ * trvá jen pár instrukcí, takže zapisovatel čeká aktivně.
+ */
+static void pbst_publish(pbst_t *tree, pbst_node_t *root)
+{
+  pbst_node_t *old = atomic_exchange(&tree->root, root);
+  while (atomic_load(&tree->acquiring) != 0)
+    sched_yield();
+  pbst_release(old);
+}
+
+/*
+ * Inicializace stromu.
+ */
+void pbst_init(pbst_t *tree)
+{
+  atomic_init(&tree->root, NULL);
+  atomic_init(&tree->acquiring, 0);
+  pthread_mutex_init(&tree->writer, NULL);
+}
+
+/*
+ * Získání snímku aktuální verze stromu.
+ *
+ * Vrací kořen verze, který zůstane platný, dokud ho volající neuvolní
+ * funkcí pbst_release. Nezamyká — při souběžném zveřejnění nové verze jen
+ * zopakuje pokus.
+ */
+pbst_node_t *pbst_acquire(pbst_t *tree)
+{
+  while (true)
+  {
+    pbst_node_t *root = atomic_load(&tree->root);
+    atomic_fetch_add(&tree->acquiring, 1);
+    if (atomic_load(&tree->root) == root)
+    {
+      pbst_retain(root);
+      atomic_fetch_sub(&tree->acquiring, 1);
+      return root;
+    }
+    atomic_fetch_sub(&tree->acquiring, 1);
+  }
+}
+
+/*
+ * Uvolnění odkazu na kořen verze.
+ *
+ * Uzly, na které tím nezůstane žádný odkaz, se uvolní i se svými
+ * hodnotami; sdílené podstromy ostatních verzí zůstávají. Průchod
+ * nealokuje: zanikající uzel už nikdo jiný nevidí, jeho levý ukazatel
+ * proto poslouží jako odkaz v seznamu uzlů, jejichž pravý podstrom
+ * teprve čeká na uvolnění.
+ */
+void pbst_release(pbst_node_t *root)
+{
+  pbst_node_t *waiting = NULL;
+
+  while (true)
+  {
+    if (root != NULL &&
+        atomic_fetch_sub_explicit(&root->refs, 1, memory_order_acq_rel) == 1)
+    {
+      pbst_release_value(root->value);
+      pbst_node_t *left = root->left;
+      root->left = waiting;
+      waiting = root;
+      root = left;
+      continue;
+    }
+    if (waiting == NULL)
+      break;
+    pbst_node_t *dead = waiting;
+    waiting = dead->left;
+    root = dead->right;
+    free(dead);
+  }
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíčem už existuje, nová verze ho nahradí uzlem s
+ * novou hodnotou; stará hodnota zůstává snímkům, které ji ještě vidí.
+ * Strom převezme vlastnictví hodnoty. Při nedostatku paměti se hodnota
+ * uvolní a nová verze nevznikne.
+ */
+void pbst_insert(pbst_t *tree, int key, bst_node_content_t value)
+{
+  pthread_mutex_lock(&tree->writer);
+  pbst_path_t path = {NULL, 0, 0};
+  pbst_node_t *node = atomic_load(&tree->root);
+
+  bool pushed = true;
+
+  while (pushed && node != NULL && node->key != key)
+  {
+    pushed = pbst_path_push(&path, node);
+    node = key < node->key ? node->left : node->right;
+  }
+
+  pbst_value_t *box = pushed ? malloc(sizeof(pbst_value_t)) : NULL;
+  pbst_node_t *fresh = NULL;
+  if (box != NULL)
+  {
+    atomic_init(&box->refs, 1);
+    box->content = value;
+    if (node != NULL)
+      fresh = pbst_make(key, box, pbst_retain(node->left),
+                        pbst_retain(node->right));
+    else
+      fresh = pbst_make(key, box, NULL, NULL);
+  }
+  else
+    free(value.value);
+
+  // Kopia cesty zdola nahor; neuspesna kopia uvolni aj doterajsie uzly
+  for (int i = path.size - 1; i >= 0 && fresh != NULL; i--)
+    fresh = pbst_copy_towards(path.nodes[i], key, fresh);
+
+  if (fresh != NULL)
+    pbst_publish(tree, fresh);
+  else
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+  free(path.nodes);
+  pthread_mutex_unlock(&tree->writer);
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, nová verze nevznikne. Uzel se
+ * dvěma podstromy nahradí (v kopii) nejpravější uzel levého podstromu,
+ * stejně jako v bst_delete. Ani při nedostatku paměti nová verze nevznikne.
+ */
+void pbst_delete(pbst_t *tree, int key)
+{
+  pthread_mutex_lock(&tree->writer);
+  pbst_path_t path = {NULL, 0, 0};
+  pbst_node_t *node = atomic_load(&tree->root);
+
+  bool failed = false;
+
+  while (!failed && node != NULL && node->key != key)
+  {
+    failed = !pbst_path_push(&path, node);
+    node = key < node->key ? node->left : node->right;
+  }
+  if (node == NULL && !failed)
+  {
+    free(path.nodes);
+    pthread_mutex_unlock(&tree->writer);
+    return;
+  }
+
+  pbst_node_t *fresh = NULL;
+  if (!failed && (node->left == NULL || node->right == NULL))
+  {
+    // Najviac jeden podstrom, ten zaujme miesto odstraneneho uzla
+    fresh = pbst_retain(node->left != NULL ? node->left : node->right);
+  }
+  else if (!failed)
+  {
+    // Kopia cesty k najpravejsiemu uzlu laveho podstromu bez neho
+    pbst_path_t rightmost = {NULL, 0, 0};
+    pbst_node_t *current = node->left;
+    while (!failed && current->right != NULL)
+    {
+      failed = !pbst_path_push(&rightmost, current);
+      current = current->right;
+    }
+    pbst_node_t *left = failed ? NULL : pbst_retain(current->left);
+    for (int i = rightmost.size - 1; i >= 0 && !failed; i--)
+    {
+      pbst_node_t *copy = rightmost.nodes[i];
+      left = pbst_make(copy->key, pbst_retain_value(copy->value),
+                       pbst_retain(copy->left), left);
+      failed = left == NULL;
+    }
+    if (!failed)
+    {
+      fresh = pbst_make(current->key, pbst_retain_value(current->value),
+                        left, pbst_retain(node->right));
+      failed = fresh == NULL;
+    }
+    free(rightmost.nodes);
+  }
+
+  // Podstrom fresh moze byt prazdny, chybu preto urci az vysledok kopie
+  for (int i = path.size - 1; i >= 0 && !failed; i--)
+  {
+    fresh = pbst_copy_towards(path.nodes[i], key, fresh);
+    failed = fresh == NULL;
+  }
+
+  if (!failed)
+    pbst_publish(tree, fresh);
+  else
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+  free(path.nodes);
+  pthread_mutex_unlock(&tree->writer);
+}
+
+/*
+ * Zrušení stromu.
+ *
+ * Uvolní odkaz stromu na aktuální verzi; uzly dosud držených snímků
+ * zaniknou až s jejich uvolněním. Strom je poté ve stavu po inicializaci
+ * a nesmí ho souběžně používat žádné jiné vlákno.
+ */
+void pbst_dispose(pbst_t *tree)
+{
+  pthread_mutex_lock(&tree->writer);
+  pbst_publish(tree, NULL);
+  pthread_mutex_unlock(&tree->writer);
+}
+
+/*
+ * Vyhledání uzlu ve snímku.
+ *
+ * V případě úspěchu vrátí true a do value zapíše ukazatel na obsah uzlu,
+ * jinak vrátí false a value nemění.
+ */
+bool pbst_search(pbst_node_t *root, int key, bst_node_content_t **value)
+{
+  while (root != NULL)
+  {
+    if (key < root->key)
+      root = root->left;
+    else if (key > root->key)
+      root = root->right;
+    else
+    {
+      *value = &root->value->content;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Uzel s nejmenším klíčem větším než key, bez pomocné paměti.
+ */
+static pbst_node_t *pbst_successor(pbst_node_t *root, int key)
+{
+  pbst_node_t *successor = NULL;
+  while (root != NULL)
+  {
+    if (key < root->key)
+    {
+      successor = root;
+      root = root->left;
+    }
+    else
+      root = root->right;
+  }
+  return successor;
+}
+
+/*
+ * Inorder průchod snímkem; pro každý uzel zavolá funkci visit.
+ *
+ * Když zásobníku dojde paměť, průchod pokračuje od posledního navštíveného
+ * klíče hledáním následníka od kořene, tj. pomaleji, ale úplně.
+ */
+void pbst_inorder(pbst_node_t *root, void (*visit)(pbst_node_t *, void *),
+                  void *data)
+{
+  pbst_path_t stack = {NULL, 0, 0};
+  pbst_node_t *snapshot = root;
+  pbst_node_t *last = NULL;
+
+  while (root != NULL || stack.size > 0)
+  {
+    while (root != NULL && pbst_path_push(&stack, root))
+      root = root->left;
+    // Zasobniku dosla pamat
+    if (root != NULL)
+      break;
+    root = stack.nodes[--stack.size];
+    visit(root, data);
+    last = root;
+    root = root->right;
+  }
+  free(stack.nodes);
+  if (root == NULL)
+    return;
+
+  root = snapshot;
+  if (last != NULL)
+    root = pbst_successor(snapshot, last->key);
+  else
+    while (root->left != NULL)
+      root = root->left;
+  for (; root != NULL; root = pbst_successor(snapshot, root->key))
+    visit(root, data);
+}
@@ -0,0 +1,46 @@
+/*
+ * Hlavičkový soubor pro perzistentní binární vyhledávací strom.
+ */
+
+#ifndef IAL_BTREE_PBST_H
+#define IAL_BTREE_PBST_H
+
+#include "../btree.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Obal hodnoty sdílený všemi verzemi uzlu
+typedef struct pbst_value {
+  atomic_int refs;            // počet uzlů odkazujících na hodnotu
+  bst_node_content_t content; // hodnota
+} pbst_value_t;
+
+// Uzel stromu; po zveřejnění se už nikdy nemění
+typedef struct pbst_node {
+  int key;                    // klíč
+  atomic_int refs;            // počet odkazů (rodiče, kořeny verzí)
+  pbst_value_t *value;        // hodnota
+  struct pbst_node *left;     // levý potomek
+  struct pbst_node *right;    // pravý potomek
+} pbst_node_t;
+
+// Strom — ukazatel na kořen aktuální verze
+typedef struct pbst {
+  _Atomic(pbst_node_t *) root; // kořen aktuální verze
+  atomic_int acquiring;        // čtenáři právě získávající kořen
+  pthread_mutex_t writer;      // zápisy se řadí za sebou
+} pbst_t;
+
+void pbst_init(pbst_t *tree);
+void pbst_insert(pbst_t *tree, int key, bst_node_content_t value);
+void pbst_delete(pbst_t *tree, int key);
+void pbst_dispose(pbst_t *tree);
+
+pbst_node_t *pbst_acquire(pbst_t *tree);
+void pbst_release(pbst_node_t *root);
+
+bool pbst_search(pbst_node_t *root, int key, bst_node_content_t **value);
+void pbst_inorder(pbst_node_t *root, void (*visit)(pbst_node_t *, void *),
+                  void *data);
+
+#endif
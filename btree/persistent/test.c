@@ -0,0 +1,161 @@
+#include "pbst.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+const int base_data_count = 15;
+const char base_keys[] = {'H', 'D', 'L', 'B', 'F', 'J', 'N', 'A',
+                          'C', 'E', 'G', 'I', 'K', 'M', 'O'};
+const int base_values[] = {8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7, 9, 11, 13, 16};
+
+void init_test() {
+  printf("Persistent Binary Search Tree - testing script\n");
+  printf("----------------------------------------------\n");
+  printf("\n");
+}
+
+TEST(test_tree_init, "Initialize the tree")
+pbst_print_tree(atomic_load(&test_tree.root));
+ENDTEST
+
+TEST(test_tree_insert_many, "Insert many values")
+pbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+pbst_print_tree(atomic_load(&test_tree.root));
+ENDTEST
+
+TEST(test_tree_search, "Search in a snapshot (A, X)")
+pbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+pbst_node_t *snapshot = pbst_acquire(&test_tree);
+bst_node_content_t *result = NULL;
+pbst_search(snapshot, 'A', &result);
+pbst_print_search_result(result);
+result = NULL;
+pbst_search(snapshot, 'X', &result);
+pbst_print_search_result(result);
+pbst_release(snapshot);
+ENDTEST
+
+TEST(test_snapshot_isolation, "Snapshot keeps its version across inserts")
+pbst_insert_many(&test_tree, base_keys, base_values, 7);
+pbst_node_t *snapshot = pbst_acquire(&test_tree);
+pbst_insert(&test_tree, 'Z', create_integer_content(26));
+pbst_insert(&test_tree, 'N', create_integer_content(40));
+printf("Snapshot:\n");
+pbst_print_items(snapshot);
+printf("Current:\n");
+pbst_node_t *current = pbst_acquire(&test_tree);
+pbst_print_items(current);
+printf("Shared left subtree: %s\n",
+       snapshot->left == current->left ? "yes" : "no");
+pbst_release(current);
+pbst_release(snapshot);
+ENDTEST
+
+TEST(test_snapshot_delete, "Snapshot keeps deleted nodes (D, L, A)")
+pbst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+pbst_node_t *snapshot = pbst_acquire(&test_tree);
+pbst_delete(&test_tree, 'D');
+pbst_delete(&test_tree, 'L');
+pbst_delete(&test_tree, 'A');
+pbst_delete(&test_tree, 'X');
+pbst_print_tree(atomic_load(&test_tree.root));
+pbst_print_items(snapshot);
+pbst_release(snapshot);
+ENDTEST
+
+TEST(test_delete_root, "Delete the root until the tree is empty")
+pbst_insert_many(&test_tree, base_keys, base_values, 3);
+pbst_delete(&test_tree, 'H');
+pbst_print_tree(atomic_load(&test_tree.root));
+pbst_delete(&test_tree, 'D');
+pbst_delete(&test_tree, 'L');
+pbst_print_tree(atomic_load(&test_tree.root));
+ENDTEST
+
+TEST(test_snapshot_outlives_tree, "Snapshot outlives the disposed tree")
+pbst_insert_many(&test_tree, base_keys, base_values, 5);
+pbst_node_t *snapshot = pbst_acquire(&test_tree);
+pbst_dispose(&test_tree);
+pbst_print_tree(atomic_load(&test_tree.root));
+pbst_print_items(snapshot);
+pbst_release(snapshot);
+ENDTEST
+
+typedef struct reader_state {
+  pbst_t *tree;
+  int rounds;
+  int errors;
+} reader_state_t;
+
+typedef struct order_check {
+  int previous;
+  int count;
+  int errors;
+} order_check_t;
+
+static void check_order(pbst_node_t *node, void *data) {
+  order_check_t *check = data;
+  if (node->key <= check->previous ||
+      *(int *)node->value->content.value != node->key)
+    check->errors++;
+  check->previous = node->key;
+  check->count++;
+}
+
+/*
+ * Čtenář: každý snímek musí být seřazený, hodnoty odpovídat klíčům a
+ * sudé klíče (zapisovatel je nemaže) musí být vždy přítomné.
+ */
+static void *reader(void *arg) {
+  reader_state_t *state = arg;
+  for (int i = 0; i < state->rounds; i++) {
+    pbst_node_t *snapshot = pbst_acquire(state->tree);
+    order_check_t check = {-1, 0, 0};
+    pbst_inorder(snapshot, check_order, &check);
+    for (int key = 0; key < 64; key += 2) {
+      bst_node_content_t *value;
+      if (!pbst_search(snapshot, key, &value))
+        check.errors++;
+    }
+    state->errors += check.errors;
+    pbst_release(snapshot);
+  }
+  return NULL;
+}
+
+TEST(test_concurrent_readers, "Readers see consistent snapshots during writes")
+for (int key = 0; key < 64; key += 2)
+  pbst_insert(&test_tree, key, create_integer_content(key));
+const int reader_count = 4;
+pthread_t threads[4];
+reader_state_t states[4];
+for (int i = 0; i < reader_count; i++) {
+  states[i] = (reader_state_t){&test_tree, 2000, 0};
+  pthread_create(&threads[i], NULL, reader, &states[i]);
+}
+for (int round = 0; round < 2000; round++) {
+  int key = (round * 37 % 32) * 2 + 1;
+  pbst_insert(&test_tree, key, create_integer_content(key));
+  pbst_insert(&test_tree, key - 1, create_integer_content(key - 1));
+  pbst_delete(&test_tree, (round * 11 % 32) * 2 + 1);
+}
+int errors = 0;
+for (int i = 0; i < reader_count; i++) {
+  pthread_join(threads[i], NULL);
+  errors += states[i].errors;
+}
+printf("Snapshot errors: %d\n", errors);
+ENDTEST
+
+int main(int argc, char *argv[]) {
+  init_test();
+
+  test_tree_init();
+  test_tree_insert_many();
+  test_tree_search();
+  test_snapshot_isolation();
+  test_snapshot_delete();
+  test_delete_root();
+  test_snapshot_outlives_tree();
+  test_concurrent_readers();
+}
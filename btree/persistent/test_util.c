@@ -0,0 +1,89 @@
+#include "test_util.h"
+#include "../dump.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void pbst_print_content(bst_node_content_t *content) {
+  if (content == NULL) {
+    printf("NULL");
+  } else if (content->type == INTEGER) {
+    printf("%d", *(int *)content->value);
+  } else {
+    printf("Unknown");
+  }
+}
+
+void pbst_print_node(pbst_node_t *node) {
+  printf("[%c,", node->key);
+  pbst_print_content(&node->value->content);
+  printf("]");
+}
+
+static const void *pbst_shape_left(const void *node, void *data) {
+  (void)data;
+  return ((const pbst_node_t *)node)->left;
+}
+
+static const void *pbst_shape_right(const void *node, void *data) {
+  (void)data;
+  return ((const pbst_node_t *)node)->right;
+}
+
+static void pbst_shape_node(dump_buffer_t *dump, const void *node, void *data) {
+  const pbst_node_t *tree_node = node;
+  (void)data;
+  dump_char(dump, '[');
+  dump_char(dump, (char)tree_node->key);
+  dump_char(dump, ',');
+  bst_dump_content(dump, &tree_node->value->content);
+  dump_char(dump, ']');
+}
+
+void pbst_print_tree(pbst_node_t *tree) {
+  dump_buffer_t dump;
+  dump_init(&dump, stdout);
+  dump_text(&dump, "Binary tree structure:\n\n");
+  if (tree != NULL) {
+    dump_shape_t shape = {pbst_shape_left, pbst_shape_right,
+                         pbst_shape_node, NULL};
+    dump_shape(&dump, tree, &shape);
+  } else {
+    dump_text(&dump, "Tree is empty\n");
+  }
+  dump_char(&dump, '\n');
+  dump_flush(&dump);
+  dump_dispose(&dump);
+}
+
+void pbst_print_search_result(bst_node_content_t *content) {
+  printf("Search result: ");
+  pbst_print_content(content);
+  printf("\n");
+}
+
+static void pbst_print_visit(pbst_node_t *node, void *data) {
+  (void)data;
+  pbst_print_node(node);
+}
+
+void pbst_print_items(pbst_node_t *tree) {
+  printf("Traversed items:\n");
+  pbst_inorder(tree, pbst_print_visit, NULL);
+  printf("\n");
+}
+
+bst_node_content_t create_integer_content(int value) {
+  bst_node_content_t result = {
+    .type = INTEGER,
+    .value = malloc(sizeof(int))
+  };
+  *((int *)(result.value)) = value;
+  return result;
+}
+
+void pbst_insert_many(pbst_t *tree, const char keys[], const int values[],
+                      int count) {
+  for (int i = 0; i < count; i++) {
+    pbst_insert(tree, keys[i], create_integer_content(values[i]));
+  }
+}
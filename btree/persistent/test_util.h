@@ -0,0 +1,25 @@
+#ifndef IAL_BTREE_PBST_TEST_UTIL_H
+#define IAL_BTREE_PBST_TEST_UTIL_H
+
+#include "pbst.h"
+#include <stdio.h>
+
+#define TEST(NAME, DESCRIPTION)                                                \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    pbst_t test_tree;                                                          \
+    pbst_init(&test_tree);
+
+#define ENDTEST                                                                \
+  printf("\n");                                                                \
+  pbst_dispose(&test_tree);                                                    \
+  pthread_mutex_destroy(&test_tree.writer);                                    \
+  }
+
+void pbst_print_tree(pbst_node_t *tree);
+void pbst_print_search_result(bst_node_content_t *content);
+void pbst_print_items(pbst_node_t *tree);
+bst_node_content_t create_integer_content(int value);
+void pbst_insert_many(pbst_t *tree, const char keys[], const int values[],
+                      int count);
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Fond vláken s kradením práce (work stealing).
+ *
+ * Každé vlákno má vlastní frontu úloh. Úlohy vložené z vlákna fondu
+ * jdou do jeho fronty a vlákno je odebírá od konce (LIFO), což drží
+ * pohromadě práci nad sousedními podstromy. Vlákno bez práce krade
+ * nejstarší úlohu z fronty jiného vlákna (FIFO), typicky tu největší.
+ * Úlohy vložené zvenčí se rozdělují do front postupně.
+ */
+
+#include "pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct bst_pool_job {
+  bst_task_t task;
+  void *arg;
+} bst_pool_job_t;
+
+typedef struct bst_pool_queue {
+  pthread_mutex_t lock;
+  bst_pool_job_t *jobs;
+  int head;     // index nejstarší úlohy (krade se odsud)
+  int tail;     // index za nejnovější úlohou (vlastník bere odsud)
+  int capacity;
+} bst_pool_queue_t;
+
+struct bst_pool {
+  int size;            // počet vláken a front
+  int started;         // počet úspěšně spuštěných vláken
+  pthread_t *threads;
+  bst_pool_queue_t *queues;
+  atomic_int queued;   // úlohy čekající ve frontách
+  atomic_int pending;  // vložené a dosud nedokončené úlohy
+  atomic_uint next;    // fronta pro další úlohu vloženou zvenčí
+  bool stopping;
+  pthread_mutex_t lock;
+  pthread_cond_t work; // signalizace nové práce nebo ukončení
+  pthread_cond_t idle; // signalizace dokončení všech úloh
+};
+
+// Fond a index vlákna, které kód právě vykonává (mimo fond NULL a -1)
+static _Thread_local bst_pool_t *bst_pool_current = NULL;
+static _Thread_local int bst_pool_worker = -1;
+
+typedef struct bst_pool_start {
+  bst_pool_t *pool;
+  int worker;
+} bst_pool_start_t;
+
+static void bst_pool_push(bst_pool_queue_t *queue, bst_pool_job_t job)
+{
+  pthread_mutex_lock(&queue->lock);
+  if (queue->tail == queue->capacity)
+  {
+    if (queue->head > 0)
+    {
+      // Posun ziveho useku na zaciatok pola
+      for (int i = queue->head; i < queue->tail; i++)
+        queue->jobs[i - queue->head] = queue->jobs[i];
+      queue->tail -= queue->head;
+      queue->head = 0;
+    }
+    if (queue->tail == queue->capacity)
+    {
+      queue->capacity = queue->capacity * 2 + 16;
+      queue->jobs = realloc(queue->jobs,
+                            queue->capacity * sizeof(bst_pool_job_t));
+    }
+  }
+  queue->jobs[queue->tail++] = job;
+  pthread_mutex_unlock(&queue->lock);
+}
+
+static bool bst_pool_take(bst_pool_queue_t *queue, bool steal,
+                          bst_pool_job_t *job)
+{
+  bool found = false;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->head < queue->tail)
+  {
+    *job = steal ? queue->jobs[queue->head++] : queue->jobs[--queue->tail];
+    if (queue->head == queue->tail)
+      queue->head = queue->tail = 0;
+    found = true;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return found;
+}
+
+/*
+ * Nalezení další úlohy: nejdřív z vlastní fronty, pak krádež z ostatních.
+ */
+static bool bst_pool_find(bst_pool_t *pool, int worker, bst_pool_job_t *job)
+{
+  if (bst_pool_take(&pool->queues[worker], false, job))
+    return true;
+  for (int i = 1; i < pool->size; i++)
+  {
+    if (bst_pool_take(&pool->queues[(worker + i) % pool->size], true, job))
+      return true;
+  }
+  return false;
+}
+
+static void *bst_pool_main(void *arg)
+{
+  bst_pool_start_t *start = arg;
+  bst_pool_t *pool = start->pool;
+  int worker = start->worker;
+  free(start);
+
+  bst_pool_current = pool;
+  bst_pool_worker = worker;
+
+  while (true)
+  {
+    bst_pool_job_t job;
+    if (bst_pool_find(pool, worker, &job))
+    {
+      atomic_fetch_sub(&pool->queued, 1);
+      job.task(job.arg, worker);
+      if (atomic_fetch_sub(&pool->pending, 1) == 1)
+      {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+      }
+      continue;
+    }
+
+    // Bez prace: uspanie, kym nepribudne uloha alebo sa fond neukonci
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopping && atomic_load(&pool->queued) == 0)
+      pthread_cond_wait(&pool->work, &pool->lock);
+    bool stopping = pool->stopping && atomic_load(&pool->queued) == 0;
+    pthread_mutex_unlock(&pool->lock);
+    if (stopping)
+      break;
+  }
+  return NULL;
+}
+
+/*
+ * Vytvoření fondu s daným počtem vláken (alespoň jedním).
+ *
+ * Vrací NULL, pokud se nepodaří alokovat paměť nebo spustit vlákna.
+ */
+bst_pool_t *bst_pool_create(int threads)
+{
+  if (threads < 1)
+    threads = 1;
+
+  bst_pool_t *pool = calloc(1, sizeof(bst_pool_t));
+  if (pool == NULL)
+    return NULL;
+  pool->threads = calloc(threads, sizeof(pthread_t));
+  pool->queues = calloc(threads, sizeof(bst_pool_queue_t));
+  if (pool->threads == NULL || pool->queues == NULL)
+  {
+    free(pool->threads);
+    free(pool->queues);
+    free(pool);
+    return NULL;
+  }
+
+  atomic_init(&pool->queued, 0);
+  atomic_init(&pool->pending, 0);
+  atomic_init(&pool->next, 0);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_cond_init(&pool->idle, NULL);
+  for (int i = 0; i < threads; i++)
+    pthread_mutex_init(&pool->queues[i].lock, NULL);
+
+  pool->size = threads;
+  for (int i = 0; i < threads; i++)
+  {
+    bst_pool_start_t *start = malloc(sizeof(bst_pool_start_t));
+    if (start == NULL)
+    {
+      bst_pool_destroy(pool);
+      return NULL;
+    }
+    start->pool = pool;
+    start->worker = i;
+    if (pthread_create(&pool->threads[i], NULL, bst_pool_main, start) != 0)
+    {
+      free(start);
+      bst_pool_destroy(pool);
+      return NULL;
+    }
+    pool->started++;
+  }
+  return pool;
+}
+
+int bst_pool_size(bst_pool_t *pool)
+{
+  return pool->size;
+}
+
+/*
+ * Vložení úlohy do fondu.
+ *
+ * Volá-li funkci vlákno téhož fondu, úloha jde do jeho vlastní fronty;
+ * jinak se fronty střídají.
+ */
+void bst_pool_submit(bst_pool_t *pool, bst_task_t task, void *arg)
+{
+  int worker = bst_pool_current == pool
+                   ? bst_pool_worker
+                   : (int)(atomic_fetch_add(&pool->next, 1) % pool->size);
+
+  atomic_fetch_add(&pool->pending, 1);
+  atomic_fetch_add(&pool->queued, 1);
+  bst_pool_push(&pool->queues[worker], (bst_pool_job_t){task, arg});
+
+  pthread_mutex_lock(&pool->lock);
+  pthread_cond_signal(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Čekání na dokončení všech vložených úloh včetně úloh, které během běhu
+ * vložily jiné úlohy. Nesmí se volat z vlákna fondu.
+ */
+void bst_pool_wait(bst_pool_t *pool)
+{
+  pthread_mutex_lock(&pool->lock);
+  while (atomic_load(&pool->pending) != 0)
+    pthread_cond_wait(&pool->idle, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Dokončení zbývajících úloh, ukončení vláken a uvolnění fondu.
+ */
+void bst_pool_destroy(bst_pool_t *pool)
+{
+  if (pool == NULL)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = true;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int i = 0; i < pool->started; i++)
+    pthread_join(pool->threads[i], NULL);
+
+  for (int i = 0; i < pool->size; i++)
+  {
+    pthread_mutex_destroy(&pool->queues[i].lock);
+    free(pool->queues[i].jobs);
+  }
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->work);
+  pthread_cond_destroy(&pool->idle);
+  free(pool->threads);
+  free(pool->queues);
+  free(pool);
+}
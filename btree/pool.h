@@ -0,0 +1,19 @@
+/*
+ * Hlavičkový soubor pro fond vláken s kradením práce.
+ */
+
+#ifndef IAL_BTREE_POOL_H
+#define IAL_BTREE_POOL_H
+
+// Úloha; worker je index vlákna fondu, které úlohu právě vykonává
+typedef void (*bst_task_t)(void *arg, int worker);
+
+typedef struct bst_pool bst_pool_t;
+
+bst_pool_t *bst_pool_create(int threads);
+int bst_pool_size(bst_pool_t *pool);
+void bst_pool_submit(bst_pool_t *pool, bst_task_t task, void *arg);
+void bst_pool_wait(bst_pool_t *pool);
+void bst_pool_destroy(bst_pool_t *pool);
+
+#endif
@@ -33,6 +33,15 @@ void bst_init(bst_node_t **tree)
  * Funkci implementujte rekurzivně bez použité vlastních pomocných funkcí.
  */
 bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
+{
+  return bst_search_key(tree, key, value, NULL);
+}
+
+/*
+ * Vyhledání uzlu podle klíče plné šířky s danou porovnávací funkcí.
+ */
+bool bst_search_key(bst_node_t *tree, bst_key_t key,
+                    bst_node_content_t **value, bst_compare_t compare)
 {
   if (tree == NULL)
   {
@@ -41,7 +50,10 @@ bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
   }
   else
   {
-    if (tree->key == key)
+    BST_COUNT_VISIT();
+    BST_COUNT_COMPARISONS(1);
+    int cmp = bst_compare(compare, key, tree->key);
+    if (cmp == 0)
     {
       // Nalezli jsme uzel s požadovaným klíčem
       (*value) = &tree->content;
@@ -49,98 +61,138 @@ bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
     }
     else
     {
-      if (key < tree->key)
+      BST_COUNT_COMPARISONS(1);
+      if (cmp < 0)
       {
         // Hledaný klíč je menší než aktuální, pokračujeme vlevo
-        return bst_search(tree->left, key, value);
+        return bst_search_key(tree->left, key, value, compare);
       }
       else
       {
         // Hledaný klíč je větší než aktuální, pokračujeme vpravo
-        return bst_search(tree->right, key, value);
+        return bst_search_key(tree->right, key, value, compare);
       }
     }
   }
 }
 
 /*
- * Vložení uzlu do stromu.
- *
- * Pokud uzel se zadaným klíče už ve stromu existuje, nahraďte jeho hodnotu.
- * Jinak vložte nový listový uzel.
- *
- * Výsledný strom musí splňovat podmínku vyhledávacího stromu — levý podstrom
- * uzlu obsahuje jenom menší klíče, pravý větší.
- *
- * Funkci implementujte rekurzivně bez použití vlastních pomocných funkcí.
+ * Rekurzivní vložení uzlu; vrací hloubku nového uzlu vzhledem k tree, nebo
+ * -1, pokud se jen nahradila hodnota existujícího uzlu.
  */
-void bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
+static int bst_insert_depth(bst_node_t **tree, bst_key_t key,
+                            bst_node_content_t value, bst_compare_t compare,
+                            const struct allocator *allocator)
 {
   if ((*tree) == NULL)
   {
     // Pokud strom je prázdný, vytvoříme nový uzel
-    (*tree) = (bst_node_t *)malloc(sizeof(bst_node_t));
-    if (*tree != NULL)
+    (*tree) = bst_alloc_node(allocator);
+    if (*tree == NULL)
     {
-      // Inicializujeme nový uzel s daným klíčem a hodnotou
-      (*tree)->key = key;
-      (*tree)->content.type = value.type;
-      (*tree)->content.value = value.value;
-      (*tree)->left = NULL;
-      (*tree)->right = NULL;
+      bst_free(value.value);
+      fprintf(stderr, "Memory allocation failed for key %lld\n",
+              (long long)key);
+      return -1;
     }
-    return;
+    // Inicializujeme nový uzel s daným klíčem a hodnotou
+    (*tree)->key = key;
+    (*tree)->content.type = value.type;
+    (*tree)->content.value = value.value;
+    (*tree)->left = NULL;
+    (*tree)->right = NULL;
+    bst_update_size(*tree);
+    return 0;
+  }
+
+  BST_COUNT_VISIT();
+  BST_COUNT_COMPARISONS(1);
+  int depth;
+  int cmp = bst_compare(compare, key, (*tree)->key);
+  if (cmp < 0)
+  {
+    // Klíč je menší než aktuální, pokračujeme vlevo
+    depth = bst_insert_depth(&(*tree)->left, key, value, compare, allocator);
+  }
+  else if (BST_COUNT_COMPARISONS(1), cmp > 0)
+  {
+    // Klíč je větší než aktuální, pokračujeme vpravo
+    depth = bst_insert_depth(&(*tree)->right, key, value, compare, allocator);
   }
   else
   {
-    if (key < (*tree)->key)
-    {
-      // Klíč je menší než aktuální, pokračujeme vlevo
-      bst_insert(&(*tree)->left, key, value);
-    }
-    else
+    // Klíč již existuje, nahrazujeme jeho hodnotu
+    if ((*tree)->content.value != NULL)
     {
-      if (key > (*tree)->key)
-      {
-        // Klíč je větší než aktuální, pokračujeme vpravo
-        bst_insert(&(*tree)->right, key, value);
-      }
-      else
-      {
-        // Klíč již existuje, nahrazujeme jeho hodnotu
-        if ((*tree)->content.value != NULL)
-        {
-          // Uvolníme předchozí hodnotu, pokud existuje
-          free((*tree)->content.value);
-        }
-        // Aktualizujeme typ a hodnotu
-        (*tree)->content.type = value.type;
-        (*tree)->content.value = value.value;
-      }
+      // Uvolníme předchozí hodnotu, pokud existuje
+      bst_free((*tree)->content.value);
     }
+    // Aktualizujeme typ a hodnotu
+    (*tree)->content.type = value.type;
+    (*tree)->content.value = value.value;
+    return -1;
   }
+
+  bst_update_size(*tree);
+  return depth < 0 ? depth : depth + 1;
 }
 
 /*
- * Pomocná funkce která nahradí uzel nejpravějším potomkem.
- *
- * Klíč a hodnota uzlu target budou nahrazeny klíčem a hodnotou nejpravějšího
- * uzlu podstromu tree. Nejpravější potomek bude odstraněný. Funkce korektně
- * uvolní všechny alokované zdroje odstraněného uzlu.
- *
- * Funkce předpokládá, že hodnota tree není NULL.
+ * Vložení uzlu do stromu.
  *
- * Tato pomocná funkce bude využitá při implementaci funkce bst_delete.
+ * Pokud uzel se zadaným klíče už ve stromu existuje, nahraďte jeho hodnotu.
+ * Jinak vložte nový listový uzel.
  *
- * Funkci implementujte rekurzivně bez použití vlastních pomocných funkcí.
+ * Výsledný strom musí splňovat podmínku vyhledávacího stromu — levý podstrom
+ * uzlu obsahuje jenom menší klíče, pravý větší.
  */
-void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
+void bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
+{
+  bst_insert_key(tree, key, value, NULL);
+}
+
+/*
+ * Vložení uzlu s klíčem plné šířky s danou porovnávací funkcí.
+ */
+void bst_insert_key(bst_node_t **tree, bst_key_t key, bst_node_content_t value,
+                    bst_compare_t compare)
+{
+  bst_insert_key_with(tree, key, value, compare, NULL);
+}
+
+/*
+ * Vložení uzlu alokovaného alokátorem allocator.
+ */
+void bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_node_content_t value, bst_compare_t compare,
+                         const struct allocator *allocator)
+{
+  bst_insert_key_rebalance(tree, key, value, compare, allocator, NULL);
+}
+
+/*
+ * Vložení s pravidlem automatického vyvažování policy (NULL = bez něj).
+ */
+void bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                              bst_node_content_t value, bst_compare_t compare,
+                              const struct allocator *allocator,
+                              bst_rebalance_t *policy)
+{
+  int depth = bst_insert_depth(tree, key, value, compare, allocator);
+  bst_rebalance_if_deep(tree, key, depth, compare, policy);
+}
+
+/*
+ * Nahrazení nejpravějším potomkem; uzel se uvolní alokátorem allocator.
+ */
+void bst_replace_by_rightmost_with(bst_node_t *target, bst_node_t **tree,
+                                   const struct allocator *allocator)
 {
   // Base case: Pokud není pravý potomek, aktuální uzel je nejpravější
   if ((*tree)->right == NULL)
   {
     // Uvolníme obsah cílového uzlu
-    free(target->content.value);
+    bst_free(target->content.value);
 
     // Přeneseme obsah aktuálního (nejpravějšího) uzlu do cílového
     target->content = (*tree)->content;
@@ -153,43 +205,59 @@ void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
     *tree = (*tree)->left;
 
     // Uvolníme původní nejpravější uzel
-    free(temp);
+    bst_free_node(allocator, temp);
     return;
   }
 
   // Rekurzivně pokračujeme na pravém podstromu, abychom našli nejpravější uzel
-  bst_replace_by_rightmost(target, &(*tree)->right);
+  bst_replace_by_rightmost_with(target, &(*tree)->right, allocator);
+
+  // Pravý podstrom přišel o jeden uzel
+  bst_update_size(*tree);
 }
 
 /*
- * Odstranění uzlu ze stromu.
+ * Pomocná funkce která nahradí uzel nejpravějším potomkem.
  *
- * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá.
- * Pokud má odstraněný uzel jeden podstrom, zdědí ho rodič odstraněného uzlu.
- * Pokud má odstraněný uzel oba podstromy, je nahrazený nejpravějším uzlem
- * levého podstromu. Nejpravější uzel nemusí být listem.
+ * Klíč a hodnota uzlu target budou nahrazeny klíčem a hodnotou nejpravějšího
+ * uzlu podstromu tree. Nejpravější potomek bude odstraněný. Funkce korektně
+ * uvolní všechny alokované zdroje odstraněného uzlu.
  *
- * Funkce korektně uvolní všechny alokované zdroje odstraněného uzlu.
+ * Funkce předpokládá, že hodnota tree není NULL.
  *
- * Funkci implementujte rekurzivně pomocí bst_replace_by_rightmost a bez
- * použití vlastních pomocných funkcí.
+ * Tato pomocná funkce bude využitá při implementaci funkce bst_delete.
+ *
+ * Funkci implementujte rekurzivně bez použití vlastních pomocných funkcí.
  */
-void bst_delete(bst_node_t **tree, char key)
+void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
+{
+  bst_replace_by_rightmost_with(target, tree, NULL);
+}
+
+/*
+ * Odstranění uzlu, který se uvolní alokátorem allocator.
+ */
+void bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_compare_t compare,
+                         const struct allocator *allocator)
 {
   // Pokud strom není prázdný, pokračujeme hledáním uzlu k odstranění
   if (*tree != NULL)
   {
     bst_node_t *current = *tree;
+    int cmp = bst_compare(compare, key, current->key);
 
-    if (key < current->key)
+    if (cmp < 0)
     {
       // Klíč k odstranění je menší, hledáme v levém podstromu
-      bst_delete(&current->left, key);
+      bst_delete_key_with(&current->left, key, compare, allocator);
+      bst_update_size(current);
     }
-    else if (key > current->key)
+    else if (cmp > 0)
     {
       // Klíč k odstranění je větší, hledáme v pravém podstromu
-      bst_delete(&current->right, key);
+      bst_delete_key_with(&current->right, key, compare, allocator);
+      bst_update_size(current);
     }
     else
     {
@@ -197,27 +265,54 @@ void bst_delete(bst_node_t **tree, char key)
       if (current->left == NULL && current->right == NULL)
       {
         // Uzel nemá žádné potomky, můžeme jej jednoduše odstranit
-        free(current->content.value); // Uvolníme obsah
-        free(current);                // Uvolníme samotný uzel
+        bst_free(current->content.value);     // Uvolníme obsah
+        bst_free_node(allocator, current);    // Uvolníme samotný uzel
         *tree = NULL;                 // Nastavíme ukazatel na NULL
       }
       else if (current->left != NULL && current->right != NULL)
       {
         // Uzel má oba podstromy, najdeme jeho nástupce
-        bst_replace_by_rightmost(current, &current->left);
+        bst_replace_by_rightmost_with(current, &current->left, allocator);
+        bst_update_size(current);
       }
       else
       {
         // Uzel má pouze jeden podstrom
         bst_node_t *child = (current->left != NULL) ? current->left : current->right;
-        free(current->content.value); // Uvolníme obsah
-        free(current);                // Uvolníme samotný uzel
+        bst_free(current->content.value);     // Uvolníme obsah
+        bst_free_node(allocator, current);    // Uvolníme samotný uzel
         *tree = child;                // Předáme ukazatel na podstrom
       }
     }
   }
 }
 
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá.
+ * Pokud má odstraněný uzel jeden podstrom, zdědí ho rodič odstraněného uzlu.
+ * Pokud má odstraněný uzel oba podstromy, je nahrazený nejpravějším uzlem
+ * levého podstromu. Nejpravější uzel nemusí být listem.
+ *
+ * Funkce korektně uvolní všechny alokované zdroje odstraněného uzlu.
+ *
+ * Funkci implementujte rekurzivně pomocí bst_replace_by_rightmost a bez
+ * použití vlastních pomocných funkcí.
+ */
+void bst_delete(bst_node_t **tree, char key)
+{
+  bst_delete_key(tree, key, NULL);
+}
+
+/*
+ * Odstranění uzlu s klíčem plné šířky s danou porovnávací funkcí.
+ */
+void bst_delete_key(bst_node_t **tree, bst_key_t key, bst_compare_t compare)
+{
+  bst_delete_key_with(tree, key, compare, NULL);
+}
+
 /*
  * Zrušení celého stromu.
  *
@@ -228,21 +323,29 @@ void bst_delete(bst_node_t **tree, char key)
  * Funkci implementujte rekurzivně bez použití vlastních pomocných funkcí.
  */
 void bst_dispose(bst_node_t **tree)
+{
+  bst_dispose_with(tree, NULL);
+}
+
+/*
+ * Zrušení stromu, jehož uzly patří alokátoru allocator.
+ */
+void bst_dispose_with(bst_node_t **tree, const struct allocator *allocator)
 {
   if (*tree != NULL)
   {
     // Rekurzivně zrušíme levý podstrom
-    bst_dispose(&(*tree)->left);
+    bst_dispose_with(&(*tree)->left, allocator);
 
     // Rekurzivně zrušíme pravý podstrom
-    bst_dispose(&(*tree)->right);
+    bst_dispose_with(&(*tree)->right, allocator);
 
     // Uvolníme obsah aktuálního uzlu
-    free((*tree)->content.value);
+    bst_free((*tree)->content.value);
     (*tree)->content.value = NULL;
 
     // Uvolníme samotný uzel
-    free(*tree);
+    bst_free_node(allocator, *tree);
     *tree = NULL; // Nastavíme ukazateľ na NULL
   }
 }
@@ -311,4 +414,152 @@ void bst_postorder(bst_node_t *tree, bst_items_t *items)
 
   // Zpracujeme aktuální uzel po podstromech
   bst_add_node_to_items(tree, items);
-}
\ No newline at end of file
+}
+
+
+/*
+ * Průchod uzly s klíči z uzavřeného intervalu <lo, hi>.
+ *
+ * Pro každý takový uzel zavolá ve vzestupném pořadí klíčů funkci visit.
+ * Do podstromů, které s intervalem nemohou mít průnik, nesestupuje, takže
+ * složitost je úměrná výšce stromu a počtu vrácených uzlů.
+ */
+void bst_range(bst_node_t *tree, char lo, char hi, bst_visit_t visit,
+               void *data)
+{
+  if (tree == NULL)
+    return;
+
+  // Levý podstrom obsahuje menší klíče, má smysl jen pokud lo < key
+  if (lo < tree->key)
+    bst_range(tree->left, lo, hi, visit, data);
+
+  if (lo <= tree->key && tree->key <= hi)
+    visit(tree, data);
+
+  // Pravý podstrom obsahuje větší klíče, má smysl jen pokud key < hi
+  if (tree->key < hi)
+    bst_range(tree->right, lo, hi, visit, data);
+}
+
+/*
+ * Uzel s největším klíčem menším nebo rovným key, případně NULL.
+ */
+bst_node_t *bst_floor(bst_node_t *tree, char key)
+{
+  if (tree == NULL)
+    return NULL;
+  if (tree->key == key)
+    return tree;
+  if (key < tree->key)
+    return bst_floor(tree->left, key);
+
+  // Aktuální uzel vyhovuje, v pravém podstromu může být bližší
+  bst_node_t *closer = bst_floor(tree->right, key);
+  return closer != NULL ? closer : tree;
+}
+
+/*
+ * Uzel s nejmenším klíčem větším nebo rovným key, případně NULL.
+ */
+bst_node_t *bst_ceil(bst_node_t *tree, char key)
+{
+  if (tree == NULL)
+    return NULL;
+  if (tree->key == key)
+    return tree;
+  if (key > tree->key)
+    return bst_ceil(tree->right, key);
+
+  // Aktuální uzel vyhovuje, v levém podstromu může být bližší
+  bst_node_t *closer = bst_ceil(tree->left, key);
+  return closer != NULL ? closer : tree;
+}
+
+/*
+ * Uzel s největším klíčem ostře menším než key, případně NULL.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+bst_node_t *bst_predecessor(bst_node_t *tree, char key)
+{
+  if (tree == NULL)
+    return NULL;
+  if (key <= tree->key)
+    return bst_predecessor(tree->left, key);
+
+  bst_node_t *closer = bst_predecessor(tree->right, key);
+  return closer != NULL ? closer : tree;
+}
+
+/*
+ * Uzel s nejmenším klíčem ostře větším než key, případně NULL.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+bst_node_t *bst_successor(bst_node_t *tree, char key)
+{
+  if (tree == NULL)
+    return NULL;
+  if (key >= tree->key)
+    return bst_successor(tree->right, key);
+
+  bst_node_t *closer = bst_successor(tree->left, key);
+  return closer != NULL ? closer : tree;
+}
+
+#ifdef BST_ORDER_STATISTICS
+
+/*
+ * Výběr k-tého nejmenšího uzlu (k počítáno od 0).
+ *
+ * Pokud strom obsahuje méně než k+1 uzlů, vrátí NULL. Složitost odpovídá
+ * výšce stromu, protože velikost levého podstromu určuje, kterým směrem
+ * pokračovat.
+ */
+bst_node_t *bst_select(bst_node_t *tree, int k)
+{
+  if (tree == NULL || k < 0)
+    return NULL;
+
+  int left_size = bst_size(tree->left);
+  if (k < left_size)
+    return bst_select(tree->left, k);
+  if (k == left_size)
+    return tree;
+  // Preskočíme levý podstrom i aktuální uzel
+  return bst_select(tree->right, k - left_size - 1);
+}
+
+/*
+ * Pořadí klíče — počet klíčů ve stromu ostře menších než key.
+ *
+ * Klíč sám ve stromu být nemusí.
+ */
+int bst_rank(bst_node_t *tree, char key)
+{
+  if (tree == NULL)
+    return 0;
+
+  if (key <= tree->key)
+    return bst_rank(tree->left, key);
+  // Aktuální uzel i celý jeho levý podstrom jsou menší
+  return bst_size(tree->left) + 1 + bst_rank(tree->right, key);
+}
+
+/*
+ * Počet klíčů z uzavřeného intervalu <lo, hi>.
+ */
+int bst_count_range(bst_node_t *tree, char lo, char hi)
+{
+  if (lo > hi)
+    return 0;
+
+  bst_node_content_t *value;
+  int count = bst_rank(tree, hi) - bst_rank(tree, lo);
+  if (bst_search(tree, hi, &value))
+    count++;
+  return count;
+}
+
+#endif // BST_ORDER_STATISTICS
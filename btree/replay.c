@@ -0,0 +1,231 @@
+/*
+ * Přehrání záznamu volání (trace.h) nad variantou stromu, se kterou je
+ * program přeložen, a nad ../hashtable/hashtable.c.
+ *
+ *   replay [--json] záznam
+ *
+ * Záznam se celý načte a dekóduje předem, hodnoty vkládané do stromu se
+ * připraví před měřením; měří se jen samotné volání. Pro každý druh
+ * operace se vypíše počet, úspěšná hledání, celkový čas a latence
+ * p50/p99/max. Stejný záznam přehraný nad jinou variantou musí dát stejné
+ * počty nalezených klíčů. Operace s vlastním porovnáním a nahrazení stromu
+ * hromadnou operací (TRACE_BST_REPLACE) se nepřehrávají.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "btree.h"
+#include "character.h"
+#include "dump.h"
+#include "trace.h"
+#include "../hashtable/hashtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct replay_stats {
+  long count;
+  long found;                   // úspěšná hledání (bst_search, ht_search, ht_get)
+  uint64_t total;               // součet latencí v ns
+  uint32_t *latencies;
+} replay_stats_t;
+
+static uint64_t replay_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int replay_compare(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Hodnota vkládaná do stromu; postava se jménem v jednom bloku
+static bst_node_content_t replay_content(const trace_op_t *op) {
+  bst_node_content_t content = {NULL, INTEGER};
+  if (op->value_type == TRACE_VALUE_INTEGER) {
+    content.value = malloc(sizeof(int));
+    if (content.value != NULL)
+      *(int *)content.value = (int)op->integer;
+  } else if (op->value_type == TRACE_VALUE_CHARACTER) {
+    size_t length = strlen(op->text) + 1;
+    character_t *character = malloc(sizeof(character_t) + length);
+    if (character != NULL) {
+      character->name = (char *)(character + 1);
+      memcpy(character->name, op->text, length);
+      character->character_class = (character_class_t)op->integer;
+      character->level = op->level;
+    }
+    content.type = CHARACTER_T;
+    content.value = character;
+  }
+  return content;
+}
+
+int main(int argc, char *argv[]) {
+  bool json = argc > 2 && strcmp(argv[1], "--json") == 0;
+  const char *path = argv[argc - 1];
+  trace_t trace;
+  if (argc < 2 || !trace_load(&trace, path)) {
+    fprintf(stderr, "usage: %s [--json] trace\n", argv[0]);
+    return 1;
+  }
+
+  bst_node_t **trees = calloc(trace.handles, sizeof(bst_node_t *));
+  ht_table_t **tables = calloc(trace.handles, sizeof(ht_table_t *));
+  replay_stats_t stats[TRACE_KINDS] = {{0}};
+  for (int kind = 0; kind < TRACE_KINDS; kind++)
+    stats[kind].latencies = malloc(sizeof(uint32_t) * (trace.count + 1));
+  long skipped = 0;
+
+  for (size_t i = 0; i < trace.count; i++) {
+    const trace_op_t *op = &trace.ops[i];
+    if ((op->flags & TRACE_CUSTOM_COMPARE) || op->kind == TRACE_BST_REPLACE) {
+      skipped++;
+      continue;
+    }
+    bst_node_t **tree = &trees[op->handle];
+    ht_table_t *table = NULL;
+    if (op->kind >= TRACE_HT_INIT && op->kind <= TRACE_HT_DELETE_ALL) {
+      if (tables[op->handle] == NULL)
+        tables[op->handle] = calloc(1, sizeof(ht_table_t));
+      table = tables[op->handle];
+    }
+    char *key = (char *)op->text;
+    bst_node_content_t content = {NULL, INTEGER};
+    bst_node_content_t *value;
+    if (op->kind == TRACE_BST_INSERT)
+      content = replay_content(op);
+    if (op->kind == TRACE_HT_INIT && op->integer > 0 &&
+        op->integer <= MAX_HT_SIZE)
+      HT_SIZE = (int)op->integer;
+
+    bool found = false;
+    uint64_t start = replay_now();
+    switch (op->kind) {
+    case TRACE_BST_INIT:
+      bst_init(tree);
+      break;
+    case TRACE_BST_INSERT:
+      bst_insert_key(tree, op->key, content, NULL);
+      break;
+    case TRACE_BST_SEARCH:
+#ifdef SPLAY
+      found = bst_search_splay(tree, op->key, &value, NULL);
+#else
+      found = bst_search_key(*tree, op->key, &value, NULL);
+#endif // SPLAY
+      break;
+    case TRACE_BST_DELETE:
+      bst_delete_key(tree, op->key, NULL);
+      break;
+    case TRACE_BST_DISPOSE:
+      bst_dispose(tree);
+      break;
+    case TRACE_HT_INIT:
+      ht_init(table);
+      break;
+    case TRACE_HT_SEARCH:
+      found = ht_search(table, key) != NULL;
+      break;
+    case TRACE_HT_INSERT:
+      ht_insert(table, key, (ht_value_t)op->number);
+      break;
+    case TRACE_HT_GET:
+      found = ht_get(table, key) != NULL;
+      break;
+    case TRACE_HT_INCREMENT:
+      ht_increment(table, key, (ht_value_t)op->number);
+      break;
+    case TRACE_HT_DELETE:
+      ht_delete(table, key);
+      break;
+    case TRACE_HT_DELETE_ALL:
+      ht_delete_all(table);
+      break;
+    }
+    uint64_t latency = replay_now() - start;
+
+    replay_stats_t *kind = &stats[op->kind];
+    kind->latencies[kind->count++] =
+        latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+    kind->total += latency;
+    kind->found += found;
+  }
+
+  dump_buffer_t out;
+  dump_init(&out, stdout);
+  if (json) {
+    dump_text(&out, "{\"trace\":");
+    dump_json_string(&out, path);
+    dump_text(&out, ",\"ops\":");
+    dump_integer(&out, (long long)trace.count);
+    dump_text(&out, ",\"skipped\":");
+    dump_integer(&out, skipped);
+    dump_text(&out, ",\"kinds\":[");
+  } else {
+    printf("Replay of %s: %zu operations, %ld skipped (custom comparison or "
+           "replaced tree)\n",
+           path, trace.count, skipped);
+  }
+  bool first = true;
+  uint64_t total = 0;
+  for (int k = 1; k < TRACE_KINDS; k++) {
+    replay_stats_t *kind = &stats[k];
+    if (kind->count == 0)
+      continue;
+    total += kind->total;
+    qsort(kind->latencies, kind->count, sizeof(uint32_t), replay_compare);
+    uint32_t p50 = kind->latencies[(kind->count - 1) / 2];
+    uint32_t p99 = kind->latencies[(kind->count * 99 + 99) / 100 - 1];
+    uint32_t max = kind->latencies[kind->count - 1];
+    if (json) {
+      dump_text(&out, first ? "\n{\"op\":" : ",\n{\"op\":");
+      dump_json_string(&out, trace_kind_name(k));
+      dump_text(&out, ",\"count\":");
+      dump_integer(&out, kind->count);
+      dump_text(&out, ",\"found\":");
+      dump_integer(&out, kind->found);
+      dump_text(&out, ",\"total_ns\":");
+      dump_integer(&out, (long long)kind->total);
+      dump_text(&out, ",\"latency_ns\":{\"p50\":");
+      dump_integer(&out, p50);
+      dump_text(&out, ",\"p99\":");
+      dump_integer(&out, p99);
+      dump_text(&out, ",\"max\":");
+      dump_integer(&out, max);
+      dump_text(&out, "}}");
+    } else {
+      printf("  %-16s %10ld ops %10ld found %10.3f ms p50 %6u p99 %7u max "
+             "%9u ns\n",
+             trace_kind_name(k), kind->count, kind->found, kind->total * 1e-6,
+             p50, p99, max);
+    }
+    first = false;
+  }
+  if (json) {
+    dump_text(&out, "\n],\"total_ns\":");
+    dump_integer(&out, (long long)total);
+    dump_text(&out, "}\n");
+  } else {
+    printf("  %-16s %10.3f ms\n", "total", total * 1e-6);
+  }
+  dump_flush(&out);
+  dump_dispose(&out);
+
+  for (uint32_t h = 0; h < trace.handles; h++) {
+    bst_dispose(&trees[h]);
+    if (tables[h] != NULL) {
+      ht_delete_all(tables[h]);
+      free(tables[h]);
+    }
+  }
+  for (int kind = 0; kind < TRACE_KINDS; kind++)
+    free(stats[kind].latencies);
+  free(trees);
+  free(tables);
+  trace_dispose(&trace);
+}
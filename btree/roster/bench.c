@@ -0,0 +1,145 @@
+#define _GNU_SOURCE
+
+#include "roster.h"
+#include "../bench_util.h"
+#include "test_util.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void init_bench() {
+  printf("Character Roster - benchmark\n");
+  printf("----------------------------\n");
+  printf("\n");
+}
+
+// Bajty haldy aktualne pridelene programu (vratane mmap blokov)
+static size_t bench_heap() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+/*
+ * Počet postav stromu s daným povoláním a úrovní alespoň min_level; strom
+ * se prochází s vlastním zásobníkem.
+ */
+static size_t bench_tree_count(bst_node_t *tree, character_class_t wanted,
+                               unsigned char min_level) {
+  bst_node_t **stack = malloc(128 * sizeof(bst_node_t *));
+  int size = 0;
+  size_t found = 0;
+  if (tree != NULL) {
+    stack[size++] = tree;
+  }
+  while (size > 0) {
+    bst_node_t *node = stack[--size];
+    character_t *character = node->content.value;
+    found += character->character_class == wanted &&
+             character->level >= min_level;
+    if (node->right != NULL) {
+      stack[size++] = node->right;
+    }
+    if (node->left != NULL) {
+      stack[size++] = node->left;
+    }
+  }
+  free(stack);
+  return found;
+}
+
+BENCH(bench_roster_against_tree, "Wizards with level >= 10: roster columns against a tree of CHARACTER_T")
+const uint32_t sizes[] = {100000, 1000000, 4000000};
+const int rounds = 10;
+for (int s = 0; s < 3; s++) {
+  uint32_t n = sizes[s];
+  char label[64];
+  roster_t source;
+  roster_init(&source);
+  roster_generate(&source, n, n / 4);
+
+  size_t heap = bench_heap();
+  double start = bench_now();
+  bst_node_t *tree;
+  bst_init(&tree);
+  for (uint32_t i = 0; i < n; i++) {
+    character_t *character = malloc(sizeof(character_t));
+    const char *name = roster_name(&source, i);
+    character->name = malloc(strlen(name) + 1);
+    strcpy(character->name, name);
+    character->character_class = source.classes[i];
+    character->level = source.levels[i];
+    bst_node_content_t content = {.value = character, .type = CHARACTER_T};
+    // Rozne kluce v premiesanom poradi, aby strom nebol zdegenerovany
+    bst_key_t key = (bst_key_t)((i * 2654435761u) & 0x7fffffff);
+    bst_insert_key(&tree, key, content, NULL);
+  }
+  snprintf(label, sizeof(label), "tree build %u", n);
+  bench_report(label, n, bench_now() - start);
+  size_t tree_bytes = bench_heap() - heap;
+
+  heap = bench_heap();
+  character_t *characters = malloc(n * sizeof(character_t));
+  roster_export(&source, characters);
+  roster_t roster;
+  roster_init(&roster);
+  start = bench_now();
+  roster_load(&roster, characters, n);
+  snprintf(label, sizeof(label), "roster load %u", n);
+  bench_report(label, n, bench_now() - start);
+  free(characters);
+  size_t roster_bytes = bench_heap() - heap;
+  printf("  %-32s %6.1f B tree, %6.1f B roster\n", "memory per character",
+         (double)tree_bytes / n, (double)roster_bytes / n);
+
+  size_t found = 0;
+  start = bench_now();
+  for (int r = 0; r < rounds; r++) {
+    found = bench_tree_count(tree, Wizard, 10);
+  }
+  double tree_seconds = bench_now() - start;
+  snprintf(label, sizeof(label), "tree scan %u", n);
+  bench_report(label, (long)n * rounds, tree_seconds);
+
+  uint32_t *rows = malloc(n * sizeof(uint32_t));
+  for (int vectors = 0; vectors < 2; vectors++) {
+    roster_use_vectors(vectors);
+    size_t count = 0;
+    start = bench_now();
+    for (int r = 0; r < rounds; r++) {
+      count = roster_filter(&roster, Wizard, 10, 255, rows);
+    }
+    double seconds = bench_now() - start;
+    snprintf(label, sizeof(label), "roster filter %s %u",
+             vectors ? "vector" : "scalar", n);
+    bench_report(label, (long)n * rounds, seconds);
+    printf("  %-32s %6.1fx, same result: %s\n", "speedup over tree",
+           tree_seconds / seconds, count == found ? "yes" : "no");
+  }
+
+  const uint32_t *indexed;
+  start = bench_now();
+  roster_query(&roster, Wizard, 10, 255, &indexed);
+  snprintf(label, sizeof(label), "class index build %u", n);
+  bench_report(label, n, bench_now() - start);
+  size_t count = 0;
+  start = bench_now();
+  for (int r = 0; r < rounds; r++) {
+    count = roster_query(&roster, Wizard, 10, 255, &indexed);
+  }
+  snprintf(label, sizeof(label), "class index query %u", n);
+  bench_report(label, rounds, bench_now() - start);
+  printf("  %-32s %s\n", "same result", count == found ? "yes" : "no");
+
+  free(rows);
+  roster_dispose(&roster);
+  roster_dispose(&source);
+  bst_dispose(&tree);
+}
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_roster_against_tree();
+}
@@ -0,0 +1,433 @@
+/*
+ * Sloupcové úložiště postav
+ *
+ * Místo uzlu stromu s hodnotou CHARACTER_T a zvlášť alokovaným jménem má
+ * každá vlastnost postavy vlastní souvislé pole. Jména se ukládají jen
+ * jednou (interning) do jednoho bloku a řádek drží 32bitový index jména.
+ * Filtr přes povolání a úroveň prochází dva bajtové sloupce vektorově,
+ * 16 nebo 32 řádků na krok. Index podle povolání řadí řádky podle
+ * (povolání, úroveň) přihrádkovým řazením v lineárním čase, dotaz na
+ * povolání a interval úrovní pak vrací souvislý úsek bez procházení.
+ *
+ * Sloupce i blok jmen se při růstu realokují; ukazatele na jména vrácené
+ * funkcemi roster_get, roster_export a roster_name proto platí jen do
+ * dalšího vložení.
+ */
+
+#include "roster.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ROSTER_X86 1
+#include <immintrin.h>
+#endif
+
+#define ROSTER_INITIAL_CAPACITY 64
+
+static bool roster_vectors = true;
+
+/*
+ * Inicializace prázdného úložiště.
+ */
+void roster_init(roster_t *roster)
+{
+  memset(roster, 0, sizeof(roster_t));
+}
+
+static bool roster_grow(void **array, size_t size)
+{
+  void *grown = realloc(*array, size);
+  if (grown == NULL)
+    return false;
+  *array = grown;
+  return true;
+}
+
+/*
+ * Zvětšení sloupců alespoň na count řádků. Vrací false při nedostatku
+ * paměti; úložiště zůstane beze změny.
+ */
+bool roster_reserve(roster_t *roster, uint32_t count)
+{
+  if (count <= roster->capacity)
+    return true;
+  if (!roster_grow((void **)&roster->names, count * sizeof(uint32_t)) ||
+      !roster_grow((void **)&roster->classes, count) ||
+      !roster_grow((void **)&roster->levels, count))
+    return false;
+  roster->capacity = count;
+  return true;
+}
+
+/*
+ * FNV-1a jména pro tabulku unikátních jmen.
+ */
+static uint32_t roster_hash(const char *name)
+{
+  uint32_t hash = 2166136261u;
+  for (; *name != '\0'; name++)
+  {
+    hash ^= (unsigned char)*name;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*
+ * Zdvojnásobení rozptylové tabulky jmen a nové rozptýlení všech jmen.
+ */
+static bool roster_grow_names(roster_t *roster)
+{
+  uint32_t slots = roster->name_index == NULL
+                       ? 2 * ROSTER_INITIAL_CAPACITY
+                       : 2 * (roster->name_index_mask + 1);
+  uint32_t *index = calloc(slots, sizeof(uint32_t));
+  if (index == NULL)
+    return false;
+  for (uint32_t id = 0; id < roster->name_count; id++)
+  {
+    uint32_t slot = roster_hash(roster->pool + roster->name_offsets[id]) &
+                    (slots - 1);
+    while (index[slot] != 0)
+      slot = (slot + 1) & (slots - 1);
+    index[slot] = id + 1;
+  }
+  free(roster->name_index);
+  roster->name_index = index;
+  roster->name_index_mask = slots - 1;
+  return true;
+}
+
+/*
+ * Index jména; jméno, které v úložišti ještě není, se přidá. Vrací -1 při
+ * nedostatku paměti.
+ */
+static int64_t roster_intern(roster_t *roster, const char *name)
+{
+  // Tabulka se zvetsuje pri zaplneni do poloviny
+  if (2 * (roster->name_count + 1) > roster->name_index_mask + 1 ||
+      roster->name_index == NULL)
+  {
+    if (!roster_grow_names(roster))
+      return -1;
+  }
+
+  uint32_t slot = roster_hash(name) & roster->name_index_mask;
+  for (; roster->name_index[slot] != 0;
+       slot = (slot + 1) & roster->name_index_mask)
+  {
+    uint32_t id = roster->name_index[slot] - 1;
+    if (strcmp(roster->pool + roster->name_offsets[id], name) == 0)
+      return id;
+  }
+
+  size_t length = strlen(name) + 1;
+  if (roster->pool_size + length > UINT32_MAX)
+    return -1;
+  if (roster->pool_size + length > roster->pool_capacity)
+  {
+    size_t capacity = roster->pool_capacity > 0 ? roster->pool_capacity : 1024;
+    while (capacity < roster->pool_size + length)
+      capacity *= 2;
+    if (!roster_grow((void **)&roster->pool, capacity))
+      return -1;
+    roster->pool_capacity = capacity;
+  }
+  if (roster->name_count == roster->name_capacity)
+  {
+    uint32_t capacity = roster->name_capacity > 0 ? 2 * roster->name_capacity
+                                                  : ROSTER_INITIAL_CAPACITY;
+    if (!roster_grow((void **)&roster->name_offsets,
+                     capacity * sizeof(uint32_t)))
+      return -1;
+    roster->name_capacity = capacity;
+  }
+
+  memcpy(roster->pool + roster->pool_size, name, length);
+  roster->name_offsets[roster->name_count] = roster->pool_size;
+  roster->pool_size += length;
+  roster->name_index[slot] = roster->name_count + 1;
+  return roster->name_count++;
+}
+
+/*
+ * Přidání postavy na konec úložiště. Vrací index nového řádku, nebo -1 při
+ * nedostatku paměti.
+ */
+int64_t roster_append(roster_t *roster, const char *name,
+                      character_class_t character_class, unsigned char level)
+{
+  if (roster->count == roster->capacity)
+  {
+    uint32_t capacity = roster->capacity > 0 ? 2 * roster->capacity
+                                             : ROSTER_INITIAL_CAPACITY;
+    if (capacity <= roster->capacity || !roster_reserve(roster, capacity))
+      return -1;
+  }
+  int64_t id = roster_intern(roster, name);
+  if (id < 0)
+    return -1;
+
+  uint32_t row = roster->count++;
+  roster->names[row] = id;
+  roster->classes[row] = character_class;
+  roster->levels[row] = level;
+  roster->index_valid = false;
+  return row;
+}
+
+/*
+ * Hromadné přidání count postav; sloupce se zvětší jen jednou. Vrací false
+ * při nedostatku paměti (dosud přidané postavy zůstanou).
+ */
+bool roster_load(roster_t *roster, const character_t characters[],
+                 size_t count)
+{
+  if (roster->count + count > UINT32_MAX ||
+      !roster_reserve(roster, roster->count + count))
+    return false;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (roster_append(roster, characters[i].name,
+                      characters[i].character_class,
+                      characters[i].level) < 0)
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Jméno postavy na řádku row.
+ */
+const char *roster_name(roster_t *roster, uint32_t row)
+{
+  return roster->pool + roster->name_offsets[roster->names[row]];
+}
+
+/*
+ * Postava na řádku row; jméno ukazuje do úložiště.
+ */
+void roster_get(roster_t *roster, uint32_t row, character_t *character)
+{
+  character->name = (char *)roster_name(roster, row);
+  character->character_class = roster->classes[row];
+  character->level = roster->levels[row];
+}
+
+/*
+ * Hromadný export všech řádků do pole characters o roster->count prvcích.
+ */
+void roster_export(roster_t *roster, character_t characters[])
+{
+  for (uint32_t row = 0; row < roster->count; row++)
+    roster_get(roster, row, &characters[row]);
+}
+
+/*
+ * Zápis řádků z bitové masky nalezených řádků (bit i odpovídá řádku
+ * first + i); bez pole rows se řádky jen počítají.
+ */
+static size_t roster_emit(uint32_t first, uint32_t mask, uint32_t rows[],
+                          size_t found)
+{
+  if (rows == NULL)
+    return found + __builtin_popcount(mask);
+  while (mask != 0)
+  {
+    rows[found++] = first + __builtin_ctz(mask);
+    mask &= mask - 1;
+  }
+  return found;
+}
+
+static size_t roster_filter_scalar(roster_t *roster, uint32_t first,
+                                   int character_class,
+                                   unsigned char min_level,
+                                   unsigned char max_level, uint32_t rows[],
+                                   size_t found)
+{
+  for (uint32_t row = first; row < roster->count; row++)
+  {
+    if ((character_class == ROSTER_ANY_CLASS ||
+         roster->classes[row] == character_class) &&
+        roster->levels[row] >= min_level && roster->levels[row] <= max_level)
+    {
+      if (rows != NULL)
+        rows[found] = row;
+      found++;
+    }
+  }
+  return found;
+}
+
+#ifdef ROSTER_X86
+static size_t roster_filter_sse2(roster_t *roster, int character_class,
+                                 unsigned char min_level,
+                                 unsigned char max_level, uint32_t rows[])
+{
+  const __m128i wanted = _mm_set1_epi8((char)character_class);
+  const __m128i low = _mm_set1_epi8((char)min_level);
+  const __m128i high = _mm_set1_epi8((char)max_level);
+  const __m128i any = _mm_set1_epi8(character_class == ROSTER_ANY_CLASS ? -1 : 0);
+  size_t found = 0;
+  uint32_t row = 0;
+  for (; row + 16 <= roster->count; row += 16)
+  {
+    __m128i classes = _mm_loadu_si128((const __m128i *)(roster->classes + row));
+    __m128i levels = _mm_loadu_si128((const __m128i *)(roster->levels + row));
+    // Porovnanie bez znamienka: min/max sa rovna hodnote
+    __m128i match = _mm_or_si128(_mm_cmpeq_epi8(classes, wanted), any);
+    match = _mm_and_si128(match,
+                          _mm_cmpeq_epi8(_mm_max_epu8(levels, low), levels));
+    match = _mm_and_si128(match,
+                          _mm_cmpeq_epi8(_mm_min_epu8(levels, high), levels));
+    found = roster_emit(row, _mm_movemask_epi8(match), rows, found);
+  }
+  return roster_filter_scalar(roster, row, character_class, min_level,
+                              max_level, rows, found);
+}
+
+__attribute__((target("avx2")))
+static size_t roster_filter_avx2(roster_t *roster, int character_class,
+                                 unsigned char min_level,
+                                 unsigned char max_level, uint32_t rows[])
+{
+  const __m256i wanted = _mm256_set1_epi8((char)character_class);
+  const __m256i low = _mm256_set1_epi8((char)min_level);
+  const __m256i high = _mm256_set1_epi8((char)max_level);
+  const __m256i any =
+      _mm256_set1_epi8(character_class == ROSTER_ANY_CLASS ? -1 : 0);
+  size_t found = 0;
+  uint32_t row = 0;
+  for (; row + 32 <= roster->count; row += 32)
+  {
+    __m256i classes =
+        _mm256_loadu_si256((const __m256i *)(roster->classes + row));
+    __m256i levels = _mm256_loadu_si256((const __m256i *)(roster->levels + row));
+    __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(classes, wanted), any);
+    match = _mm256_and_si256(
+        match, _mm256_cmpeq_epi8(_mm256_max_epu8(levels, low), levels));
+    match = _mm256_and_si256(
+        match, _mm256_cmpeq_epi8(_mm256_min_epu8(levels, high), levels));
+    found = roster_emit(row, (uint32_t)_mm256_movemask_epi8(match), rows,
+                        found);
+  }
+  return roster_filter_scalar(roster, row, character_class, min_level,
+                              max_level, rows, found);
+}
+#endif
+
+/*
+ * Zapnutí nebo vypnutí vektorových filtrů (pro měření).
+ */
+void roster_use_vectors(bool enabled)
+{
+  roster_vectors = enabled;
+}
+
+/*
+ * Řádky s povoláním character_class (nebo libovolným pro ROSTER_ANY_CLASS)
+ * a úrovní v intervalu <min_level, max_level>, vzestupně. Pole rows musí
+ * mít místo pro všechny řádky, které filtru vyhoví (nejvýše roster->count).
+ * Vrací jejich počet.
+ */
+size_t roster_filter(roster_t *roster, int character_class,
+                     unsigned char min_level, unsigned char max_level,
+                     uint32_t rows[])
+{
+#ifdef ROSTER_X86
+  if (roster_vectors)
+  {
+    if (__builtin_cpu_supports("avx2"))
+      return roster_filter_avx2(roster, character_class, min_level, max_level,
+                                rows);
+    return roster_filter_sse2(roster, character_class, min_level, max_level,
+                              rows);
+  }
+#endif
+  return roster_filter_scalar(roster, 0, character_class, min_level,
+                              max_level, rows, 0);
+}
+
+/*
+ * Počet řádků, které vyhoví filtru (viz roster_filter).
+ */
+size_t roster_count(roster_t *roster, int character_class,
+                    unsigned char min_level, unsigned char max_level)
+{
+  return roster_filter(roster, character_class, min_level, max_level, NULL);
+}
+
+/*
+ * Přestavba indexu podle povolání přihrádkovým řazením: spočítat řádky
+ * každé dvojice (povolání, úroveň), určit začátky úseků a rozmístit řádky.
+ * Řádky v úseku zůstanou vzestupně.
+ */
+static bool roster_build_index(roster_t *roster)
+{
+  const size_t buckets = ROSTER_CLASSES * 256;
+  uint32_t *start = calloc(buckets + 1, sizeof(uint32_t));
+  uint32_t *rows = malloc((roster->count > 0 ? roster->count : 1) *
+                          sizeof(uint32_t));
+  if (start == NULL || rows == NULL)
+  {
+    free(start);
+    free(rows);
+    return false;
+  }
+
+  for (uint32_t row = 0; row < roster->count; row++)
+    start[roster->classes[row] * 256 + roster->levels[row] + 1]++;
+  for (size_t b = 0; b < buckets; b++)
+    start[b + 1] += start[b];
+  for (uint32_t row = 0; row < roster->count; row++)
+    rows[start[roster->classes[row] * 256 + roster->levels[row]]++] = row;
+  // Po rozmiestneni ukazuje kazdy zaciatok na koniec svojho useku
+  memmove(start + 1, start, buckets * sizeof(uint32_t));
+  start[0] = 0;
+
+  free(roster->index_rows);
+  free(roster->index_start);
+  roster->index_rows = rows;
+  roster->index_start = start;
+  roster->index_valid = true;
+  return true;
+}
+
+/*
+ * Řádky povolání character_class s úrovní v intervalu <min_level,
+ * max_level> z indexu podle povolání, seřazené podle úrovně. Do *rows
+ * zapíše začátek souvislého úseku uvnitř indexu (platí do dalšího vložení)
+ * a vrací jeho délku. Index se po vložení přestaví při prvním dotazu.
+ */
+size_t roster_query(roster_t *roster, character_class_t character_class,
+                    unsigned char min_level, unsigned char max_level,
+                    const uint32_t **rows)
+{
+  *rows = NULL;
+  if ((int)character_class < 0 || (int)character_class >= ROSTER_CLASSES ||
+      min_level > max_level ||
+      (!roster->index_valid && !roster_build_index(roster)))
+    return 0;
+  const uint32_t *start = roster->index_start + character_class * 256;
+  *rows = roster->index_rows + start[min_level];
+  return start[max_level + 1] - start[min_level];
+}
+
+/*
+ * Uvolnění všech sloupců, jmen a indexu; úložiště zůstane ve stavu po
+ * inicializaci.
+ */
+void roster_dispose(roster_t *roster)
+{
+  free(roster->names);
+  free(roster->classes);
+  free(roster->levels);
+  free(roster->pool);
+  free(roster->name_offsets);
+  free(roster->name_index);
+  free(roster->index_rows);
+  free(roster->index_start);
+  roster_init(roster);
+}
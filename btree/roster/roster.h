@@ -0,0 +1,71 @@
+/*
+ * Hlavičkový soubor pro sloupcové úložiště postav.
+ */
+
+#ifndef IAL_BTREE_ROSTER_H
+#define IAL_BTREE_ROSTER_H
+
+#include "../character.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Libovolné povolání ve filtru
+#define ROSTER_ANY_CLASS (-1)
+
+// Počet povolání v character_class_t
+#define X(name) +1
+enum { ROSTER_CLASSES = 0 CHARACTER_CLASSES };
+#undef X
+
+/*
+ * Postavy uložené po sloupcích: jméno (index do tabulky unikátních jmen),
+ * povolání a úroveň mají každé vlastní pole, řádek i je i-tá postava.
+ * Filtr přes povolání a úroveň tak čte jen dva bajty na postavu.
+ */
+typedef struct roster {
+  uint32_t *names;              // index jména řádku
+  uint8_t *classes;             // povolání řádku
+  uint8_t *levels;              // úroveň řádku
+  uint32_t count;               // počet řádků
+  uint32_t capacity;            // délka sloupců
+
+  char *pool;                   // unikátní jména ukončená nulou za sebou
+  size_t pool_size;
+  size_t pool_capacity;
+  uint32_t *name_offsets;       // začátek jména v pool podle indexu
+  uint32_t name_count;
+  uint32_t name_capacity;
+  uint32_t *name_index;         // rozptylová tabulka: index jména + 1, 0 volno
+  uint32_t name_index_mask;
+
+  // Index podle povolání: řádky seřazené podle (povolání, úroveň, řádek),
+  // úsek povolání c s úrovní l začíná na index_start[c * 256 + l]
+  uint32_t *index_rows;
+  uint32_t *index_start;
+  bool index_valid;             // index odpovídá řádkům
+} roster_t;
+
+void roster_init(roster_t *roster);
+bool roster_reserve(roster_t *roster, uint32_t count);
+int64_t roster_append(roster_t *roster, const char *name,
+                      character_class_t character_class, unsigned char level);
+bool roster_load(roster_t *roster, const character_t characters[],
+                 size_t count);
+void roster_get(roster_t *roster, uint32_t row, character_t *character);
+void roster_export(roster_t *roster, character_t characters[]);
+const char *roster_name(roster_t *roster, uint32_t row);
+
+void roster_use_vectors(bool enabled);
+size_t roster_filter(roster_t *roster, int character_class,
+                     unsigned char min_level, unsigned char max_level,
+                     uint32_t rows[]);
+size_t roster_count(roster_t *roster, int character_class,
+                    unsigned char min_level, unsigned char max_level);
+size_t roster_query(roster_t *roster, character_class_t character_class,
+                    unsigned char min_level, unsigned char max_level,
+                    const uint32_t **rows);
+
+void roster_dispose(roster_t *roster);
+
+#endif
@@ -0,0 +1,132 @@
+#include "roster.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int party_count = 7;
+const character_t party[] = {
+    {"Gandalf", Wizard, 20}, {"Aragorn", Fighter, 15}, {"Elrond", Cleric, 18},
+    {"Gandalf", Wizard, 5},  {"Merry", Bard, 3},       {"Saruman", Wizard, 12},
+    {"Merry", Monk, 9}};
+
+void init_test() {
+  printf("Character Roster - testing script\n");
+  printf("---------------------------------\n");
+  printf("\n");
+}
+
+TEST(test_roster_empty, "Filter and query an empty roster")
+uint32_t rows[1];
+printf("Filter: %zu\n", roster_filter(&test_roster, Wizard, 0, 255, rows));
+const uint32_t *indexed;
+printf("Query: %zu\n", roster_query(&test_roster, Wizard, 0, 255, &indexed));
+roster_print(&test_roster);
+ENDTEST
+
+TEST(test_roster_append, "Append characters with repeated names")
+for (int i = 0; i < party_count; i++) {
+  roster_append(&test_roster, party[i].name, party[i].character_class,
+                party[i].level);
+}
+roster_print(&test_roster);
+printf("Same name storage for rows 0 and 3: %s\n",
+       roster_name(&test_roster, 0) == roster_name(&test_roster, 3) ? "yes"
+                                                                    : "no");
+ENDTEST
+
+TEST(test_roster_filter, "All Wizards with level >= 10 and any class with level 3-9")
+roster_load(&test_roster, party, party_count);
+uint32_t rows[7];
+size_t count = roster_filter(&test_roster, Wizard, 10, 255, rows);
+roster_print_rows(&test_roster, rows, count);
+count = roster_filter(&test_roster, ROSTER_ANY_CLASS, 3, 9, rows);
+roster_print_rows(&test_roster, rows, count);
+ENDTEST
+
+TEST(test_roster_filter_vectors, "Vector filters agree with the scalar loop (1000 rows)")
+roster_generate(&test_roster, 1000, 300);
+uint32_t *expected = malloc(1000 * sizeof(uint32_t));
+uint32_t *rows = malloc(1000 * sizeof(uint32_t));
+int mismatches = 0;
+size_t total = 0;
+for (int c = ROSTER_ANY_CLASS; c < ROSTER_CLASSES; c++) {
+  for (int low = 0; low <= 31; low += 5) {
+    roster_use_vectors(false);
+    size_t want = roster_filter(&test_roster, c, low, low + 7, expected);
+    roster_use_vectors(true);
+    size_t count = roster_filter(&test_roster, c, low, low + 7, rows);
+    mismatches += count != want ||
+                  memcmp(rows, expected, count * sizeof(uint32_t)) != 0 ||
+                  roster_count(&test_roster, c, low, low + 7) != want;
+    total += count;
+  }
+}
+printf("Unique names: %u, mismatches: %d, rows found: %zu\n",
+       test_roster.name_count, mismatches, total);
+free(expected);
+free(rows);
+ENDTEST
+
+TEST(test_roster_query, "Class index: Wizards with level 10-20, sorted by level")
+roster_load(&test_roster, party, party_count);
+const uint32_t *rows;
+size_t count = roster_query(&test_roster, Wizard, 10, 20, &rows);
+roster_print_rows(&test_roster, rows, count);
+roster_append(&test_roster, "Radagast", Wizard, 11);
+count = roster_query(&test_roster, Wizard, 10, 20, &rows);
+roster_print_rows(&test_roster, rows, count);
+ENDTEST
+
+TEST(test_roster_query_random, "Class index agrees with the filter (1000 rows)")
+roster_generate(&test_roster, 1000, 300);
+uint32_t *expected = malloc(1000 * sizeof(uint32_t));
+int mismatches = 0;
+for (int c = 0; c < ROSTER_CLASSES; c++) {
+  for (int low = 0; low <= 31; low += 3) {
+    size_t want = roster_filter(&test_roster, c, low, low + 4, expected);
+    const uint32_t *rows;
+    size_t count = roster_query(&test_roster, c, low, low + 4, &rows);
+    // Index radi podla urovne, filter podla riadku; porovna sa mnozina
+    bool *seen = calloc(1000, sizeof(bool));
+    for (size_t i = 0; i < count; i++) {
+      seen[rows[i]] = true;
+      mismatches += i > 0 && test_roster.levels[rows[i - 1]] >
+                                 test_roster.levels[rows[i]];
+    }
+    for (size_t i = 0; i < want; i++) {
+      mismatches += !seen[expected[i]];
+    }
+    mismatches += count != want;
+    free(seen);
+  }
+}
+printf("Mismatches: %d\n", mismatches);
+free(expected);
+ENDTEST
+
+TEST(test_roster_export, "Bulk load and export")
+roster_load(&test_roster, party, party_count);
+character_t *exported = malloc(test_roster.count * sizeof(character_t));
+roster_export(&test_roster, exported);
+int mismatches = 0;
+for (int i = 0; i < party_count; i++) {
+  mismatches += strcmp(exported[i].name, party[i].name) != 0 ||
+                exported[i].character_class != party[i].character_class ||
+                exported[i].level != party[i].level;
+}
+printf("Exported: %u, mismatches: %d\n", test_roster.count, mismatches);
+free(exported);
+ENDTEST
+
+int main(int argc, char *argv[]) {
+  init_test();
+
+  test_roster_empty();
+  test_roster_append();
+  test_roster_filter();
+  test_roster_filter_vectors();
+  test_roster_query();
+  test_roster_query_random();
+  test_roster_export();
+}
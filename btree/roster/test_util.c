@@ -0,0 +1,44 @@
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void roster_print_row(roster_t *roster, uint32_t row) {
+  character_t character;
+  roster_get(roster, row, &character);
+  printf("%u: ", row);
+  print_character(&character);
+  printf("\n");
+}
+
+void roster_print_rows(roster_t *roster, const uint32_t rows[], size_t count) {
+  printf("Rows: %zu\n", count);
+  for (size_t i = 0; i < count; i++) {
+    roster_print_row(roster, rows[i]);
+  }
+}
+
+void roster_print(roster_t *roster) {
+  printf("Characters: %u, unique names: %u\n", roster->count,
+         roster->name_count);
+  for (uint32_t row = 0; row < roster->count; row++) {
+    roster_print_row(roster, row);
+  }
+}
+
+/*
+ * Pseudonáhodné postavy: jméno "Hero<n>" z names různých jmen, povolání
+ * a úroveň 1-30.
+ */
+void roster_generate(roster_t *roster, uint32_t count, uint32_t names) {
+  unsigned int seed = 5;
+  char name[32];
+  roster_reserve(roster, roster->count + count);
+  for (uint32_t i = 0; i < count; i++) {
+    seed = seed * 1103515245 + 12345;
+    snprintf(name, sizeof(name), "Hero%u", (seed >> 8) % names);
+    seed = seed * 1103515245 + 12345;
+    character_class_t character_class = (seed >> 16) % ROSTER_CLASSES;
+    seed = seed * 1103515245 + 12345;
+    roster_append(roster, name, character_class, 1 + (seed >> 16) % 30);
+  }
+}
@@ -0,0 +1,23 @@
+#ifndef IAL_BTREE_ROSTER_TEST_UTIL_H
+#define IAL_BTREE_ROSTER_TEST_UTIL_H
+
+#include "roster.h"
+#include <stdio.h>
+
+#define TEST(NAME, DESCRIPTION)                                                \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    roster_t test_roster;                                                      \
+    roster_init(&test_roster);
+
+#define ENDTEST                                                                \
+  printf("\n");                                                                \
+  roster_dispose(&test_roster);                                                \
+  }
+
+void roster_print_row(roster_t *roster, uint32_t row);
+void roster_print_rows(roster_t *roster, const uint32_t rows[], size_t count);
+void roster_print(roster_t *roster);
+void roster_generate(roster_t *roster, uint32_t count, uint32_t names);
+
+#endif
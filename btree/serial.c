@@ -0,0 +1,413 @@
+/*
+ * Ukládání stromu do kompaktního binárního souboru
+ *
+ * Uzly se ukládají v pořadí preorder jako záznamy pevné délky, hodnoty
+ * typu INTEGER přímo v záznamu, postavy (CHARACTER_T) v oddělené oblasti
+ * dat. Načtení postaví strom bez jediného vkládání: všechny uzly v jednom
+ * bloku, všechny celočíselné hodnoty v druhém. Namapovaný soubor slouží
+ * k vyhledávání bez načítání, záznamy uzlů tvoří přímo vyhledávací strom.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "serial.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Zarovnani zaznamov postav v oblasti dat
+#define BST_FILE_ALIGN(size) (((size) + 3u) & ~3u)
+
+/*
+ * Kontrola obsahu souboru před použitím.
+ *
+ * Kromě mezí ověří, že indexy potomků rostou a na každý uzel kromě kořene
+ * vede právě jeden odkaz. Poškozený soubor tak nemůže vytvořit cyklus ani
+ * sdílený uzel; pořadí klíčů se nekontroluje.
+ */
+static bool bst_file_check(const char *memory, size_t length)
+{
+  const bst_file_header_t *header = (const bst_file_header_t *)memory;
+  if (length < sizeof(bst_file_header_t) ||
+      memcmp(header->magic, BST_FILE_MAGIC, 4) != 0)
+    return false;
+  if ((uint64_t)sizeof(bst_file_header_t) +
+          (uint64_t)header->count * sizeof(bst_file_node_t) +
+          header->data_size != length)
+    return false;
+
+  uint32_t count = header->count;
+  const bst_file_node_t *nodes =
+      (const bst_file_node_t *)(memory + sizeof(bst_file_header_t));
+  const char *data = (const char *)(nodes + count);
+  unsigned char *parents = calloc(count > 0 ? count : 1, 1);
+  if (parents == NULL)
+    return false;
+
+  bool valid = true;
+  for (uint32_t i = 0; i < count && valid; i++)
+  {
+    const bst_file_node_t *node = &nodes[i];
+    if (node->flags & BST_FILE_LEFT)
+    {
+      valid = i + 1 < count && parents[i + 1]++ == 0;
+    }
+    if (valid && node->right != 0)
+    {
+      valid = node->right > i && node->right < count &&
+              parents[node->right]++ == 0;
+    }
+    if (!valid || (node->flags & BST_FILE_NULL))
+      continue;
+
+    if (node->type == CHARACTER_T)
+    {
+      uint32_t offset = (uint32_t)node->value;
+      valid = offset % 4 == 0 &&
+              (uint64_t)offset + sizeof(bst_file_character_t) <=
+                  header->data_size;
+      if (valid)
+      {
+        const bst_file_character_t *character =
+            (const bst_file_character_t *)(data + offset);
+        uint64_t end = (uint64_t)offset + sizeof(bst_file_character_t) +
+                       character->name_length;
+        valid = end < header->data_size && data[end] == '\0';
+      }
+    }
+    else
+      valid = node->type == INTEGER;
+  }
+  for (uint32_t i = 1; i < count && valid; i++)
+    valid = parents[i] == 1;
+
+  free(parents);
+  return valid;
+}
+
+/*
+ * Uložení stromu do souboru path.
+ *
+ * Podporované jsou hodnoty typu INTEGER a CHARACTER_T a 32bitové klíče.
+ * Vrací false, pokud soubor nelze zapsat nebo strom obsahuje hodnotu
+ * jiného typu nebo klíč mimo rozsah int32_t (při překladu s -DBST_KEY64).
+ */
+bool bst_save(bst_node_t *tree, const char *path)
+{
+  bst_items_t items = {NULL, 0, 0};
+  bst_preorder(tree, &items);
+
+  bst_file_header_t header = {BST_FILE_MAGIC, (uint32_t)items.size, 0, 0};
+  bst_file_node_t *records = calloc(items.size > 0 ? items.size : 1,
+                                    sizeof(bst_file_node_t));
+  int *pending = malloc((items.size > 0 ? items.size : 1) * sizeof(int));
+  int pending_count = 0;
+  char *data = NULL;
+  uint32_t data_capacity = 0;
+  bool valid = records != NULL && pending != NULL;
+
+  for (int i = 0; i < items.size && valid; i++)
+  {
+    bst_node_t *node = items.nodes[i];
+    bst_file_node_t *record = &records[i];
+
+    // Uzol, ktory nie je lavym synom predchodcu, je pravym synom posledneho
+    // uzla s doposial nevyplnenym pravym synom
+    if (i > 0 && items.nodes[i - 1]->left != node)
+      records[pending[--pending_count]].right = (uint32_t)i;
+    if (node->left != NULL)
+      record->flags |= BST_FILE_LEFT;
+    if (node->right != NULL)
+      pending[pending_count++] = i;
+
+#ifdef BST_KEY64
+    if (node->key < INT32_MIN || node->key > INT32_MAX)
+    {
+      valid = false;
+      break;
+    }
+#endif
+    record->key = (int32_t)node->key;
+    record->type = (uint8_t)node->content.type;
+    if (node->content.value == NULL)
+    {
+      record->flags |= BST_FILE_NULL;
+    }
+    else if (node->content.type == INTEGER)
+    {
+      record->value = *(int *)node->content.value;
+    }
+    else if (node->content.type == CHARACTER_T)
+    {
+      character_t *character = node->content.value;
+      size_t name_length = strlen(character->name);
+      uint32_t size = BST_FILE_ALIGN(sizeof(bst_file_character_t) +
+                                     name_length + 1);
+      if (name_length > UINT16_MAX)
+      {
+        valid = false;
+        break;
+      }
+      if (header.data_size + size > data_capacity)
+      {
+        data_capacity = (header.data_size + size) * 2;
+        char *grown = realloc(data, data_capacity);
+        if (grown == NULL)
+        {
+          valid = false;
+          break;
+        }
+        data = grown;
+      }
+      bst_file_character_t stored = {(uint8_t)character->character_class,
+                                     character->level, (uint16_t)name_length};
+      memset(data + header.data_size, 0, size);
+      memcpy(data + header.data_size, &stored, sizeof(stored));
+      memcpy(data + header.data_size + sizeof(stored), character->name,
+             name_length);
+      record->value = (int32_t)header.data_size;
+      header.data_size += size;
+    }
+    else
+      valid = false;
+  }
+
+  FILE *file = valid ? fopen(path, "wb") : NULL;
+  if (file != NULL)
+  {
+    valid = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(records, sizeof(bst_file_node_t), items.size, file) ==
+                (size_t)items.size &&
+            (header.data_size == 0 ||
+             fwrite(data, 1, header.data_size, file) == header.data_size);
+    valid = fclose(file) == 0 && valid;
+  }
+  else
+    valid = false;
+
+  free(data);
+  free(pending);
+  free(records);
+  free(items.nodes);
+  return valid;
+}
+
+/*
+ * Načtení stromu ze souboru path.
+ *
+ * Uzly se alokují jedním blokem (bst_alloc_nodes), hodnoty po jedné jako
+ * při vkládání; postava se alokuje i se jménem jako jeden objekt, takže ji
+ * bst_dispose uvolní celou. Původní strom se nejdřív zruší. Při chybě vrátí false a
+ * strom zůstane prázdný.
+ */
+bool bst_load(bst_node_t **tree, const char *path)
+{
+  return bst_load_with(tree, path, NULL);
+}
+
+/*
+ * Totéž s blokem uzlů alokovaným alokátorem allocator, kterým se zruší
+ * i původní strom.
+ */
+bool bst_load_with(bst_node_t **tree, const char *path,
+                   const struct allocator *allocator)
+{
+  bst_dispose_with(tree, allocator);
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return false;
+  char *memory = NULL;
+  long length = -1;
+  if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) >= 0 &&
+      fseek(file, 0, SEEK_SET) == 0)
+  {
+    memory = malloc(length > 0 ? length : 1);
+    if (memory != NULL && fread(memory, 1, length, file) != (size_t)length)
+      length = -1;
+  }
+  fclose(file);
+  if (memory == NULL || length < 0 || !bst_file_check(memory, length))
+  {
+    free(memory);
+    return false;
+  }
+
+  const bst_file_header_t *header = (const bst_file_header_t *)memory;
+  const bst_file_node_t *records =
+      (const bst_file_node_t *)(memory + sizeof(bst_file_header_t));
+  const char *data = (const char *)(records + header->count);
+  int count = (int)header->count;
+
+  bst_node_t *nodes = bst_alloc_nodes_with(allocator, count);
+  bool valid = count == 0 || nodes != NULL;
+
+  int loaded = 0;
+  for (int i = 0; valid && i < count; i++, loaded++)
+  {
+    const bst_file_node_t *record = &records[i];
+    bst_node_t *node = &nodes[i];
+    node->key = record->key;
+    node->content.type = (bst_node_content_type_t)record->type;
+    node->content.value = NULL;
+    node->left = (record->flags & BST_FILE_LEFT) ? &nodes[i + 1] : NULL;
+    node->right = record->right != 0 ? &nodes[record->right] : NULL;
+    if (record->flags & BST_FILE_NULL)
+      continue;
+
+    if (record->type == INTEGER)
+    {
+      int *integer = malloc(sizeof(int));
+      if (integer != NULL)
+        *integer = record->value;
+      else
+        valid = false;
+      node->content.value = integer;
+    }
+    else
+    {
+      const bst_file_character_t *stored =
+          (const bst_file_character_t *)(data + record->value);
+      character_t *character =
+          malloc(sizeof(character_t) + stored->name_length + 1);
+      if (character != NULL)
+      {
+        character->name = (char *)(character + 1);
+        memcpy(character->name, stored + 1, stored->name_length + 1);
+        character->character_class =
+            (character_class_t)stored->character_class;
+        character->level = stored->level;
+      }
+      else
+        valid = false;
+      node->content.value = character;
+    }
+  }
+
+  if (!valid)
+  {
+    // Uz nacitane hodnoty, potom uzly bloku po jednom; blok zanikne
+    // s poslednym
+    for (int i = 0; i < loaded; i++)
+      bst_free(nodes[i].content.value);
+    for (int i = 0; nodes != NULL && i < count; i++)
+      bst_free_node(allocator, &nodes[i]);
+    free(memory);
+    return false;
+  }
+
+  // Potomkovia maju vacsie indexy, velkosti sa dopocitaju odzadu
+  for (int i = count - 1; i >= 0; i--)
+    bst_update_size(&nodes[i]);
+
+  *tree = count > 0 ? nodes : NULL;
+  free(memory);
+  return true;
+}
+
+/*
+ * Namapování souboru path jen pro čtení.
+ *
+ * Vrací NULL, pokud soubor nelze otevřít nebo není platný.
+ */
+bst_mapped_t *bst_map(const char *path)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size <= 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  size_t length = (size_t)status.st_size;
+  void *memory = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+    return NULL;
+
+  bst_mapped_t *mapped = malloc(sizeof(bst_mapped_t));
+  if (mapped == NULL || !bst_file_check(memory, length))
+  {
+    free(mapped);
+    munmap(memory, length);
+    return NULL;
+  }
+
+  const bst_file_header_t *header = memory;
+  mapped->memory = memory;
+  mapped->length = length;
+  mapped->count = header->count;
+  mapped->nodes =
+      (const bst_file_node_t *)((char *)memory + sizeof(bst_file_header_t));
+  mapped->data = (const char *)(mapped->nodes + header->count);
+  mapped->data_size = header->data_size;
+  return mapped;
+}
+
+/*
+ * Vyhledání klíče v namapovaném souboru.
+ *
+ * V případě úspěchu vrátí true a vyplní value. Hodnota INTEGER ukazuje
+ * přímo do mapování; postavu funkce rozbalí do character (jméno ukazuje
+ * do mapování) a value ukazuje na ni. Obojí platí do bst_unmap.
+ */
+bool bst_mapped_search(const bst_mapped_t *mapped, bst_key_t key,
+                       bst_node_content_t *value, character_t *character)
+{
+  uint32_t i = 0;
+  while (i < mapped->count)
+  {
+    const bst_file_node_t *node = &mapped->nodes[i];
+    if (key < node->key)
+    {
+      if (!(node->flags & BST_FILE_LEFT))
+        return false;
+      i++;
+    }
+    else if (key > node->key)
+    {
+      if (node->right == 0)
+        return false;
+      i = node->right;
+    }
+    else
+    {
+      value->type = (bst_node_content_type_t)node->type;
+      if (node->flags & BST_FILE_NULL)
+        value->value = NULL;
+      else if (node->type == INTEGER)
+        value->value = (void *)&node->value;
+      else
+      {
+        const bst_file_character_t *stored =
+            (const bst_file_character_t *)(mapped->data + node->value);
+        character->name = (char *)(stored + 1);
+        character->character_class =
+            (character_class_t)stored->character_class;
+        character->level = stored->level;
+        value->value = character;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Zrušení mapování.
+ */
+void bst_unmap(bst_mapped_t **mapped)
+{
+  if (*mapped == NULL)
+    return;
+  munmap((*mapped)->memory, (*mapped)->length);
+  free(*mapped);
+  *mapped = NULL;
+}
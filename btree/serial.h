@@ -0,0 +1,72 @@
+/*
+ * Hlavičkový soubor pro ukládání stromu do binárního souboru.
+ */
+
+#ifndef IAL_BTREE_SERIAL_H
+#define IAL_BTREE_SERIAL_H
+
+#include "btree.h"
+#include "character.h"
+#include <stdint.h>
+
+/*
+ * Formát souboru (pořadí bajtů hostitele, soubor tedy není přenositelný
+ * mezi architekturami s jiným pořadím bajtů):
+ *
+ *   hlavička   bst_file_header_t
+ *   uzly       count záznamů bst_file_node_t v pořadí preorder
+ *   data       záznamy hodnot typu CHARACTER_T
+ *
+ * Levý potomek uzlu i je vždy uzel i+1 (příznak BST_FILE_LEFT), pravý
+ * potomek je uložen indexem; kořen má index 0, takže 0 znamená bez pravého
+ * potomka. Ve stejném tvaru se podle souboru dá i přímo vyhledávat.
+ */
+#define BST_FILE_MAGIC "BST1"
+
+#define BST_FILE_LEFT 1    // uzel má levého potomka
+#define BST_FILE_NULL 2    // uzel nemá hodnotu (content.value == NULL)
+
+typedef struct bst_file_header {
+  char magic[4];           // BST_FILE_MAGIC
+  uint32_t count;          // počet uzlů
+  uint32_t data_size;      // velikost oblasti dat v bajtech
+  uint32_t reserved;
+} bst_file_header_t;
+
+typedef struct bst_file_node {
+  int32_t key;             // klíč
+  uint32_t right;          // index pravého potomka, 0 = není
+  uint8_t type;            // bst_node_content_type_t
+  uint8_t flags;           // BST_FILE_LEFT, BST_FILE_NULL
+  uint16_t reserved;
+  int32_t value;           // INTEGER: hodnota, CHARACTER_T: posun v datech
+} bst_file_node_t;
+
+// Záznam postavy v oblasti dat; následuje jméno s nulou, zarovnáno na 4 B
+typedef struct bst_file_character {
+  uint8_t character_class; // character_class_t
+  uint8_t level;           // úroveň
+  uint16_t name_length;    // délka jména bez koncové nuly
+} bst_file_character_t;
+
+// Strom namapovaný ze souboru jen pro čtení
+typedef struct bst_mapped {
+  void *memory;                 // začátek mapování
+  size_t length;                // délka mapování
+  uint32_t count;               // počet uzlů
+  const bst_file_node_t *nodes; // uzly v pořadí preorder
+  const char *data;             // oblast dat
+  uint32_t data_size;           // velikost oblasti dat
+} bst_mapped_t;
+
+bool bst_save(bst_node_t *tree, const char *path);
+bool bst_load(bst_node_t **tree, const char *path);
+bool bst_load_with(bst_node_t **tree, const char *path,
+                   const struct allocator *allocator);
+
+bst_mapped_t *bst_map(const char *path);
+bool bst_mapped_search(const bst_mapped_t *mapped, bst_key_t key,
+                       bst_node_content_t *value, character_t *character);
+void bst_unmap(bst_mapped_t **mapped);
+
+#endif
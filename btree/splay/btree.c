@@ -0,0 +1,360 @@
+/*
+ * Binární vyhledávací strom — samoupravující (splay) varianta
+ *
+ * Vložení, odstranění i vyhledání funkcí bst_search_splay přesune dotčený
+ * uzel (nebo posledního navštíveného souseda) do kořene. Často používané
+ * klíče se tak drží u kořene a posloupnost operací má amortizovanou
+ * složitost O(log n) na operaci bez ohledu na pořadí klíčů. bst_search a
+ * bst_search_key dostávají kořen hodnotou, nový kořen by nemohly vrátit, a
+ * strom proto jen prohledají.
+ *
+ * Rozvíjení (splay) je shora dolů podle Sleatora a Tarjana: jediný průchod
+ * od kořene bez rekurze a bez zásobníku, takže ani degenerovaný strom
+ * nepřeteče zásobník volání. Rušení, průchody a dotazy nad intervalem
+ * strom nerozvíjejí a sdílí je s iterativní variantou (../iter/traverse.c).
+ */
+
+#include "../btree.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Rozvinutí stromu podle klíče key.
+ *
+ * Vrací nový kořen: uzel s klíčem key, pokud ve stromu je, jinak poslední
+ * uzel na cestě hledání (největší menší nebo nejmenší větší klíč).
+ * Uzly odtržené cestou se skládají do levého stromu (klíče menší než key)
+ * a pravého stromu (větší); nakonec se stanou podstromy nového kořene.
+ */
+static bst_node_t *bst_splay(bst_node_t *tree, bst_key_t key,
+                             bst_compare_t compare)
+{
+  if (tree == NULL)
+    return NULL;
+
+  // Pomocny uzol: header.right je lavy strom, header.left pravy strom
+  bst_node_t header;
+  header.left = NULL;
+  header.right = NULL;
+  bst_node_t *left_max = &header;
+  bst_node_t *right_min = &header;
+#ifdef BST_ORDER_STATISTICS
+  int left_size = 0;
+  int right_size = 0;
+#endif
+
+  while (true)
+  {
+    int cmp = bst_compare(compare, key, tree->key);
+    if (cmp < 0)
+    {
+      if (tree->left == NULL)
+        break;
+      if (bst_compare(compare, key, tree->left->key) < 0)
+      {
+        // Zig-zig: rotacia doprava
+        bst_node_t *child = tree->left;
+        tree->left = child->right;
+        child->right = tree;
+        bst_update_size(tree);
+        tree = child;
+        if (tree->left == NULL)
+          break;
+      }
+      // Pripojenie k pravemu stromu
+      right_min->left = tree;
+      right_min = tree;
+      tree = tree->left;
+#ifdef BST_ORDER_STATISTICS
+      right_size += 1 + bst_size(right_min->right);
+#endif
+    }
+    else if (cmp > 0)
+    {
+      if (tree->right == NULL)
+        break;
+      if (bst_compare(compare, key, tree->right->key) > 0)
+      {
+        // Zag-zag: rotacia dolava
+        bst_node_t *child = tree->right;
+        tree->right = child->left;
+        child->left = tree;
+        bst_update_size(tree);
+        tree = child;
+        if (tree->right == NULL)
+          break;
+      }
+      // Pripojenie k lavemu stromu
+      left_max->right = tree;
+      left_max = tree;
+      tree = tree->right;
+#ifdef BST_ORDER_STATISTICS
+      left_size += 1 + bst_size(left_max->left);
+#endif
+    }
+    else
+      break;
+  }
+
+  left_max->right = NULL;
+  right_min->left = NULL;
+
+#ifdef BST_ORDER_STATISTICS
+  // Velkosti na pravej ceste laveho stromu a lavej ceste praveho stromu
+  // este nezahrnaju podstromy noveho korena, ktore k nim pribudnu
+  left_size += bst_size(tree->left);
+  right_size += bst_size(tree->right);
+  tree->size = left_size + right_size + 1;
+  for (bst_node_t *node = header.right; node != NULL; node = node->right)
+  {
+    node->size = left_size;
+    left_size -= 1 + bst_size(node->left);
+  }
+  for (bst_node_t *node = header.left; node != NULL; node = node->left)
+  {
+    node->size = right_size;
+    right_size -= 1 + bst_size(node->right);
+  }
+#endif
+
+  // Zlozenie
+  left_max->right = tree->left;
+  right_min->left = tree->right;
+  tree->left = header.right;
+  tree->right = header.left;
+  return tree;
+}
+
+/*
+ * Inicializace stromu.
+ *
+ * Uživatel musí zajistit, že inicializace se nebude opakovaně volat nad
+ * inicializovaným stromem. V opačném případě může dojít k úniku paměti (memory
+ * leak). Protože neinicializovaný ukazatel má nedefinovanou hodnotu, není
+ * možné toto detekovat ve funkci.
+ */
+void bst_init(bst_node_t **tree)
+{
+  (*tree) = NULL;
+}
+
+/*
+ * Vyhledání uzlu v stromu.
+ *
+ * V případě úspěchu vrátí funkce hodnotu true a do proměnné value zapíše
+ * ukazatel na obsah daného uzlu. V opačném případě funkce vrátí hodnotu false a proměnná
+ * value zůstává nezměněná.
+ *
+ * Strom se nerozvíjí (viz bst_search_splay), ukazatele na uzly a obsah
+ * získané dříve i snímky bst_freeze zůstávají platné.
+ */
+bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
+{
+  return bst_search_key(tree, key, value, NULL);
+}
+
+/*
+ * Vyhledání uzlu podle klíče plné šířky s danou porovnávací funkcí.
+ */
+bool bst_search_key(bst_node_t *tree, bst_key_t key,
+                    bst_node_content_t **value, bst_compare_t compare)
+{
+  while (tree != NULL)
+  {
+    int cmp = bst_compare(compare, key, tree->key);
+    if (cmp < 0)
+      tree = tree->left;
+    else if (cmp > 0)
+      tree = tree->right;
+    else
+    {
+      *value = &tree->content;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Vyhledání s rozvinutím: nalezený uzel (nebo poslední uzel na cestě) se
+ * přesune do kořene a *tree se na něj nastaví. Uzly se přitom jen
+ * přepojují, obsah zůstává na svých adresách, takže dříve získané
+ * ukazatele na obsah platí dál.
+ */
+bool bst_search_splay(bst_node_t **tree, bst_key_t key,
+                      bst_node_content_t **value, bst_compare_t compare)
+{
+  *tree = bst_splay(*tree, key, compare);
+  if (*tree == NULL || bst_compare(compare, key, (*tree)->key) != 0)
+    return false;
+  *value = &(*tree)->content;
+  return true;
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíče už ve stromu existuje, nahraďte jeho hodnotu.
+ * Jinak se nový uzel stane kořenem: po rozvinutí podle key se strom rozdělí
+ * na klíče menší a větší než key.
+ */
+void bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
+{
+  bst_insert_key(tree, key, value, NULL);
+}
+
+/*
+ * Vložení uzlu s klíčem plné šířky s danou porovnávací funkcí.
+ */
+void bst_insert_key(bst_node_t **tree, bst_key_t key, bst_node_content_t value,
+                    bst_compare_t compare)
+{
+  bst_insert_key_with(tree, key, value, compare, NULL);
+}
+
+/*
+ * Vložení uzlu alokovaného alokátorem allocator.
+ */
+void bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_node_content_t value, bst_compare_t compare,
+                         const struct allocator *allocator)
+{
+  bst_node_t *root = bst_splay(*tree, key, compare);
+  *tree = root;
+  int cmp = root != NULL ? bst_compare(compare, key, root->key) : 0;
+  if (root != NULL && cmp == 0)
+  {
+    if (root->content.value != NULL)
+      bst_free(root->content.value);
+    root->content = value;
+    return;
+  }
+
+  bst_node_t *node = bst_alloc_node(allocator);
+  if (node == NULL)
+  {
+    bst_free(value.value);
+    fprintf(stderr, "Memory allocation failed for key %lld\n",
+            (long long)key);
+    return;
+  }
+  node->key = key;
+  node->content = value;
+  node->left = NULL;
+  node->right = NULL;
+  if (root != NULL && cmp < 0)
+  {
+    node->left = root->left;
+    node->right = root;
+    root->left = NULL;
+    bst_update_size(root);
+  }
+  else if (root != NULL)
+  {
+    node->right = root->right;
+    node->left = root;
+    root->right = NULL;
+    bst_update_size(root);
+  }
+  bst_update_size(node);
+  *tree = node;
+}
+
+/*
+ * Rozvinutí strom vyvažuje samo, pravidlo se nepoužije.
+ */
+void bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                              bst_node_content_t value, bst_compare_t compare,
+                              const struct allocator *allocator,
+                              bst_rebalance_t *policy)
+{
+  (void)policy;
+  bst_insert_key_with(tree, key, value, compare, allocator);
+}
+
+/*
+ * Pomocná funkce která nahradí uzel nejpravějším potomkem.
+ *
+ * Klíč a hodnota uzlu target budou nahrazené klíčem a hodnotou nejpravějšího
+ * uzlu podstromu tree. Nejpravější potomek bude odstraněný. Funkce korektně
+ * uvolní všechny alokované zdroje odstraněného uzlu.
+ *
+ * Funkce předpokládá, že hodnota tree není NULL. Strom nerozvíjí; bst_delete
+ * ji nepotřebuje, zůstává kvůli rozhraní btree.h.
+ */
+void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree)
+{
+  bst_replace_by_rightmost_with(target, tree, NULL);
+}
+
+/*
+ * Nahrazení nejpravějším potomkem; uzel se uvolní alokátorem allocator.
+ */
+void bst_replace_by_rightmost_with(bst_node_t *target, bst_node_t **tree,
+                                   const struct allocator *allocator)
+{
+  bst_node_t **rightmost = tree;
+
+  while ((*rightmost)->right != NULL)
+  {
+#ifdef BST_ORDER_STATISTICS
+    (*rightmost)->size--;
+#endif
+    rightmost = &(*rightmost)->right;
+  }
+
+  bst_node_t *current = *rightmost;
+  bst_free(target->content.value);
+  target->content = current->content;
+  target->key = current->key;
+  *rightmost = current->left;
+  bst_free_node(allocator, current);
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce jen rozvine strom.
+ * Jinak se rušený uzel rozvinutím dostane do kořene. Jeho levý podstrom
+ * se rozvine podle stejného klíče, čímž se do kořene levého podstromu
+ * dostane jeho nejpravější uzel (bez pravého potomka); ten převezme pravý
+ * podstrom a stane se novým kořenem.
+ */
+void bst_delete(bst_node_t **tree, char key)
+{
+  bst_delete_key(tree, key, NULL);
+}
+
+/*
+ * Odstranění uzlu s klíčem plné šířky s danou porovnávací funkcí.
+ */
+void bst_delete_key(bst_node_t **tree, bst_key_t key, bst_compare_t compare)
+{
+  bst_delete_key_with(tree, key, compare, NULL);
+}
+
+/*
+ * Odstranění uzlu, který se uvolní alokátorem allocator.
+ */
+void bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                         bst_compare_t compare,
+                         const struct allocator *allocator)
+{
+  bst_node_t *root = bst_splay(*tree, key, compare);
+  *tree = root;
+  if (root == NULL || bst_compare(compare, key, root->key) != 0)
+    return;
+
+  if (root->left == NULL)
+    *tree = root->right;
+  else
+  {
+    bst_node_t *left = bst_splay(root->left, key, compare);
+    left->right = root->right;
+    bst_update_size(left);
+    *tree = left;
+  }
+
+  bst_free(root->content.value);
+  bst_free_node(allocator, root);
+}
@@ -1,7 +1,17 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "btree.h"
+#include "alloc.h"
+#include "dump.h"
+#include "frozen.h"
+#include "parallel.h"
+#include "serial.h"
+#include "trace.h"
 #include "test_util.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 const int base_data_count = 15;
 const char base_keys[] = {'H', 'D', 'L', 'B', 'F', 'J', 'N', 'A',
@@ -16,6 +26,17 @@ const int traversal_data_count = 5;
 const char traversal_keys[] = {'D', 'B', 'A', 'C', 'E'};
 const int traversal_values[] = {1, 2, 3, 4, 5};
 
+const int sorted_data_count = 7;
+const char sorted_keys[] = {'A', 'B', 'C', 'D', 'E', 'F', 'G'};
+const int sorted_values[] = {1, 2, 3, 4, 5, 6, 7};
+
+const int batch_data_count = 6;
+const char batch_keys[] = {'G', 'A', 'F', 'G', 'H', 'B'};
+const int batch_values[] = {7, 10, 6, 17, 8, 20};
+
+// Pocet uzlov zdegenerovaneho stromu, viac nez MAXSTACK z iter/stack.h
+#define DEEP_TREE_COUNT 100
+
 void init_test() {
   printf("Binary Search Tree - testing script\n");
   printf("-----------------------------------\n");
@@ -174,6 +195,746 @@ bst_print_tree(test_tree);
 bst_print_items(test_items);
 ENDTEST
 
+TEST(test_tree_range, "Visit items in a key range (C..K)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_range(test_tree, 'C', 'K', bst_visit_add_to_items, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_range_outside, "Visit items in a range outside the tree (P..Z)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_range(test_tree, 'P', 'Z', bst_visit_add_to_items, test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_neighbours, "Floor, ceil, predecessor and successor lookups")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values, traversal_data_count);
+bst_insert(&test_tree, 'H', create_integer_content(6));
+bst_print_tree(test_tree);
+bst_print_lookup_result("Floor of C", bst_floor(test_tree, 'C'));
+bst_print_lookup_result("Floor of G", bst_floor(test_tree, 'G'));
+bst_print_lookup_result("Floor of @", bst_floor(test_tree, '@'));
+bst_print_lookup_result("Ceil of C", bst_ceil(test_tree, 'C'));
+bst_print_lookup_result("Ceil of F", bst_ceil(test_tree, 'F'));
+bst_print_lookup_result("Ceil of I", bst_ceil(test_tree, 'I'));
+bst_print_lookup_result("Predecessor of D", bst_predecessor(test_tree, 'D'));
+bst_print_lookup_result("Predecessor of A", bst_predecessor(test_tree, 'A'));
+bst_print_lookup_result("Successor of C", bst_successor(test_tree, 'C'));
+bst_print_lookup_result("Successor of E", bst_successor(test_tree, 'E'));
+bst_print_lookup_result("Successor of H", bst_successor(test_tree, 'H'));
+ENDTEST
+
+TEST(test_tree_build_from_sorted, "Build a balanced tree from sorted items (A..G)")
+bst_node_content_t values[7];
+for (int i = 0; i < sorted_data_count; i++) {
+  values[i] = create_integer_content(sorted_values[i]);
+}
+bst_build_from_sorted(&test_tree, sorted_keys, values, sorted_data_count);
+bst_print_tree(test_tree);
+bst_delete(&test_tree, 'D');
+bst_insert(&test_tree, 'H', create_integer_content(8));
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_insert_batch, "Insert an unsorted batch (G,A,F,G,H,B)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values, traversal_data_count);
+bst_print_tree(test_tree);
+bst_node_content_t values[6];
+for (int i = 0; i < batch_data_count; i++) {
+  values[i] = create_integer_content(batch_values[i]);
+}
+bst_insert_batch(&test_tree, batch_keys, values, batch_data_count);
+bst_inorder(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_balance, "Balance a degenerate tree (A..G)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, sorted_keys, sorted_values, sorted_data_count);
+bst_print_tree(test_tree);
+bst_balance(&test_tree);
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_union, "Union of two trees, shared keys take the second value")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values,
+                traversal_data_count);
+bst_node_t *other;
+bst_init(&other);
+bst_insert_many(&other, batch_keys, batch_values, batch_data_count);
+bst_union(&test_tree, &other);
+bst_inorder(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+printf("Second tree after union: %s\n", other == NULL ? "empty" : "not empty");
+ENDTEST
+
+TEST(test_tree_split, "Split the tree at K and below the smallest key")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_node_t *lo;
+bst_node_t *hi;
+bst_split(&test_tree, 'K', &lo, &hi);
+bst_print_tree(lo);
+bst_print_tree(hi);
+bst_dispose(&lo);
+bst_split(&hi, '0', &lo, &hi);
+printf("Split below the smallest key: lo %s, hi root %c\n",
+       lo == NULL ? "empty" : "not empty", (int)hi->key);
+bst_dispose(&hi);
+ENDTEST
+
+TEST(test_tree_join, "Join split halves back together")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_node_t *lo;
+bst_node_t *hi;
+bst_split(&test_tree, 'E', &lo, &hi);
+bst_join(&test_tree, &lo, &hi);
+bst_print_tree(test_tree);
+bst_split(&test_tree, 'Q', &lo, &hi);
+bst_join(&test_tree, &lo, &hi);
+bst_inorder(test_tree, test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_parallel_traversals, "Traverse the tree in parallel (4 threads)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_pool_t *pool = bst_pool_create(4);
+bst_preorder_parallel(test_tree, test_items, pool);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_inorder_parallel(test_tree, test_items, pool);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_postorder_parallel(test_tree, test_items, pool);
+bst_print_items(test_items);
+bst_dispose_parallel(&test_tree, pool);
+bst_print_tree(test_tree);
+bst_pool_destroy(pool);
+ENDTEST
+
+TEST(test_tree_parallel_random, "Compare parallel and sequential traversals")
+bst_init(&test_tree);
+unsigned int seed = 4242;
+for (int i = 0; i < 100; i++) {
+  seed = seed * 1103515245 + 12345;
+  bst_insert(&test_tree, 'A' + (seed >> 16) % 58, create_integer_content(i));
+}
+bst_pool_t *pool = bst_pool_create(3);
+void (*sequential[])(bst_node_t *, bst_items_t *) = {
+    bst_preorder, bst_inorder, bst_postorder};
+void (*parallel[])(bst_node_t *, bst_items_t *, bst_pool_t *) = {
+    bst_preorder_parallel, bst_inorder_parallel, bst_postorder_parallel};
+int mismatches = 0;
+for (int order = 0; order < 3; order++) {
+  bst_items_t *expected = bst_init_items();
+  sequential[order](test_tree, expected);
+  parallel[order](test_tree, test_items, pool);
+  if (expected->size != test_items->size) {
+    mismatches++;
+  }
+  for (int i = 0; i < expected->size && i < test_items->size; i++) {
+    if (expected->nodes[i] != test_items->nodes[i]) {
+      mismatches++;
+    }
+  }
+  bst_reset_items(expected);
+  free(expected);
+  bst_reset_items(test_items);
+}
+printf("Mismatches against sequential traversals: %d\n", mismatches);
+bst_dispose_parallel(&test_tree, pool);
+bst_pool_destroy(pool);
+ENDTEST
+
+TEST(test_tree_frozen_search, "Search in a frozen snapshot (H, A, O, X)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_frozen_t *frozen = bst_freeze(test_tree);
+printf("Frozen keys:");
+for (int i = 1; i <= frozen->size; i++) {
+  printf(" %c", (int)frozen->keys[i]);
+}
+printf("\n");
+const char lookups[] = {'H', 'A', 'O', 'X'};
+for (int i = 0; i < 4; i++) {
+  bst_node_content_t *result = NULL;
+  bst_frozen_search(frozen, lookups[i], &result);
+  bst_print_search_result(result);
+}
+int mismatches = 0;
+for (int key = 0; key < 128; key++) {
+  bst_node_content_t *expected = NULL;
+  bst_node_content_t *result = NULL;
+  bool found = bst_search(test_tree, key, &expected);
+  if (bst_frozen_search(frozen, key, &result) != found || result != expected) {
+    mismatches++;
+  }
+}
+printf("Mismatches against bst_search: %d\n", mismatches);
+bst_frozen_dispose(&frozen);
+ENDTEST
+
+TEST(test_tree_save_load, "Save the tree to a file and load it back")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert(&test_tree, 'W', create_character_content("Gandalf", Wizard, 20));
+bst_node_t *loaded;
+bst_init(&loaded);
+printf("Saved: %s\n", bst_save(test_tree, "test_tree.bin") ? "yes" : "no");
+printf("Loaded: %s\n", bst_load(&loaded, "test_tree.bin") ? "yes" : "no");
+bst_print_tree(loaded);
+bst_preorder(loaded, test_items);
+bst_print_items(test_items);
+bst_dispose(&loaded);
+remove("test_tree.bin");
+ENDTEST
+
+TEST(test_tree_mapped_search, "Search in a memory-mapped file (H, A, W, X)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert(&test_tree, 'W', create_character_content("Gandalf", Wizard, 20));
+bst_save(test_tree, "test_tree.bin");
+bst_mapped_t *mapped = bst_map("test_tree.bin");
+const char lookups[] = {'H', 'A', 'W', 'X'};
+for (int i = 0; i < 4; i++) {
+  bst_node_content_t result;
+  character_t character;
+  bool found = bst_mapped_search(mapped, lookups[i], &result, &character);
+  bst_print_search_result(found ? &result : NULL);
+}
+bst_unmap(&mapped);
+remove("test_tree.bin");
+ENDTEST
+
+TEST(test_tree_load_invalid, "Load a missing and a truncated file")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_save(test_tree, "test_tree.bin");
+printf("Missing file: %s\n",
+       bst_load(&test_tree, "missing.bin") ? "loaded" : "rejected");
+bst_print_tree(test_tree);
+FILE *file = fopen("test_tree.bin", "r+b");
+fseek(file, 0, SEEK_END);
+long length = ftell(file);
+fclose(file);
+char *bytes = malloc(length);
+file = fopen("test_tree.bin", "rb");
+fread(bytes, 1, length, file);
+fclose(file);
+file = fopen("test_tree.bin", "wb");
+fwrite(bytes, 1, length - 4, file);
+fclose(file);
+free(bytes);
+printf("Truncated file: %s\n",
+       bst_load(&test_tree, "test_tree.bin") ? "loaded" : "rejected");
+printf("Truncated map: %s\n",
+       bst_map("test_tree.bin") != NULL ? "mapped" : "rejected");
+remove("test_tree.bin");
+ENDTEST
+
+TEST(test_tree_stats, "Shape statistics of a balanced and a degenerate tree")
+bst_init(&test_tree);
+bst_stats_t stats;
+bst_stats(test_tree, &stats);
+bst_print_stats(&stats);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_stats(test_tree, &stats);
+bst_print_stats(&stats);
+bst_dispose(&test_tree);
+bst_insert_many(&test_tree, sorted_keys, sorted_values, sorted_data_count);
+bst_stats(test_tree, &stats);
+bst_print_stats(&stats);
+ENDTEST
+
+#ifdef BST_COUNTERS
+
+TEST(test_tree_counters, "Count comparisons and visits (search A, X, insert P)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_node_content_t *result = NULL;
+bst_counters = (bst_counters_t){0, 0};
+bst_search(test_tree, 'A', &result);
+printf("Search A: %ld comparisons, %ld visits\n", bst_counters.comparisons,
+       bst_counters.visits);
+bst_counters = (bst_counters_t){0, 0};
+bst_search(test_tree, 'X', &result);
+printf("Search X: %ld comparisons, %ld visits\n", bst_counters.comparisons,
+       bst_counters.visits);
+bst_counters = (bst_counters_t){0, 0};
+bst_insert(&test_tree, 'P', create_integer_content(17));
+printf("Insert P: %ld comparisons, %ld visits\n", bst_counters.comparisons,
+       bst_counters.visits);
+ENDTEST
+
+#endif // BST_COUNTERS
+
+const bst_key_t wide_keys[] = {1000000, -5, 70000, 2147483647, -2147483647 - 1,
+                               300, 65, 0};
+const int wide_data_count = 8;
+
+TEST(test_tree_wide_keys, "Insert, search and delete full-width integer keys")
+bst_init(&test_tree);
+for (int i = 0; i < wide_data_count; i++) {
+  bst_insert_key(&test_tree, wide_keys[i], create_integer_content(i), NULL);
+}
+bst_print_keys(test_tree);
+bst_node_content_t *result = NULL;
+const bst_key_t lookups[] = {70000, -2147483647 - 1, 65, 'A' + 256, 1000001};
+for (int i = 0; i < 5; i++) {
+  if (bst_search_key(test_tree, lookups[i], &result, NULL)) {
+    printf("Search %lld: %d\n", (long long)lookups[i], *(int *)result->value);
+  } else {
+    printf("Search %lld: not found\n", (long long)lookups[i]);
+  }
+}
+bst_delete_key(&test_tree, 1000000, NULL);
+bst_delete_key(&test_tree, -2147483647 - 1, NULL);
+bst_delete_key(&test_tree, 12345, NULL);
+bst_print_keys(test_tree);
+printf("Char search A after deletes: %s\n",
+       bst_search(test_tree, 'A', &result) ? "found" : "not found");
+ENDTEST
+
+// Sestupne usporiadanie
+int compare_descending(bst_key_t a, bst_key_t b) { return (b > a) - (b < a); }
+
+// Zlozeny kluc: vyssich 16 bitov (trieda) vzostupne, nizsich 16 bitov
+// (uroven) zostupne
+int compare_class_level(bst_key_t a, bst_key_t b) {
+  int a_class = (int)(a >> 16), b_class = (int)(b >> 16);
+  if (a_class != b_class) {
+    return (a_class > b_class) - (a_class < b_class);
+  }
+  return compare_descending(a & 0xffff, b & 0xffff);
+}
+
+TEST(test_tree_custom_compare, "Trees ordered by a custom key comparison")
+bst_init(&test_tree);
+for (int i = 0; i < wide_data_count; i++) {
+  bst_insert_key(&test_tree, wide_keys[i], create_integer_content(i),
+                 compare_descending);
+}
+bst_print_keys(test_tree);
+bst_node_content_t *result = NULL;
+printf("Search 300: %s\n",
+       bst_search_key(test_tree, 300, &result, compare_descending)
+           ? "found"
+           : "not found");
+bst_delete_key(&test_tree, 70000, compare_descending);
+bst_delete_key(&test_tree, 2147483647, compare_descending);
+bst_print_keys(test_tree);
+bst_dispose(&test_tree);
+const bst_key_t composite[] = {(2 << 16) | 7, (1 << 16) | 3, (2 << 16) | 40,
+                               (1 << 16) | 50, (3 << 16) | 1, (2 << 16) | 9};
+for (int i = 0; i < 6; i++) {
+  bst_insert_key(&test_tree, composite[i], create_integer_content(i),
+                 compare_class_level);
+}
+bst_inorder(test_tree, test_items);
+printf("Class/level in order:");
+for (int i = 0; i < test_items->size; i++) {
+  printf(" %d/%d", (int)(test_items->nodes[i]->key >> 16),
+         (int)(test_items->nodes[i]->key & 0xffff));
+}
+printf("\n");
+printf("Search 2/40: %d\n",
+       bst_search_key(test_tree, (2 << 16) | 40, &result, compare_class_level)
+           ? *(int *)result->value
+           : -1);
+ENDTEST
+
+// Retaz uzlov bez hodnot, kazdy dalsi je pravym potomkom predchadzajuceho
+bst_node_t *make_dump_chain(int count) {
+  bst_node_t *nodes = calloc(count, sizeof(bst_node_t));
+  for (int i = 0; i < count; i++) {
+    nodes[i].key = 'a' + i % 26;
+    nodes[i].right = i + 1 < count ? &nodes[i + 1] : NULL;
+  }
+  return nodes;
+}
+
+TEST(test_tree_dump, "Dump trees as text and JSON into a buffer")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values,
+                traversal_data_count);
+bst_insert(&test_tree, 'F',
+           create_character_content("Jaskier \"Dandelion\"", Bard, 7));
+dump_buffer_t dump;
+dump_init(&dump, NULL);
+bst_dump_tree(&dump, test_tree);
+printf("%.*s", (int)dump.size, dump.data);
+dump.size = 0;
+bst_dump_json(&dump, test_tree);
+printf("%.*s\n", (int)dump.size, dump.data);
+dump.size = 0;
+bst_dump_json(&dump, NULL);
+printf("%.*s\n", (int)dump.size, dump.data);
+dump.size = 0;
+bst_node_t *chain = make_dump_chain(2000);
+bst_dump_tree(&dump, chain);
+long lines = 0;
+for (size_t i = 0; i < dump.size; i++) {
+  lines += dump.data[i] == '\n';
+}
+printf("Text dump of a 2000-node chain: %zu bytes, %ld lines\n", dump.size,
+       lines);
+free(chain);
+dump.size = 0;
+chain = make_dump_chain(1000000);
+bst_dump_json(&dump, chain);
+printf("JSON dump of a 1000000-node chain: %zu bytes, ends with %.*s\n",
+       dump.size, 16, dump.data + dump.size - 16);
+free(chain);
+printf("Dump failed: %s\n", dump.failed ? "yes" : "no");
+dump_dispose(&dump);
+ENDTEST
+
+TEST(test_trace_roundtrip, "Record calls into a trace file and load them back")
+bst_init(&test_tree);
+int value = -42;
+bst_node_content_t integer_content = {.type = INTEGER, .value = &value};
+bst_node_content_t character_content =
+    create_character_content("Yennefer", Wizard, 9);
+bool started = trace_start("test_trace.bin");
+trace_lock();
+uint32_t handle = trace_handle(&test_tree);
+trace_record_bst(TRACE_BST_INIT, handle, 0, NULL, false);
+trace_record_bst(TRACE_BST_INSERT, handle, 'H', &integer_content, false);
+trace_record_bst(TRACE_BST_INSERT, handle, 300000, &character_content, false);
+trace_record_bst(TRACE_BST_SEARCH, handle, 'H', NULL, false);
+trace_record_bst(TRACE_BST_DELETE, handle, -7, NULL, true);
+trace_record_bst(TRACE_BST_REPLACE, handle, 0, NULL, false);
+trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+trace_record_ht(TRACE_HT_INIT, trace_handle(&value), NULL, 101);
+trace_record_ht(TRACE_HT_INCREMENT, trace_handle(&value), "Monero", 2.5);
+trace_unlock();
+trace_stop();
+free(character_content.value);
+
+trace_t trace;
+if (started && trace_load(&trace, "test_trace.bin")) {
+  printf("Loaded %zu operations, %u handles\n", trace.count, trace.handles);
+  for (size_t i = 0; i < trace.count; i++) {
+    const trace_op_t *op = &trace.ops[i];
+    printf("%s handle %u", trace_kind_name(op->kind), op->handle);
+    if (op->kind == TRACE_BST_INSERT || op->kind == TRACE_BST_SEARCH ||
+        op->kind == TRACE_BST_DELETE)
+      printf(" key %lld", (long long)op->key);
+    if (op->value_type == TRACE_VALUE_INTEGER)
+      printf(" value %lld", (long long)op->integer);
+    if (op->value_type == TRACE_VALUE_CHARACTER)
+      printf(" character %s (%lld, %u)", op->text, (long long)op->integer,
+             op->level);
+    if (op->kind == TRACE_HT_INIT)
+      printf(" size %lld", (long long)op->integer);
+    if (op->kind == TRACE_HT_INCREMENT)
+      printf(" key %s value %.2f", op->text, op->number);
+    if (op->flags & TRACE_CUSTOM_COMPARE)
+      printf(" (custom compare)");
+    printf("\n");
+  }
+  trace_dispose(&trace);
+} else {
+  printf("Trace could not be recorded\n");
+}
+remove("test_trace.bin");
+ENDTEST
+
+TEST(test_tree_allocator, "Allocate nodes with counting and arena allocators")
+counting_allocator_t counting;
+counting_init(&counting, NULL);
+const allocator_t *allocator = &counting.allocator;
+bst_init(&test_tree);
+bst_insert_many_with(&test_tree, base_keys, base_values, base_data_count,
+                     allocator);
+bst_delete_key_with(&test_tree, 'H', NULL, allocator);
+bst_delete_key_with(&test_tree, 'A', NULL, allocator);
+bst_replace_by_rightmost_with(test_tree, &test_tree->left, allocator);
+bst_items_t items = {NULL, 0, 0, allocator};
+bst_inorder(test_tree, &items);
+printf("Counting: %ld allocations, %ld releases, %d nodes in order\n",
+       atomic_load(&counting.allocations), atomic_load(&counting.releases),
+       items.size);
+bst_items_dispose(&items);
+bst_dispose_with(&test_tree, allocator);
+printf("After dispose: %ld releases, %ld live bytes\n",
+       atomic_load(&counting.releases), atomic_load(&counting.live_bytes));
+
+bst_node_t *lo;
+bst_node_t *hi;
+bst_insert_many_with(&test_tree, base_keys, base_values, base_data_count,
+                     allocator);
+bst_split(&test_tree, 'H', &lo, &hi);
+bst_insert_many_with(&hi, additional_keys, additional_values,
+                     additional_data_count, allocator);
+bst_union_with(&lo, &hi, allocator);
+bst_print_tree(lo);
+bst_dispose_with(&lo, allocator);
+printf("After split, union and dispose: %ld allocations, %ld releases, "
+       "%ld live bytes\n",
+       atomic_load(&counting.allocations), atomic_load(&counting.releases),
+       atomic_load(&counting.live_bytes));
+
+arena_t arena;
+arena_init(&arena, 4096, allocator);
+bst_insert_many_with(&test_tree, base_keys, base_values, base_data_count,
+                     &arena.allocator);
+bst_insert_many_with(&test_tree, additional_keys, additional_values,
+                     additional_data_count, &arena.allocator);
+bst_delete_key_with(&test_tree, 'H', NULL, &arena.allocator);
+bst_print_tree(test_tree);
+long before = atomic_load(&counting.allocations);
+bst_dispose_with(&test_tree, &arena.allocator);
+arena_reset(&arena);
+bst_insert_many_with(&test_tree, sorted_keys, sorted_values, sorted_data_count,
+                     &arena.allocator);
+printf("Arena chunks after reset and reuse: %ld new\n",
+       atomic_load(&counting.allocations) - before);
+bst_dispose_with(&test_tree, &arena.allocator);
+arena_dispose(&arena);
+printf("After arena dispose: %ld live bytes\n",
+       atomic_load(&counting.live_bytes));
+ENDTEST
+
+#ifdef BST_ORDER_STATISTICS
+
+TEST(test_tree_select, "Select the k-th smallest item (0, 7, 20, 21)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_print_tree(test_tree);
+const int ranks[] = {0, 7, 20, 21};
+printf("Selected items:\n");
+for (int i = 0; i < 4; i++) {
+  bst_node_t *node = bst_select(test_tree, ranks[i]);
+  if (node != NULL) {
+    bst_print_node(node);
+  } else {
+    printf("[NULL]");
+  }
+}
+printf("\n");
+ENDTEST
+
+TEST(test_tree_rank_count, "Rank and count keys in ranges (A..Z)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_delete(&test_tree, 'L');
+bst_delete(&test_tree, 'A');
+bst_print_tree(test_tree);
+printf("Rank of M: %d\n", bst_rank(test_tree, 'M'));
+printf("Keys in <C,P>: %d\n", bst_count_range(test_tree, 'C', 'P'));
+printf("Mismatches against inorder: %d\n",
+       bst_count_order_mismatches(test_tree, 'A', 'Z'));
+ENDTEST
+
+TEST(test_tree_order_statistics_random,
+     "Keep subtree sizes through random inserts and deletes")
+bst_init(&test_tree);
+unsigned int seed = 12345;
+int mismatches = 0;
+for (int i = 0; i < 200; i++) {
+  seed = seed * 1103515245 + 12345;
+  char key = 'A' + (seed >> 16) % 26;
+  if ((seed >> 8) % 3 == 0) {
+    bst_delete(&test_tree, key);
+  } else {
+    bst_insert(&test_tree, key, create_integer_content(i));
+  }
+  mismatches += bst_count_order_mismatches(test_tree, 'A', 'Z');
+}
+bst_print_tree(test_tree);
+printf("Mismatches against inorder: %d\n", mismatches);
+ENDTEST
+
+TEST(test_tree_order_statistics_batch,
+     "Keep subtree sizes through random batch inserts and deletes")
+bst_init(&test_tree);
+unsigned int seed = 54321;
+int mismatches = 0;
+for (int i = 0; i < 200; i++) {
+  seed = seed * 1103515245 + 12345;
+  char keys[3];
+  bst_node_content_t values[3];
+  int count = 1 + (seed >> 8) % 3;
+  for (int k = 0; k < count; k++) {
+    keys[k] = 'A' + ((seed >> 16) + 7 * k) % 26;
+    values[k] = create_integer_content(i);
+  }
+  if ((seed >> 12) % 3 == 0) {
+    for (int k = 0; k < count; k++) {
+      bst_delete(&test_tree, keys[k]);
+      bst_free(values[k].value);
+    }
+  } else {
+    bst_insert_batch(&test_tree, keys, values, count);
+  }
+  mismatches += bst_count_order_mismatches(test_tree, 'A', 'Z');
+}
+bst_print_tree(test_tree);
+printf("Mismatches against inorder: %d\n", mismatches);
+ENDTEST
+
+TEST(test_tree_split_join_random, "Keep subtree sizes through random splits and joins")
+bst_init(&test_tree);
+for (char key = 'A'; key <= 'Z'; key++) {
+  bst_insert(&test_tree, key, create_integer_content(key));
+}
+unsigned int seed = 777;
+int mismatches = 0;
+for (int i = 0; i < 100; i++) {
+  seed = seed * 1103515245 + 12345;
+  bst_node_t *lo;
+  bst_node_t *hi;
+  bst_split(&test_tree, 'A' + (seed >> 16) % 27, &lo, &hi);
+  mismatches += bst_count_order_mismatches(lo, 'A', 'Z');
+  mismatches += bst_count_order_mismatches(hi, 'A', 'Z');
+  bst_join(&test_tree, &lo, &hi);
+  mismatches += bst_count_order_mismatches(test_tree, 'A', 'Z');
+}
+bst_stats_t stats;
+bst_stats(test_tree, &stats);
+printf("Mismatches against inorder: %d, count: %d, height: %d\n", mismatches,
+       stats.count, stats.height);
+ENDTEST
+
+#endif // BST_ORDER_STATISTICS
+
+#ifndef SPLAY
+
+TEST(test_tree_auto_rebalance, "Rebalance automatically on ascending inserts (factor 2)")
+bst_init(&test_tree);
+bst_rebalance_t policy = {2, 0};
+for (char key = 'A'; key <= 'Z'; key++) {
+  bst_insert_key_rebalance(&test_tree, key,
+                           create_integer_content(key - 'A' + 1), NULL, NULL,
+                           &policy);
+}
+bst_stats_t stats;
+bst_stats(test_tree, &stats);
+bst_print_stats(&stats);
+#ifdef BST_ORDER_STATISTICS
+printf("Mismatches against inorder: %d\n",
+       bst_count_order_mismatches(test_tree, 'A', 'Z'));
+#endif // BST_ORDER_STATISTICS
+bst_insert(&test_tree, '[', create_integer_content(27));
+bst_stats(test_tree, &stats);
+printf("Height after a further insert with the policy off: %d\n",
+       stats.height);
+ENDTEST
+
+#endif // SPLAY
+
+#if defined(ITER) || defined(SPLAY)
+
+TEST(test_tree_preorder_morris, "Traverse the tree using Morris preorder")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values, traversal_data_count);
+bst_preorder_morris(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_inorder_morris, "Traverse the tree using Morris inorder")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, traversal_keys, traversal_values, traversal_data_count);
+bst_inorder_morris(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_dispose_flatten, "Dispose the whole tree using rotations")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_print_tree(test_tree);
+bst_dispose_flatten(&test_tree);
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_deep_traversals, "Traverse and dispose a degenerate tree deeper than MAXSTACK")
+counting_allocator_t counting;
+counting_init(&counting, NULL);
+bst_init(&test_tree);
+for (bst_key_t key = 1; key <= DEEP_TREE_COUNT; key++) {
+  bst_node_content_t content = {.value = NULL, .type = INTEGER};
+  bst_insert_key_with(&test_tree, key, content, NULL, &counting.allocator);
+}
+bst_stats_t stats;
+bst_stats(test_tree, &stats);
+printf("Nodes: %d, height: %d\n", stats.count, stats.height);
+
+const char *names[] = {"Preorder", "Inorder", "Postorder"};
+void (*traversals[])(bst_node_t *, bst_items_t *) = {
+    bst_preorder, bst_inorder, bst_postorder};
+for (int t = 0; t < 3; t++) {
+  bst_items_t items = {NULL, 0, 0, NULL};
+  traversals[t](test_tree, &items);
+  bool seen[DEEP_TREE_COUNT + 1] = {false};
+  int distinct = 0;
+  for (int i = 0; i < items.size; i++) {
+    bst_key_t key = items.nodes[i]->key;
+    if (key >= 1 && key <= DEEP_TREE_COUNT && !seen[key]) {
+      seen[key] = true;
+      distinct++;
+    }
+  }
+  printf("%s: %d items, %d distinct keys\n", names[t], items.size, distinct);
+  bst_items_dispose(&items);
+}
+
+bst_dispose_with(&test_tree, &counting.allocator);
+printf("After dispose: %ld allocations, %ld releases, %ld live bytes\n",
+       atomic_load(&counting.allocations), atomic_load(&counting.releases),
+       atomic_load(&counting.live_bytes));
+ENDTEST
+
+#endif // ITER || SPLAY
+
+#ifdef SPLAY
+
+TEST(test_tree_splay_search, "Searched keys move to the root (A, O, X)")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_node_content_t *first = NULL;
+bst_node_content_t *result = NULL;
+bst_search_splay(&test_tree, 'A', &first, NULL);
+bst_print_search_result(first);
+bst_print_tree(test_tree);
+bst_search_splay(&test_tree, 'O', &result, NULL);
+bst_search_splay(&test_tree, 'X', &result, NULL);
+printf("First result after more searches: ");
+bst_print_node_content(first);
+printf("\n");
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_splay_sorted, "Sorted inserts and a deep search")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, sorted_keys, sorted_values, sorted_data_count);
+bst_print_tree(test_tree);
+bst_node_content_t *result = NULL;
+bst_search_splay(&test_tree, 'A', &result, NULL);
+bst_print_search_result(result);
+bst_print_tree(test_tree);
+ENDTEST
+
+#endif // SPLAY
+
 #ifdef EXA
 
 TEST(test_letter_count, "Count letters");
@@ -182,6 +943,83 @@ letter_count(&test_tree, "abBcCc_ 123 *");
 bst_print_tree(test_tree);
 ENDTEST
 
+TEST(test_letter_kernels, "Vector histogram kernels agree with the scalar loop")
+bst_init(&test_tree);
+char input[4099];
+unsigned int seed = 99;
+for (int i = 0; i < 4099; i++) {
+  seed = seed * 1103515245 + 12345;
+  input[i] = (char)(seed >> 16);
+}
+const letter_kernel_t kernels[] = {LETTER_KERNEL_SSE2, LETTER_KERNEL_AVX2};
+int mismatches = 0;
+for (int offset = 0; offset < 3; offset++) {
+  int expected[256] = {0};
+  letter_count_set_kernel(LETTER_KERNEL_SCALAR);
+  letter_histogram(input + offset, sizeof(input) - offset, expected);
+  for (int k = 0; k < 2; k++) {
+    int histogram[256] = {0};
+    // Nepodporovane jadro sa preskoci
+    if (!letter_count_set_kernel(kernels[k])) {
+      continue;
+    }
+    letter_histogram(input + offset, sizeof(input) - offset, histogram);
+    for (int c = 0; c < 256; c++) {
+      mismatches += histogram[c] != expected[c];
+    }
+  }
+}
+letter_count_set_kernel(LETTER_KERNEL_AUTO);
+int total = 0;
+int expected[256] = {0};
+letter_histogram(input, sizeof(input), expected);
+for (int c = 0; c < 256; c++) {
+  total += expected[c];
+}
+printf("Mismatches against scalar: %d, counted bytes: %d\n", mismatches, total);
+ENDTEST
+
+TEST(test_letter_count_stream, "Count letters of a file in parallel chunks")
+bst_init(&test_tree);
+// Vstup dlhsi ako jedna cast, aby sa pocitalo vo viacerych ulohach
+const char pattern[] = "abBcCc_ 123 *";
+const int repeats = 100000;
+FILE *file = fopen("test_letters.txt", "w");
+for (int i = 0; i < repeats; i++) {
+  fputs(pattern, file);
+}
+fclose(file);
+bst_node_t *expected = NULL;
+letter_count(&expected, (char *)pattern);
+bst_pool_t *pool = bst_pool_create(4);
+letter_count_file(&test_tree, "test_letters.txt", pool);
+bst_node_t *from_fd = NULL;
+int fd = open("test_letters.txt", O_RDONLY);
+letter_count_fd(&from_fd, fd, pool);
+close(fd);
+int mismatches = 0;
+for (int c = 0; c < 256; c++) {
+  bst_node_content_t *want = NULL;
+  bst_node_content_t *got = NULL;
+  bst_node_content_t *got_fd = NULL;
+  bst_search(expected, c, &want);
+  bst_search(test_tree, c, &got);
+  bst_search(from_fd, c, &got_fd);
+  int count = want != NULL ? *(int *)want->value * repeats : 0;
+  mismatches += (got != NULL ? *(int *)got->value : 0) != count;
+  mismatches += (got_fd != NULL ? *(int *)got_fd->value : 0) != count;
+}
+bst_dispose(&from_fd);
+bool missing = letter_count_file(&from_fd, "test_letters.missing", pool);
+printf("Mismatches against letter_count: %d, missing file counted: %s\n",
+       mismatches, missing ? "yes" : "no");
+bst_pool_destroy(pool);
+bst_dispose(&expected);
+bst_dispose(&from_fd);
+remove("test_letters.txt");
+bst_print_tree(test_tree);
+ENDTEST
+
 #endif // EXA
 
 int main(int argc, char *argv[]) {
@@ -206,8 +1044,61 @@ int main(int argc, char *argv[]) {
   test_tree_preorder();
   test_tree_inorder();
   test_tree_postorder();
+  test_tree_range();
+  test_tree_range_outside();
+  test_tree_neighbours();
+  test_tree_build_from_sorted();
+  test_tree_insert_batch();
+  test_tree_balance();
+  test_tree_union();
+  test_tree_split();
+  test_tree_join();
+  test_tree_parallel_traversals();
+  test_tree_parallel_random();
+#ifndef SPLAY
+  // Snimok drzi ukazatele do uzlov, ktore hladanie v splay strome presuva
+  test_tree_frozen_search();
+#endif // SPLAY
+  test_tree_save_load();
+  test_tree_mapped_search();
+  test_tree_load_invalid();
+  test_tree_stats();
+#ifdef BST_COUNTERS
+  test_tree_counters();
+#endif // BST_COUNTERS
+  test_tree_wide_keys();
+  test_tree_custom_compare();
+  test_tree_dump();
+  test_trace_roundtrip();
+  test_tree_allocator();
+
+#ifdef BST_ORDER_STATISTICS
+  test_tree_select();
+  test_tree_rank_count();
+  test_tree_order_statistics_random();
+  test_tree_order_statistics_batch();
+  test_tree_split_join_random();
+#endif // BST_ORDER_STATISTICS
+
+#ifndef SPLAY
+  test_tree_auto_rebalance();
+#endif // SPLAY
+
+#if defined(ITER) || defined(SPLAY)
+  test_tree_preorder_morris();
+  test_tree_inorder_morris();
+  test_tree_dispose_flatten();
+  test_tree_deep_traversals();
+#endif // ITER || SPLAY
+
+#ifdef SPLAY
+  test_tree_splay_search();
+  test_tree_splay_sorted();
+#endif // SPLAY
 
 #ifdef EXA
   test_letter_count();
+  test_letter_kernels();
+  test_letter_count_stream();
 #endif // EXA
 }
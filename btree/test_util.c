@@ -1,57 +1,21 @@
 #include "test_util.h"
+#include "dump.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-const char *subtree_prefix = "  |";
-const char *space_prefix = "   ";
-
-char *make_prefix(char *prefix, const char *suffix) {
-  char *result = (char *)malloc(strlen(prefix) + strlen(suffix) + 1);
-  strcpy(result, prefix);
-  result = strcat(result, suffix);
-  return result;
-}
-
-void bst_print_subtree(bst_node_t *tree, char *prefix, direction_t from) {
-  if (tree != NULL) {
-    char *current_subtree_prefix = make_prefix(prefix, subtree_prefix);
-    char *current_space_prefix = make_prefix(prefix, space_prefix);
-
-    if (from == left) {
-      printf("%s\n", current_subtree_prefix);
-    }
-
-    bst_print_subtree(
-        tree->right,
-        from == left ? current_subtree_prefix : current_space_prefix, right);
-
-    printf("%s  +-", prefix);
-    bst_print_node(tree);
-    printf("\n");
-
-    bst_print_subtree(
-        tree->left,
-        from == right ? current_subtree_prefix : current_space_prefix, left);
-
-    if (from == right) {
-      printf("%s\n", current_subtree_prefix);
-    }
-
-    free(current_space_prefix);
-    free(current_subtree_prefix);
-  }
-}
-
 void bst_print_tree(bst_node_t *tree) {
-  printf("Binary tree structure:\n");
-  printf("\n");
+  dump_buffer_t dump;
+  dump_init(&dump, stdout);
+  dump_text(&dump, "Binary tree structure:\n\n");
   if (tree != NULL) {
-    bst_print_subtree(tree, "", none);
+    bst_dump_tree(&dump, tree);
   } else {
-    printf("Tree is empty\n");
+    dump_text(&dump, "Tree is empty\n");
   }
-  printf("\n");
+  dump_char(&dump, '\n');
+  dump_flush(&dump);
+  dump_dispose(&dump);
 }
 
 bst_items_t* bst_init_items() {
@@ -59,6 +23,7 @@ bst_items_t* bst_init_items() {
   items->capacity = 0;
   items->nodes = NULL;
   items->size = 0;
+  items->allocator = NULL;
   return items;
 }
 
@@ -84,11 +49,26 @@ void bst_reset_items (bst_items_t *items) {
     {
       free(items->nodes);
     }
+    items->nodes = NULL;
     items->capacity = 0;
     items->size = 0;
   }
 }
 
+void bst_visit_add_to_items(bst_node_t *node, void *items) {
+  bst_add_node_to_items(node, (bst_items_t *)items);
+}
+
+void bst_print_lookup_result(const char *label, bst_node_t *node) {
+  printf("%s: ", label);
+  if (node != NULL) {
+    bst_print_node(node);
+  } else {
+    printf("NULL");
+  }
+  printf("\n");
+}
+
 bst_node_content_t create_integer_content(int value)
 {
   bst_node_content_t result = {
@@ -99,6 +79,25 @@ bst_node_content_t create_integer_content(int value)
   return result;
 }
 
+/*
+ * Postava se jménem v jednom bloku, aby ji bst_dispose uvolnil celou.
+ */
+bst_node_content_t create_character_content(const char *name,
+                                            character_class_t character_class,
+                                            unsigned char level)
+{
+  character_t *character = malloc(sizeof(character_t) + strlen(name) + 1);
+  character->name = (char *)(character + 1);
+  strcpy(character->name, name);
+  character->character_class = character_class;
+  character->level = level;
+  bst_node_content_t result = {
+    .type = CHARACTER_T,
+    .value = character
+  };
+  return result;
+}
+
 void bst_insert_many(bst_node_t **tree, const char keys[], const int values[],
                      int count) {
   for (int i = 0; i < count; i++) {
@@ -106,3 +105,79 @@ void bst_insert_many(bst_node_t **tree, const char keys[], const int values[],
     bst_insert(tree, keys[i], create_integer_content(values[i]));
   }
 }
+
+void bst_insert_many_with(bst_node_t **tree, const char keys[],
+                          const int values[], int count,
+                          const struct allocator *allocator) {
+  for (int i = 0; i < count; i++) {
+    bst_insert_key_with(tree, keys[i], create_integer_content(values[i]), NULL,
+                        allocator);
+  }
+}
+
+#ifdef BST_ORDER_STATISTICS
+/*
+ * Porovná bst_select, bst_rank a bst_count_range s výsledkem prostého
+ * inorder průchodu pro všechny klíče z <lo, hi>. Vrací počet neshod.
+ */
+int bst_count_order_mismatches(bst_node_t *tree, char lo, char hi) {
+  int mismatches = 0;
+  bst_items_t *items = bst_init_items();
+  bst_inorder(tree, items);
+
+  if (bst_select(tree, -1) != NULL || bst_select(tree, items->size) != NULL) {
+    mismatches++;
+  }
+  for (int i = 0; i < items->size; i++) {
+    if (bst_select(tree, i) != items->nodes[i]) {
+      mismatches++;
+    }
+  }
+  for (int a = lo; a <= hi; a++) {
+    int below = 0;
+    while (below < items->size && items->nodes[below]->key < a) {
+      below++;
+    }
+    if (bst_rank(tree, a) != below) {
+      mismatches++;
+    }
+    for (int b = a; b <= hi; b++) {
+      int count = 0;
+      for (int i = 0; i < items->size; i++) {
+        if (items->nodes[i]->key >= a && items->nodes[i]->key <= b) {
+          count++;
+        }
+      }
+      if (bst_count_range(tree, a, b) != count) {
+        mismatches++;
+      }
+    }
+  }
+
+  bst_reset_items(items);
+  free(items);
+  return mismatches;
+}
+#endif
+
+void bst_print_stats(bst_stats_t *stats) {
+  printf("Count: %d, height: %d, max depth: %d, average depth: %.2f\n",
+         stats->count, stats->height, stats->max_depth, stats->average_depth);
+  printf("Depth histogram:");
+  for (int depth = 0; depth <= stats->max_depth && depth < BST_STATS_DEPTHS;
+       depth++) {
+    printf(" %d", stats->histogram[depth]);
+  }
+  printf("\n");
+}
+
+void bst_print_keys(bst_node_t *tree) {
+  bst_items_t items = {NULL, 0, 0};
+  bst_inorder(tree, &items);
+  printf("Keys in order:");
+  for (int i = 0; i < items.size; i++) {
+    printf(" %lld", (long long)items.nodes[i]->key);
+  }
+  printf("\n");
+  free(items.nodes);
+}
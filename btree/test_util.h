@@ -2,6 +2,7 @@
 #define IAL_BTREE_TEST_UTIL_H
 
 #include "btree.h"
+#include "character.h"
 #include <stdio.h>
 
 #define TEST(NAME, DESCRIPTION)                                                \
@@ -17,15 +18,25 @@
   bst_dispose(&test_tree);                                                     \
   }
 
-typedef enum direction { left, right, none } direction_t;
-
-void bst_print_subtree(bst_node_t *tree, char *prefix, direction_t from);
 void bst_print_tree(bst_node_t *tree);
 void bst_print_search_result(bst_node_content_t* content);
 bst_node_content_t create_integer_content(int value);
+bst_node_content_t create_character_content(const char *name,
+                                            character_class_t character_class,
+                                            unsigned char level);
 void bst_insert_many(bst_node_t **tree, const char keys[], const int values[],
                      int count);
+void bst_insert_many_with(bst_node_t **tree, const char keys[],
+                          const int values[], int count,
+                          const struct allocator *allocator);
 bst_items_t* bst_init_items();
 void bst_print_items(bst_items_t *items);
 void bst_reset_items (bst_items_t *items);
+void bst_visit_add_to_items(bst_node_t *node, void *items);
+void bst_print_lookup_result(const char *label, bst_node_t *node);
+void bst_print_stats(bst_stats_t *stats);
+void bst_print_keys(bst_node_t *tree);
+#ifdef BST_ORDER_STATISTICS
+int bst_count_order_mismatches(bst_node_t *tree, char lo, char hi);
+#endif
 #endif
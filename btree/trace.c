@@ -0,0 +1,567 @@
+/*
+ * Záznam a načtení posloupnosti volání bst_* a ht_*
+ *
+ * Samotná volání zachytávají obaly trace_bst.c a ../hashtable/trace_ht.c,
+ * které se k programu přilinkují s volbou --wrap linkeru; tento soubor
+ * jen přiděluje identifikátory stromům a tabulkám, kóduje operace do
+ * bufferu z dump.h a záznam zase načítá pro přehrání (replay.c).
+ *
+ * Záznam se spustí funkcí trace_start, nebo při startu programu, pokud je
+ * nastavena proměnná prostředí IAL_TRACE s cestou k souboru.
+ */
+
+#include "trace.h"
+#include "character.h"
+#include "dump.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Rozptylová tabulka ukazatel -> identifikátor s lineárním zkoušením
+typedef struct trace_map
+{
+  const void **keys;            // NULL = volno
+  uint32_t *values;
+  size_t mask;                  // velikost - 1, velikost je mocnina 2
+  size_t count;
+} trace_map_t;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool trace_on;
+static FILE *trace_file;
+static dump_buffer_t trace_out;
+static trace_map_t trace_handles;
+static trace_map_t trace_roots;
+static const void **trace_roots_by_handle;
+static uint32_t trace_next_handle;
+static uint32_t trace_root_capacity;
+// Zanoření obalů ve vlákně: volání uvnitř zaznamenané operace se nezapíší
+static _Thread_local int trace_depth;
+
+static const char *trace_kind_names[TRACE_KINDS] = {
+    "?",          "bst_init",   "bst_insert",    "bst_search",
+    "bst_delete", "bst_dispose", "ht_init",      "ht_search",
+    "ht_insert",  "ht_get",     "ht_increment",  "ht_delete",
+    "ht_delete_all", "bst_replace"};
+
+const char *trace_kind_name(trace_kind_t kind)
+{
+  return kind > 0 && kind < TRACE_KINDS ? trace_kind_names[kind] : "?";
+}
+
+static size_t trace_map_slot(const trace_map_t *map, const void *key)
+{
+  uint64_t hash = (uint64_t)(uintptr_t)key * 0x9e3779b97f4a7c15ull;
+  return (size_t)(hash >> 32) & map->mask;
+}
+
+static bool trace_map_grow(trace_map_t *map)
+{
+  size_t size = map->keys == NULL ? 64 : (map->mask + 1) * 2;
+  trace_map_t grown = {calloc(size, sizeof(void *)),
+                       malloc(size * sizeof(uint32_t)), size - 1, 0};
+  if (grown.keys == NULL || grown.values == NULL)
+  {
+    free(grown.keys);
+    free(grown.values);
+    return false;
+  }
+  for (size_t i = 0; map->keys != NULL && i <= map->mask; i++)
+  {
+    if (map->keys[i] == NULL)
+      continue;
+    size_t slot = trace_map_slot(&grown, map->keys[i]);
+    while (grown.keys[slot] != NULL)
+      slot = (slot + 1) & grown.mask;
+    grown.keys[slot] = map->keys[i];
+    grown.values[slot] = map->values[i];
+    grown.count++;
+  }
+  free(map->keys);
+  free(map->values);
+  *map = grown;
+  return true;
+}
+
+// Hodnota klíče, nebo 0, pokud v tabulce není
+static uint32_t trace_map_get(const trace_map_t *map, const void *key)
+{
+  if (map->keys == NULL)
+    return 0;
+  for (size_t slot = trace_map_slot(map, key); map->keys[slot] != NULL;
+       slot = (slot + 1) & map->mask)
+  {
+    if (map->keys[slot] == key)
+      return map->values[slot];
+  }
+  return 0;
+}
+
+static void trace_map_put(trace_map_t *map, const void *key, uint32_t value)
+{
+  if ((map->count + 1) * 2 > map->mask + 1 || map->keys == NULL)
+  {
+    if (!trace_map_grow(map))
+      return;
+  }
+  size_t slot = trace_map_slot(map, key);
+  while (map->keys[slot] != NULL && map->keys[slot] != key)
+    slot = (slot + 1) & map->mask;
+  if (map->keys[slot] == NULL)
+    map->count++;
+  map->keys[slot] = key;
+  map->values[slot] = value;
+}
+
+// Odstranění s posunem následujících položek zpět, bez náhrobků
+static void trace_map_remove(trace_map_t *map, const void *key)
+{
+  if (map->keys == NULL)
+    return;
+  size_t slot = trace_map_slot(map, key);
+  while (map->keys[slot] != key)
+  {
+    if (map->keys[slot] == NULL)
+      return;
+    slot = (slot + 1) & map->mask;
+  }
+  map->count--;
+  size_t next = slot;
+  for (;;)
+  {
+    next = (next + 1) & map->mask;
+    if (map->keys[next] == NULL)
+      break;
+    size_t home = trace_map_slot(map, map->keys[next]);
+    // Položka smí na uvolněné místo, jen pokud tím nepřeskočí svůj domov
+    if (((next - home) & map->mask) >= ((next - slot) & map->mask))
+    {
+      map->keys[slot] = map->keys[next];
+      map->values[slot] = map->values[next];
+      slot = next;
+    }
+  }
+  map->keys[slot] = NULL;
+}
+
+static void trace_map_dispose(trace_map_t *map)
+{
+  free(map->keys);
+  free(map->values);
+  map->keys = NULL;
+  map->values = NULL;
+  map->mask = 0;
+  map->count = 0;
+}
+
+bool trace_start(const char *path)
+{
+  pthread_mutex_lock(&trace_mutex);
+  bool started = false;
+  if (trace_file == NULL)
+  {
+    trace_file = fopen(path, "wb");
+    if (trace_file != NULL)
+    {
+      dump_init(&trace_out, trace_file);
+      dump_text(&trace_out, TRACE_MAGIC);
+      dump_char(&trace_out, TRACE_VERSION);
+      trace_next_handle = 1;
+      atomic_store(&trace_on, true);
+      started = true;
+    }
+  }
+  pthread_mutex_unlock(&trace_mutex);
+  return started;
+}
+
+void trace_stop()
+{
+  pthread_mutex_lock(&trace_mutex);
+  if (trace_file != NULL)
+  {
+    atomic_store(&trace_on, false);
+    if (!dump_flush(&trace_out))
+      fprintf(stderr, "trace: write failed\n");
+    dump_dispose(&trace_out);
+    fclose(trace_file);
+    trace_file = NULL;
+    trace_map_dispose(&trace_handles);
+    trace_map_dispose(&trace_roots);
+    free(trace_roots_by_handle);
+    trace_roots_by_handle = NULL;
+    trace_root_capacity = 0;
+  }
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+/*
+ * Zda se má volání zapsat. Mezi trace_lock a trace_unlock téhož vlákna
+ * vrací false, takže obalené funkce volané z jiné obalené funkce (např.
+ * bst_init z bst_build_from_sorted) jdou rovnou na původní implementaci
+ * a neblokují se na zámku, který vnější obal drží.
+ */
+bool trace_active()
+{
+  return trace_depth == 0 &&
+         atomic_load_explicit(&trace_on, memory_order_relaxed);
+}
+
+void trace_lock()
+{
+  pthread_mutex_lock(&trace_mutex);
+  trace_depth++;
+}
+
+void trace_unlock()
+{
+  trace_depth--;
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+/*
+ * Identifikátor stromu nebo tabulky podle adresy; nová adresa dostane
+ * další volný. Volá se se zamčeným záznamem.
+ */
+uint32_t trace_handle(const void *pointer)
+{
+  uint32_t handle = trace_map_get(&trace_handles, pointer);
+  if (handle == 0)
+  {
+    handle = trace_next_handle++;
+    trace_map_put(&trace_handles, pointer, handle);
+  }
+  return handle;
+}
+
+// Identifikátor stromu s daným kořenem, 0 pro prázdný nebo neznámý strom
+uint32_t trace_root(const void *root)
+{
+  return root != NULL ? trace_map_get(&trace_roots, root) : 0;
+}
+
+// Nový kořen stromu handle po operaci, která ho mohla změnit
+void trace_set_root(uint32_t handle, const void *root)
+{
+  if (handle >= trace_root_capacity)
+  {
+    uint32_t capacity = handle * 2 + 16;
+    const void **roots =
+        realloc(trace_roots_by_handle, capacity * sizeof(void *));
+    if (roots == NULL)
+      return;
+    memset(roots + trace_root_capacity, 0,
+           (capacity - trace_root_capacity) * sizeof(void *));
+    trace_roots_by_handle = roots;
+    trace_root_capacity = capacity;
+  }
+  const void *old = trace_roots_by_handle[handle];
+  if (old == root)
+    return;
+  if (old != NULL && trace_map_get(&trace_roots, old) == handle)
+    trace_map_remove(&trace_roots, old);
+  if (root != NULL)
+    trace_map_put(&trace_roots, root, handle);
+  trace_roots_by_handle[handle] = root;
+}
+
+static void trace_write_varint(uint64_t value)
+{
+  char bytes[10];
+  size_t length = 0;
+  do
+  {
+    bytes[length] = (char)(value & 0x7f);
+    value >>= 7;
+    if (value != 0)
+      bytes[length] |= (char)0x80;
+    length++;
+  } while (value != 0);
+  dump_bytes(&trace_out, bytes, length);
+}
+
+static void trace_write_signed(int64_t value)
+{
+  trace_write_varint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void trace_write_text(const char *text)
+{
+  size_t length = strlen(text);
+  trace_write_varint(length);
+  dump_bytes(&trace_out, text, length);
+}
+
+void trace_record_bst(trace_kind_t kind, uint32_t handle, bst_key_t key,
+                      const bst_node_content_t *value, bool custom_compare)
+{
+  if (trace_file == NULL)
+    return;
+  dump_char(&trace_out, (char)(kind | (custom_compare ? TRACE_CUSTOM_COMPARE : 0)));
+  trace_write_varint(handle);
+  if (kind == TRACE_BST_INIT || kind == TRACE_BST_DISPOSE ||
+      kind == TRACE_BST_REPLACE)
+    return;
+  trace_write_signed(key);
+  if (kind != TRACE_BST_INSERT)
+    return;
+
+  if (value->value == NULL || (value->type != INTEGER &&
+                               value->type != CHARACTER_T))
+  {
+    dump_char(&trace_out, TRACE_VALUE_NULL);
+  }
+  else if (value->type == INTEGER)
+  {
+    dump_char(&trace_out, TRACE_VALUE_INTEGER);
+    trace_write_signed(*(int *)value->value);
+  }
+  else
+  {
+    const character_t *character = value->value;
+    dump_char(&trace_out, TRACE_VALUE_CHARACTER);
+    dump_char(&trace_out, (char)character->character_class);
+    dump_char(&trace_out, (char)character->level);
+    trace_write_text(character->name);
+  }
+}
+
+void trace_record_ht(trace_kind_t kind, uint32_t handle, const char *key,
+                     double value)
+{
+  if (trace_file == NULL)
+    return;
+  dump_char(&trace_out, (char)kind);
+  trace_write_varint(handle);
+  if (kind == TRACE_HT_INIT)
+    trace_write_varint((uint64_t)value);
+  if (kind == TRACE_HT_INIT || kind == TRACE_HT_DELETE_ALL)
+    return;
+  trace_write_text(key);
+  if (kind == TRACE_HT_INSERT || kind == TRACE_HT_INCREMENT)
+  {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    char bytes[8];
+    for (int i = 0; i < 8; i++)
+      bytes[i] = (char)(bits >> (8 * i));
+    dump_bytes(&trace_out, bytes, sizeof(bytes));
+  }
+}
+
+#ifdef __GNUC__
+/*
+ * Záznam celého běhu programu bez úpravy jeho kódu: IAL_TRACE=soubor.
+ */
+__attribute__((constructor)) static void trace_autostart()
+{
+  const char *path = getenv("IAL_TRACE");
+  if (path != NULL && *path != '\0' && trace_start(path))
+    atexit(trace_stop);
+}
+#endif
+
+// Čtení ze záznamu v paměti; při chybě nastaví failed
+typedef struct trace_cursor
+{
+  const unsigned char *data;
+  size_t size;
+  size_t position;
+  bool failed;
+} trace_cursor_t;
+
+static uint64_t trace_read_varint(trace_cursor_t *cursor)
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7)
+  {
+    if (cursor->position >= cursor->size)
+      break;
+    unsigned char byte = cursor->data[cursor->position++];
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+  cursor->failed = true;
+  return 0;
+}
+
+static int64_t trace_read_signed(trace_cursor_t *cursor)
+{
+  uint64_t value = trace_read_varint(cursor);
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static unsigned char trace_read_byte(trace_cursor_t *cursor)
+{
+  if (cursor->position >= cursor->size)
+  {
+    cursor->failed = true;
+    return 0;
+  }
+  return cursor->data[cursor->position++];
+}
+
+// Řetězec se zkopíruje s koncovou nulou na konec strings
+static const char *trace_read_text(trace_cursor_t *cursor, char *strings,
+                                   size_t *strings_size)
+{
+  uint64_t length = trace_read_varint(cursor);
+  if (cursor->failed || length > cursor->size - cursor->position)
+  {
+    cursor->failed = true;
+    return "";
+  }
+  char *text = strings + *strings_size;
+  memcpy(text, cursor->data + cursor->position, length);
+  text[length] = '\0';
+  cursor->position += length;
+  *strings_size += length + 1;
+  return text;
+}
+
+static bool trace_decode(trace_t *trace, trace_cursor_t *cursor)
+{
+  size_t capacity = 0;
+  size_t strings_size = 0;
+  cursor->position = strlen(TRACE_MAGIC) + 1;
+  while (cursor->position < cursor->size && !cursor->failed)
+  {
+    if (trace->count == capacity)
+    {
+      capacity = capacity * 2 + 1024;
+      trace_op_t *ops = realloc(trace->ops, capacity * sizeof(trace_op_t));
+      if (ops == NULL)
+        return false;
+      trace->ops = ops;
+    }
+    trace_op_t *op = &trace->ops[trace->count];
+    memset(op, 0, sizeof(*op));
+    unsigned char kind = trace_read_byte(cursor);
+    op->kind = kind & ~TRACE_CUSTOM_COMPARE;
+    op->flags = kind & TRACE_CUSTOM_COMPARE;
+    op->text = "";
+    uint64_t handle = trace_read_varint(cursor);
+    if (op->kind == 0 || op->kind >= TRACE_KINDS || handle >= UINT32_MAX)
+      return false;
+    op->handle = (uint32_t)handle;
+    if (op->handle >= trace->handles)
+      trace->handles = op->handle + 1;
+
+    switch (op->kind)
+    {
+    case TRACE_BST_INSERT:
+    case TRACE_BST_SEARCH:
+    case TRACE_BST_DELETE:
+      op->key = trace_read_signed(cursor);
+      if (op->kind != TRACE_BST_INSERT)
+        break;
+      op->value_type = trace_read_byte(cursor);
+      if (op->value_type == TRACE_VALUE_INTEGER)
+      {
+        op->integer = trace_read_signed(cursor);
+      }
+      else if (op->value_type == TRACE_VALUE_CHARACTER)
+      {
+        op->integer = trace_read_byte(cursor);
+        op->level = trace_read_byte(cursor);
+        op->text = trace_read_text(cursor, trace->strings, &strings_size);
+      }
+      else if (op->value_type != TRACE_VALUE_NULL)
+      {
+        return false;
+      }
+      break;
+
+    case TRACE_HT_INIT:
+      op->integer = (int64_t)trace_read_varint(cursor);
+      break;
+
+    case TRACE_HT_SEARCH:
+    case TRACE_HT_INSERT:
+    case TRACE_HT_GET:
+    case TRACE_HT_INCREMENT:
+    case TRACE_HT_DELETE:
+      op->text = trace_read_text(cursor, trace->strings, &strings_size);
+      if (op->kind == TRACE_HT_INSERT || op->kind == TRACE_HT_INCREMENT)
+      {
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++)
+          bits |= (uint64_t)trace_read_byte(cursor) << (8 * i);
+        memcpy(&op->number, &bits, sizeof(bits));
+      }
+      break;
+
+    default:
+      break;
+    }
+    if (!cursor->failed)
+      trace->count++;
+  }
+  return !cursor->failed;
+}
+
+/*
+ * Načtení celého záznamu do paměti. Řetězce se vejdou do bloku velikosti
+ * souboru, každý je v souboru delší alespoň o bajt délky.
+ */
+bool trace_load(trace_t *trace, const char *path)
+{
+  trace->ops = NULL;
+  trace->count = 0;
+  trace->handles = 1;
+  trace->strings = NULL;
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return false;
+  unsigned char *data = NULL;
+  size_t size = 0;
+  size_t capacity = 0;
+  bool valid = true;
+  for (;;)
+  {
+    if (size == capacity)
+    {
+      capacity = capacity * 2 + (1 << 16);
+      unsigned char *grown = realloc(data, capacity);
+      if (grown == NULL)
+      {
+        valid = false;
+        break;
+      }
+      data = grown;
+    }
+    size_t read = fread(data + size, 1, capacity - size, file);
+    size += read;
+    if (read == 0)
+      break;
+  }
+  valid = valid && !ferror(file) && size > strlen(TRACE_MAGIC) &&
+               memcmp(data, TRACE_MAGIC, strlen(TRACE_MAGIC)) == 0 &&
+               data[strlen(TRACE_MAGIC)] == TRACE_VERSION;
+  fclose(file);
+
+  if (valid)
+  {
+    trace->strings = malloc(size);
+    trace_cursor_t cursor = {data, size, 0, false};
+    valid = trace->strings != NULL && trace_decode(trace, &cursor);
+  }
+  free(data);
+  if (!valid)
+    trace_dispose(trace);
+  return valid;
+}
+
+void trace_dispose(trace_t *trace)
+{
+  free(trace->ops);
+  free(trace->strings);
+  trace->ops = NULL;
+  trace->strings = NULL;
+  trace->count = 0;
+  trace->handles = 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * Hlavičkový soubor pro záznam a přehrání volání bst_* a ht_*.
+ */
+
+#ifndef IAL_BTREE_TRACE_H
+#define IAL_BTREE_TRACE_H
+
+#include "btree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Formát záznamu (soubor je přenositelný, vícebajtová čísla jsou varint
+ * LEB128, znaménková navíc zigzag):
+ *
+ *   hlavička   TRACE_MAGIC, bajt verze TRACE_VERSION
+ *   operace    bajt operace (trace_kind_t | TRACE_CUSTOM_COMPARE),
+ *              varint identifikátoru stromu nebo tabulky, dále podle druhu:
+ *     strom    zigzag klíče; u vložení bajt typu hodnoty (TRACE_VALUE_*)
+ *              a hodnota: zigzag čísla, nebo povolání, úroveň, délka
+ *              jména a jméno; inicializace, zrušení a nahrazení nemají
+ *              nic dalšího
+ *     tabulka  u inicializace varint HT_SIZE, jinak délka klíče a klíč;
+ *              u vložení a přičtení hodnota jako 8 bajtů double v pořadí
+ *              little-endian
+ *
+ * Identifikátory přiděluje záznam podle adresy proměnné stromu (bst_node_t
+ * **) nebo tabulky od 1. Vyhledávání dostává jen kořen, strom se proto
+ * pozná podle kořene po poslední změně; prázdný nebo neznámý strom má 0.
+ *
+ * Vkládání a mazání s alokátorem (bst_*_with, bst_insert_key_rebalance) se
+ * zapíše jako obyčejné vložení a mazání, alokátor se nezaznamenává.
+ * Hromadné operace (bst_build_from_sorted, bst_insert_batch, bst_balance,
+ * bst_rebalance_if_deep, bst_union, bst_split, bst_join, bst_load) i jejich
+ * varianty s alokátorem se zapíší jako TRACE_BST_REPLACE pro každý strom,
+ * který změnily: záznam tak zná jejich nový kořen, obsah ale nezachycuje a
+ * přehrání je vynechá.
+ */
+#define TRACE_MAGIC "IALT"
+#define TRACE_VERSION 1
+
+// Volání s vlastní porovnávací funkcí; přehrání ho vynechá
+#define TRACE_CUSTOM_COMPARE 0x80
+
+typedef enum trace_kind
+{
+  TRACE_BST_INIT = 1,
+  TRACE_BST_INSERT,
+  TRACE_BST_SEARCH,
+  TRACE_BST_DELETE,
+  TRACE_BST_DISPOSE,
+  TRACE_HT_INIT,
+  TRACE_HT_SEARCH,
+  TRACE_HT_INSERT,
+  TRACE_HT_GET,
+  TRACE_HT_INCREMENT,
+  TRACE_HT_DELETE,
+  TRACE_HT_DELETE_ALL,
+  TRACE_BST_REPLACE,            // strom nahrazen hromadnou operací
+  TRACE_KINDS
+} trace_kind_t;
+
+// Typ hodnoty vkládané do stromu
+enum
+{
+  TRACE_VALUE_NULL,
+  TRACE_VALUE_INTEGER,
+  TRACE_VALUE_CHARACTER
+};
+
+// Jedna operace načteného záznamu; řetězce patří záznamu (trace_t)
+typedef struct trace_op
+{
+  uint8_t kind;                 // trace_kind_t
+  uint8_t flags;                // TRACE_CUSTOM_COMPARE
+  uint8_t value_type;           // TRACE_VALUE_* (jen TRACE_BST_INSERT)
+  uint8_t level;                // úroveň postavy
+  uint32_t handle;              // identifikátor stromu nebo tabulky
+  int64_t key;                  // klíč stromu
+  int64_t integer;              // hodnota INTEGER, povolání postavy, HT_SIZE
+  const char *text;             // klíč tabulky nebo jméno postavy
+  double number;                // hodnota prvku tabulky
+} trace_op_t;
+
+typedef struct trace
+{
+  trace_op_t *ops;
+  size_t count;
+  uint32_t handles;             // největší identifikátor + 1
+  char *strings;                // řetězce operací za sebou
+} trace_t;
+
+bool trace_start(const char *path);
+void trace_stop();
+bool trace_active();
+
+// Pro obaly volání: zámek drží pořadí záznamu shodné s pořadím volání
+void trace_lock();
+void trace_unlock();
+uint32_t trace_handle(const void *pointer);
+uint32_t trace_root(const void *root);
+void trace_set_root(uint32_t handle, const void *root);
+void trace_record_bst(trace_kind_t kind, uint32_t handle, bst_key_t key,
+                      const bst_node_content_t *value, bool custom_compare);
+void trace_record_ht(trace_kind_t kind, uint32_t handle, const char *key,
+                     double value);
+
+bool trace_load(trace_t *trace, const char *path);
+void trace_dispose(trace_t *trace);
+const char *trace_kind_name(trace_kind_t kind);
+
+#endif
@@ -0,0 +1,521 @@
+/*
+ * Záznam volání bst_* (viz trace.h)
+ *
+ * Program se linkuje s volbami -Wl,--wrap=bst_init,--wrap=bst_insert,...
+ * (TRACE_WRAP v Makefile). Linker pak volání z ostatních souborů přesměruje
+ * na __wrap_bst_*, které operaci zapíšou a zavolají původní __real_bst_*.
+ * Volání uvnitř implementace stromu (rekurze, bst_insert -> bst_insert_key)
+ * zůstávají přímá a obalené funkce volané z jiného obalu trace_active
+ * propustí bez záznamu, zapíše se tedy jen vnější volání.
+ */
+
+#include "trace.h"
+#include "parallel.h"
+#include "serial.h"
+
+void __real_bst_init(bst_node_t **tree);
+void __real_bst_insert(bst_node_t **tree, char key, bst_node_content_t value);
+void __real_bst_insert_key(bst_node_t **tree, bst_key_t key,
+                           bst_node_content_t value, bst_compare_t compare);
+bool __real_bst_search(bst_node_t *tree, char key, bst_node_content_t **value);
+bool __real_bst_search_key(bst_node_t *tree, bst_key_t key,
+                           bst_node_content_t **value, bst_compare_t compare);
+void __real_bst_delete(bst_node_t **tree, char key);
+void __real_bst_delete_key(bst_node_t **tree, bst_key_t key,
+                           bst_compare_t compare);
+void __real_bst_dispose(bst_node_t **tree);
+void __real_bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                                bst_node_content_t value, bst_compare_t compare,
+                                const struct allocator *allocator);
+void __real_bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                                     bst_node_content_t value,
+                                     bst_compare_t compare,
+                                     const struct allocator *allocator,
+                                     bst_rebalance_t *policy);
+void __real_bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                                bst_compare_t compare,
+                                const struct allocator *allocator);
+void __real_bst_dispose_with(bst_node_t **tree,
+                             const struct allocator *allocator);
+void __real_bst_dispose_parallel(bst_node_t **tree, bst_pool_t *pool);
+void __real_bst_dispose_parallel_with(bst_node_t **tree, bst_pool_t *pool,
+                                      const struct allocator *allocator);
+void __real_bst_rebalance_if_deep(bst_node_t **tree, bst_key_t key, int depth,
+                                  bst_compare_t compare,
+                                  bst_rebalance_t *policy);
+void __real_bst_build_from_sorted(bst_node_t **tree, const char keys[],
+                                  const bst_node_content_t values[], int count);
+void __real_bst_build_from_sorted_with(bst_node_t **tree, const char keys[],
+                                       const bst_node_content_t values[],
+                                       int count,
+                                       const struct allocator *allocator);
+void __real_bst_insert_batch(bst_node_t **tree, const char keys[],
+                             const bst_node_content_t values[], int count);
+void __real_bst_insert_batch_with(bst_node_t **tree, const char keys[],
+                                  const bst_node_content_t values[], int count,
+                                  const struct allocator *allocator);
+void __real_bst_balance(bst_node_t **tree);
+void __real_bst_union(bst_node_t **tree, bst_node_t **other);
+void __real_bst_union_with(bst_node_t **tree, bst_node_t **other,
+                           const struct allocator *allocator);
+void __real_bst_split(bst_node_t **tree, bst_key_t key, bst_node_t **lo,
+                      bst_node_t **hi);
+void __real_bst_join(bst_node_t **tree, bst_node_t **lo, bst_node_t **hi);
+bool __real_bst_load(bst_node_t **tree, const char *path);
+bool __real_bst_load_with(bst_node_t **tree, const char *path,
+                          const struct allocator *allocator);
+#ifdef SPLAY
+bool __real_bst_search_splay(bst_node_t **tree, bst_key_t key,
+                             bst_node_content_t **value, bst_compare_t compare);
+#endif // SPLAY
+#if defined(ITER) || defined(SPLAY)
+void __real_bst_dispose_flatten(bst_node_t **tree);
+void __real_bst_dispose_flatten_with(bst_node_t **tree,
+                                     const struct allocator *allocator);
+#endif // ITER || SPLAY
+
+// Zápis nahrazení stromu *tree a jeho nového kořene; volá se se zámkem
+static void trace_replaced(bst_node_t **tree)
+{
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_REPLACE, handle, 0, NULL, false);
+  trace_set_root(handle, *tree);
+}
+
+void __wrap_bst_init(bst_node_t **tree)
+{
+  if (!trace_active())
+  {
+    __real_bst_init(tree);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_INIT, handle, 0, NULL, false);
+  __real_bst_init(tree);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert_key(bst_node_t **tree, bst_key_t key,
+                           bst_node_content_t value, bst_compare_t compare)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert_key(tree, key, value, compare);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_INSERT, handle, key, &value, compare != NULL);
+  __real_bst_insert_key(tree, key, value, compare);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert(bst_node_t **tree, char key, bst_node_content_t value)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert(tree, key, value);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_INSERT, handle, key, &value, false);
+  __real_bst_insert(tree, key, value);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+bool __wrap_bst_search_key(bst_node_t *tree, bst_key_t key,
+                           bst_node_content_t **value, bst_compare_t compare)
+{
+  if (trace_active())
+  {
+    trace_lock();
+    trace_record_bst(TRACE_BST_SEARCH, trace_root(tree), key, NULL,
+                     compare != NULL);
+    trace_unlock();
+  }
+  return __real_bst_search_key(tree, key, value, compare);
+}
+
+bool __wrap_bst_search(bst_node_t *tree, char key, bst_node_content_t **value)
+{
+  if (trace_active())
+  {
+    trace_lock();
+    trace_record_bst(TRACE_BST_SEARCH, trace_root(tree), key, NULL, false);
+    trace_unlock();
+  }
+  return __real_bst_search(tree, key, value);
+}
+
+#ifdef SPLAY
+// Hledání s rozvinutím mění kořen, zapíše se jako hledání ve stromu tree
+bool __wrap_bst_search_splay(bst_node_t **tree, bst_key_t key,
+                             bst_node_content_t **value, bst_compare_t compare)
+{
+  if (!trace_active())
+    return __real_bst_search_splay(tree, key, value, compare);
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_SEARCH, handle, key, NULL, compare != NULL);
+  bool found = __real_bst_search_splay(tree, key, value, compare);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+  return found;
+}
+#endif // SPLAY
+
+void __wrap_bst_delete_key(bst_node_t **tree, bst_key_t key,
+                           bst_compare_t compare)
+{
+  if (!trace_active())
+  {
+    __real_bst_delete_key(tree, key, compare);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DELETE, handle, key, NULL, compare != NULL);
+  __real_bst_delete_key(tree, key, compare);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_delete(bst_node_t **tree, char key)
+{
+  if (!trace_active())
+  {
+    __real_bst_delete(tree, key);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DELETE, handle, key, NULL, false);
+  __real_bst_delete(tree, key);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_dispose(bst_node_t **tree)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose(tree);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose(tree);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert_key_with(bst_node_t **tree, bst_key_t key,
+                                bst_node_content_t value, bst_compare_t compare,
+                                const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert_key_with(tree, key, value, compare, allocator);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_INSERT, handle, key, &value, compare != NULL);
+  __real_bst_insert_key_with(tree, key, value, compare, allocator);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert_key_rebalance(bst_node_t **tree, bst_key_t key,
+                                     bst_node_content_t value,
+                                     bst_compare_t compare,
+                                     const struct allocator *allocator,
+                                     bst_rebalance_t *policy)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert_key_rebalance(tree, key, value, compare, allocator,
+                                    policy);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_INSERT, handle, key, &value, compare != NULL);
+  __real_bst_insert_key_rebalance(tree, key, value, compare, allocator,
+                                  policy);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_delete_key_with(bst_node_t **tree, bst_key_t key,
+                                bst_compare_t compare,
+                                const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_delete_key_with(tree, key, compare, allocator);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DELETE, handle, key, NULL, compare != NULL);
+  __real_bst_delete_key_with(tree, key, compare, allocator);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_dispose_with(bst_node_t **tree,
+                             const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose_with(tree, allocator);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose_with(tree, allocator);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_dispose_parallel(bst_node_t **tree, bst_pool_t *pool)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose_parallel(tree, pool);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose_parallel(tree, pool);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_dispose_parallel_with(bst_node_t **tree, bst_pool_t *pool,
+                                      const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose_parallel_with(tree, pool, allocator);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose_parallel_with(tree, pool, allocator);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+#if defined(ITER) || defined(SPLAY)
+void __wrap_bst_dispose_flatten(bst_node_t **tree)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose_flatten(tree);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose_flatten(tree);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+
+void __wrap_bst_dispose_flatten_with(bst_node_t **tree,
+                                     const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_dispose_flatten_with(tree, allocator);
+    return;
+  }
+  trace_lock();
+  uint32_t handle = trace_handle(tree);
+  trace_record_bst(TRACE_BST_DISPOSE, handle, 0, NULL, false);
+  __real_bst_dispose_flatten_with(tree, allocator);
+  trace_set_root(handle, *tree);
+  trace_unlock();
+}
+#endif // ITER || SPLAY
+
+void __wrap_bst_rebalance_if_deep(bst_node_t **tree, bst_key_t key, int depth,
+                                  bst_compare_t compare,
+                                  bst_rebalance_t *policy)
+{
+  if (!trace_active())
+  {
+    __real_bst_rebalance_if_deep(tree, key, depth, compare, policy);
+    return;
+  }
+  trace_lock();
+  __real_bst_rebalance_if_deep(tree, key, depth, compare, policy);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_build_from_sorted(bst_node_t **tree, const char keys[],
+                                  const bst_node_content_t values[], int count)
+{
+  if (!trace_active())
+  {
+    __real_bst_build_from_sorted(tree, keys, values, count);
+    return;
+  }
+  trace_lock();
+  __real_bst_build_from_sorted(tree, keys, values, count);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_build_from_sorted_with(bst_node_t **tree, const char keys[],
+                                       const bst_node_content_t values[],
+                                       int count,
+                                       const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_build_from_sorted_with(tree, keys, values, count, allocator);
+    return;
+  }
+  trace_lock();
+  __real_bst_build_from_sorted_with(tree, keys, values, count, allocator);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert_batch(bst_node_t **tree, const char keys[],
+                             const bst_node_content_t values[], int count)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert_batch(tree, keys, values, count);
+    return;
+  }
+  trace_lock();
+  __real_bst_insert_batch(tree, keys, values, count);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_insert_batch_with(bst_node_t **tree, const char keys[],
+                                  const bst_node_content_t values[], int count,
+                                  const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_insert_batch_with(tree, keys, values, count, allocator);
+    return;
+  }
+  trace_lock();
+  __real_bst_insert_batch_with(tree, keys, values, count, allocator);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_balance(bst_node_t **tree)
+{
+  if (!trace_active())
+  {
+    __real_bst_balance(tree);
+    return;
+  }
+  trace_lock();
+  __real_bst_balance(tree);
+  trace_replaced(tree);
+  trace_unlock();
+}
+
+void __wrap_bst_union(bst_node_t **tree, bst_node_t **other)
+{
+  if (!trace_active())
+  {
+    __real_bst_union(tree, other);
+    return;
+  }
+  trace_lock();
+  __real_bst_union(tree, other);
+  trace_replaced(tree);
+  trace_replaced(other);
+  trace_unlock();
+}
+
+void __wrap_bst_union_with(bst_node_t **tree, bst_node_t **other,
+                           const struct allocator *allocator)
+{
+  if (!trace_active())
+  {
+    __real_bst_union_with(tree, other, allocator);
+    return;
+  }
+  trace_lock();
+  __real_bst_union_with(tree, other, allocator);
+  trace_replaced(tree);
+  trace_replaced(other);
+  trace_unlock();
+}
+
+void __wrap_bst_split(bst_node_t **tree, bst_key_t key, bst_node_t **lo,
+                      bst_node_t **hi)
+{
+  if (!trace_active())
+  {
+    __real_bst_split(tree, key, lo, hi);
+    return;
+  }
+  trace_lock();
+  __real_bst_split(tree, key, lo, hi);
+  trace_replaced(tree);
+  trace_replaced(lo);
+  trace_replaced(hi);
+  trace_unlock();
+}
+
+void __wrap_bst_join(bst_node_t **tree, bst_node_t **lo, bst_node_t **hi)
+{
+  if (!trace_active())
+  {
+    __real_bst_join(tree, lo, hi);
+    return;
+  }
+  trace_lock();
+  __real_bst_join(tree, lo, hi);
+  trace_replaced(tree);
+  trace_replaced(lo);
+  trace_replaced(hi);
+  trace_unlock();
+}
+
+bool __wrap_bst_load(bst_node_t **tree, const char *path)
+{
+  if (!trace_active())
+    return __real_bst_load(tree, path);
+  trace_lock();
+  bool loaded = __real_bst_load(tree, path);
+  trace_replaced(tree);
+  trace_unlock();
+  return loaded;
+}
+
+bool __wrap_bst_load_with(bst_node_t **tree, const char *path,
+                          const struct allocator *allocator)
+{
+  if (!trace_active())
+    return __real_bst_load_with(tree, path, allocator);
+  trace_lock();
+  bool loaded = __real_bst_load_with(tree, path, allocator);
+  trace_replaced(tree);
+  trace_unlock();
+  return loaded;
+}
@@ -0,0 +1,328 @@
+#define _XOPEN_SOURCE 700
+
+#include "workload.h"
+#include "bench_util.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// Exponent Zipfova rozdělení
+#define WL_ZIPF_EXPONENT 0.99
+
+// Zmenšení zátěží WL_SORTED a WL_ADVERSARIAL ve wl_run_suite
+#define WL_DEGENERATE_SCALE 16
+
+static const char *wl_distribution_names[WL_DISTRIBUTIONS] = {
+    "uniform", "zipf", "sorted", "adversarial"};
+
+const char *wl_distribution_name(wl_distribution_t distribution) {
+  return wl_distribution_names[distribution];
+}
+
+static uint64_t wl_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static double wl_uniform01() {
+  return (bench_rand() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void wl_shuffle(int32_t *keys, int count) {
+  for (int i = count - 1; i > 0; i--) {
+    int j = (int)(bench_rand() % (uint64_t)(i + 1));
+    int32_t swap = keys[i];
+    keys[i] = keys[j];
+    keys[j] = swap;
+  }
+}
+
+/*
+ * j-tý klíč z count klíčů v pořadí nejmenší, největší, druhý nejmenší,
+ * druhý největší...; nevyvážený strom z něj vyroste do hloubky count a
+ * každé další vložení ho celý projde.
+ */
+static int32_t wl_zigzag(int j, int count) {
+  return j % 2 == 0 ? j / 2 : count - 1 - j / 2;
+}
+
+bool wl_generate(wl_workload_t *workload, const wl_spec_t *spec) {
+  int keys = spec->keys;
+  workload->spec = *spec;
+  workload->preload_count = (keys + 1) / 2;
+  workload->preload = malloc(sizeof(int32_t) * workload->preload_count);
+  workload->ops = malloc(sizeof(wl_op_t) * spec->ops);
+  int32_t *popular = NULL;
+  double *cdf = NULL;
+  if (spec->distribution == WL_ZIPF) {
+    popular = malloc(sizeof(int32_t) * keys);
+    cdf = malloc(sizeof(double) * keys);
+  }
+  if (workload->preload == NULL || workload->ops == NULL ||
+      (spec->distribution == WL_ZIPF && (popular == NULL || cdf == NULL))) {
+    free(popular);
+    free(cdf);
+    wl_dispose(workload);
+    return false;
+  }
+
+  bench_seed(spec->seed);
+  int count = workload->preload_count;
+  for (int i = 0; i < count; i++) {
+    int j = spec->distribution == WL_ADVERSARIAL ? wl_zigzag(i, count) : i;
+    workload->preload[i] = 2 * j;
+  }
+  if (spec->distribution == WL_UNIFORM || spec->distribution == WL_ZIPF)
+    wl_shuffle(workload->preload, count);
+
+  double total = 0;
+  if (spec->distribution == WL_ZIPF) {
+    for (int i = 0; i < keys; i++)
+      popular[i] = i;
+    wl_shuffle(popular, keys);
+    for (int i = 0; i < keys; i++) {
+      total += 1.0 / pow(i + 1, WL_ZIPF_EXPONENT);
+      cdf[i] = total;
+    }
+  }
+
+  for (long i = 0; i < spec->ops; i++) {
+    wl_op_t *op = &workload->ops[i];
+    if ((int)(bench_rand() % 100) < spec->read_percent)
+      op->kind = WL_READ;
+    else
+      op->kind = bench_rand() & 1 ? WL_INSERT : WL_DELETE;
+
+    switch (spec->distribution) {
+    case WL_UNIFORM:
+      op->key = (int32_t)(bench_rand() % (uint64_t)keys);
+      break;
+    case WL_ZIPF: {
+      double u = wl_uniform01() * total;
+      int lo = 0;
+      int hi = keys - 1;
+      while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (cdf[mid] < u)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      op->key = popular[lo];
+      break;
+    }
+    case WL_SORTED:
+      op->key = (int32_t)(i % keys);
+      break;
+    case WL_ADVERSARIAL:
+      op->key = wl_zigzag((int)(i % keys), keys);
+      break;
+    }
+  }
+  free(popular);
+  free(cdf);
+  return true;
+}
+
+void wl_dispose(wl_workload_t *workload) {
+  free(workload->preload);
+  free(workload->ops);
+  workload->preload = NULL;
+  workload->ops = NULL;
+  workload->preload_count = 0;
+}
+
+/*
+ * Vynulování špičky rezidentní paměti procesu (Linux, zápis 5 do
+ * clear_refs). Kde to nejde, hlásí wl_peak_rss_kb špičku od startu procesu.
+ */
+void wl_reset_peak_rss() {
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+  if (file != NULL) {
+    fputs("5", file);
+    fclose(file);
+  }
+}
+
+long wl_peak_rss_kb() {
+  long peak = -1;
+  FILE *file = fopen("/proc/self/status", "r");
+  if (file != NULL) {
+    char line[128];
+    while (fgets(line, sizeof(line), file) != NULL) {
+      if (strncmp(line, "VmHWM:", 6) == 0) {
+        peak = strtol(line + 6, NULL, 10);
+        break;
+      }
+    }
+    fclose(file);
+  }
+  if (peak < 0) {
+    struct rusage usage;
+    peak = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+  }
+  return peak;
+}
+
+static int wl_compare_latency(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Hodnota, pod kterou leží podíl fraction seřazených latencí
+static uint32_t wl_percentile(const uint32_t *sorted, long count,
+                              double fraction) {
+  long index = (long)ceil(fraction * count) - 1;
+  if (index < 0)
+    index = 0;
+  return sorted[index];
+}
+
+static void *wl_prepare(const wl_workload_t *workload,
+                        const wl_target_t *target) {
+  void *state = target->create(target->data, &workload->spec);
+  if (state == NULL)
+    return NULL;
+  for (int i = 0; i < workload->preload_count; i++)
+    target->apply(state, WL_INSERT, workload->preload[i]);
+  return state;
+}
+
+/*
+ * Dva průchody nad stejně naplněnou strukturou: první měří propustnost bez
+ * režie hodin, druhý latenci každé operace zvlášť. Latence proto obsahuje
+ * i čtení hodin (desítky ns).
+ */
+bool wl_run(const wl_workload_t *workload, const wl_target_t *target,
+            wl_result_t *result) {
+  long ops = workload->spec.ops;
+  uint32_t *latencies = malloc(sizeof(uint32_t) * (ops > 0 ? ops : 1));
+  if (latencies == NULL)
+    return false;
+  wl_reset_peak_rss();
+
+  void *state = wl_prepare(workload, target);
+  if (state == NULL) {
+    free(latencies);
+    return false;
+  }
+  long found = 0;
+  double start = bench_now();
+  for (long i = 0; i < ops; i++)
+    found += target->apply(state, workload->ops[i].kind, workload->ops[i].key);
+  double elapsed = bench_now() - start;
+  target->destroy(state);
+
+  state = wl_prepare(workload, target);
+  if (state == NULL) {
+    free(latencies);
+    return false;
+  }
+  for (long i = 0; i < ops; i++) {
+    uint64_t begin = wl_now_ns();
+    target->apply(state, workload->ops[i].kind, workload->ops[i].key);
+    uint64_t latency = wl_now_ns() - begin;
+    latencies[i] = latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+  }
+  result->peak_rss_kb = wl_peak_rss_kb();
+  target->destroy(state);
+
+  qsort(latencies, ops, sizeof(uint32_t), wl_compare_latency);
+  result->ops_per_sec = elapsed > 0 ? ops / elapsed : 0;
+  result->found = found;
+  result->p50 = ops > 0 ? wl_percentile(latencies, ops, 0.50) : 0;
+  result->p99 = ops > 0 ? wl_percentile(latencies, ops, 0.99) : 0;
+  result->p999 = ops > 0 ? wl_percentile(latencies, ops, 0.999) : 0;
+  result->max = ops > 0 ? latencies[ops - 1] : 0;
+  free(latencies);
+  return true;
+}
+
+void wl_report(const wl_workload_t *workload, const wl_result_t *result) {
+  char label[48];
+  snprintf(label, sizeof(label), "%s r=%d%% n=%d",
+           wl_distribution_name(workload->spec.distribution),
+           workload->spec.read_percent, workload->spec.keys);
+  printf("  %-32s %12.0f ops/s p50 %6u p99 %6u p999 %7u ns %8ld KB\n",
+         label, result->ops_per_sec, result->p50, result->p99, result->p999,
+         result->peak_rss_kb);
+}
+
+void wl_dump_result(dump_buffer_t *dump, const char *variant,
+                    const char *target, const wl_workload_t *workload,
+                    const wl_result_t *result) {
+  dump_text(dump, "{\"variant\":");
+  dump_json_string(dump, variant);
+  dump_text(dump, ",\"target\":");
+  dump_json_string(dump, target);
+  dump_text(dump, ",\"distribution\":");
+  dump_json_string(dump, wl_distribution_name(workload->spec.distribution));
+  dump_text(dump, ",\"keys\":");
+  dump_integer(dump, workload->spec.keys);
+  dump_text(dump, ",\"ops\":");
+  dump_integer(dump, workload->spec.ops);
+  dump_text(dump, ",\"read_percent\":");
+  dump_integer(dump, workload->spec.read_percent);
+  dump_text(dump, ",\"seed\":");
+  dump_integer(dump, (long long)workload->spec.seed);
+  dump_text(dump, ",\"ops_per_sec\":");
+  dump_fixed(dump, result->ops_per_sec, 0);
+  dump_text(dump, ",\"latency_ns\":{\"p50\":");
+  dump_integer(dump, result->p50);
+  dump_text(dump, ",\"p99\":");
+  dump_integer(dump, result->p99);
+  dump_text(dump, ",\"p999\":");
+  dump_integer(dump, result->p999);
+  dump_text(dump, ",\"max\":");
+  dump_integer(dump, result->max);
+  dump_text(dump, "},\"found\":");
+  dump_integer(dump, result->found);
+  dump_text(dump, ",\"peak_rss_kb\":");
+  dump_integer(dump, result->peak_rss_kb);
+  dump_char(dump, '}');
+}
+
+/*
+ * Všechna rozdělení s poměrem čtení 95 % a 50 % nad jedním cílem. Bez
+ * json se výsledky vypíšou jako řádky tabulky, jinak jako pole objektů
+ * JSON (jeden na řádek), které lze porovnat s během jiného překladu.
+ *
+ * Vzestupné a nepřátelské klíče stojí nevyváženou strukturu O(n) na
+ * operaci, proto běží nad WL_DEGENERATE_SCALE krát menším prostorem klíčů
+ * i počtem operací.
+ */
+void wl_run_suite(const char *variant, const wl_target_t *target, int keys,
+                  long ops, dump_buffer_t *json) {
+  static const int read_percents[] = {95, 50};
+  bool first = true;
+  if (json != NULL)
+    dump_text(json, "[\n");
+  for (int d = 0; d < WL_DISTRIBUTIONS; d++) {
+    for (int r = 0; r < 2; r++) {
+      int scale = d == WL_SORTED || d == WL_ADVERSARIAL ? WL_DEGENERATE_SCALE : 1;
+      wl_spec_t spec = {(wl_distribution_t)d, keys / scale, ops / scale,
+                        read_percents[r], WL_SEED};
+      wl_workload_t workload;
+      wl_result_t result;
+      if (!wl_generate(&workload, &spec))
+        continue;
+      if (wl_run(&workload, target, &result)) {
+        if (json == NULL) {
+          wl_report(&workload, &result);
+        } else {
+          dump_text(json, first ? "" : ",\n");
+          wl_dump_result(json, variant, target->name, &workload, &result);
+          first = false;
+        }
+      }
+      wl_dispose(&workload);
+    }
+  }
+  if (json != NULL)
+    dump_text(json, "\n]\n");
+}
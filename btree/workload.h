@@ -0,0 +1,91 @@
+#ifndef IAL_BTREE_WORKLOAD_H
+#define IAL_BTREE_WORKLOAD_H
+
+#include "dump.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Rozdělení klíčů zátěže. Klíče jsou indexy 0..keys-1, převod na klíč
+ * konkrétní struktury (celé číslo, řetězec) dělá cíl zátěže.
+ */
+typedef enum wl_distribution {
+  WL_UNIFORM,     // rovnoměrně náhodné klíče
+  WL_ZIPF,        // Zipfovo rozdělení (s = 0.99) s náhodným pořadím oblíbenosti
+  WL_SORTED,      // vzestupné průchody klíči
+  WL_ADVERSARIAL  // střídavě nejmenší a největší zbývající klíč
+} wl_distribution_t;
+
+#define WL_DISTRIBUTIONS 4
+
+// Semínko zátěží wl_run_suite
+#define WL_SEED 42
+
+typedef enum wl_kind { WL_READ, WL_INSERT, WL_DELETE } wl_kind_t;
+
+typedef struct wl_op {
+  int32_t key;
+  uint8_t kind;       // wl_kind_t
+} wl_op_t;
+
+// Parametry zátěže; stejné parametry dají vždy stejnou posloupnost operací
+typedef struct wl_spec {
+  wl_distribution_t distribution;
+  int keys;           // velikost prostoru klíčů
+  long ops;           // počet měřených operací
+  int read_percent;   // podíl čtení, zápisy jsou napůl vložení a smazání
+  uint64_t seed;
+} wl_spec_t;
+
+/*
+ * Vygenerovaná zátěž: struktura se před měřením naplní sudými klíči
+ * (polovina prostoru) v pořadí podle rozdělení, pak se provedou ops.
+ */
+typedef struct wl_workload {
+  wl_spec_t spec;
+  int32_t *preload;
+  int preload_count;
+  wl_op_t *ops;
+} wl_workload_t;
+
+/*
+ * Cíl zátěže: create vytvoří prázdnou strukturu pro zátěž spec (podle ní
+ * si cíl může připravit klíče), apply provede jednu operaci (u čtení vrací,
+ * zda byl klíč nalezen), destroy strukturu uvolní.
+ */
+typedef struct wl_target {
+  const char *name;
+  void *(*create)(void *data, const wl_spec_t *spec);
+  bool (*apply)(void *state, wl_kind_t kind, int32_t key);
+  void (*destroy)(void *state);
+  void *data;         // předává se funkci create
+} wl_target_t;
+
+typedef struct wl_result {
+  double ops_per_sec;
+  uint32_t p50;       // latence operace v ns
+  uint32_t p99;
+  uint32_t p999;
+  uint32_t max;
+  long found;         // počet úspěšných čtení
+  long peak_rss_kb;   // špička rezidentní paměti během běhu
+} wl_result_t;
+
+const char *wl_distribution_name(wl_distribution_t distribution);
+bool wl_generate(wl_workload_t *workload, const wl_spec_t *spec);
+void wl_dispose(wl_workload_t *workload);
+bool wl_run(const wl_workload_t *workload, const wl_target_t *target,
+            wl_result_t *result);
+
+void wl_reset_peak_rss();
+long wl_peak_rss_kb();
+
+void wl_run_suite(const char *variant, const wl_target_t *target, int keys,
+                  long ops, dump_buffer_t *json);
+
+void wl_report(const wl_workload_t *workload, const wl_result_t *result);
+void wl_dump_result(dump_buffer_t *dump, const char *variant,
+                    const char *target, const wl_workload_t *workload,
+                    const wl_result_t *result);
+
+#endif
@@ -0,0 +1,152 @@
+#include "hashtable.h"
+#include "../btree/alloc.h"
+#include "../btree/bench_util.h"
+#include "../btree/workload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Najdlhší kľúč vrátane koncovej nuly
+#define BENCH_KEY_SIZE 16
+
+// Tabuľka a kľúče pre všetky indexy zaťaže
+typedef struct bench_table {
+  ht_table_t table;
+  char (*keys)[BENCH_KEY_SIZE];
+} bench_table_t;
+
+void init_bench() {
+  printf("Hash Table - benchmark\n");
+  printf("----------------------\n");
+  printf("\n");
+}
+
+/*
+ * Kľúč pre index i. Nepriateľské kľúče sú dvojice znakov 'M' + x a 'M' - x
+ * pre cifry x čísla i v sústave 13: súčet znakov je pre všetky rovnaký,
+ * get_hash ich teda dá do jedného zoznamu.
+ */
+void bench_key(char *key, int i, wl_distribution_t distribution) {
+  if (distribution != WL_ADVERSARIAL) {
+    snprintf(key, BENCH_KEY_SIZE, "k%d", i);
+    return;
+  }
+  int length = 0;
+  key[length++] = 'k';
+  for (int digit = 0; digit < 6; digit++) {
+    key[length++] = (char)('M' + i % 13);
+    key[length++] = (char)('M' - i % 13);
+    i /= 13;
+  }
+  key[length] = '\0';
+}
+
+void *bench_table_create(void *data, const wl_spec_t *spec) {
+  bench_table_t *state = malloc(sizeof(bench_table_t));
+  if (state == NULL)
+    return NULL;
+  state->keys = malloc(sizeof(*state->keys) * spec->keys);
+  if (state->keys == NULL) {
+    free(state);
+    return NULL;
+  }
+  for (int i = 0; i < spec->keys; i++)
+    bench_key(state->keys[i], i, spec->distribution);
+  ht_init(&state->table);
+  return state;
+}
+
+bool bench_table_apply(void *state, wl_kind_t kind, int32_t key) {
+  bench_table_t *table = state;
+  switch (kind) {
+  case WL_READ:
+    return ht_get(&table->table, table->keys[key]) != NULL;
+  case WL_INSERT:
+    ht_insert(&table->table, table->keys[key], (ht_value_t)key);
+    return false;
+  default:
+    ht_delete(&table->table, table->keys[key]);
+    return false;
+  }
+}
+
+void bench_table_destroy(void *state) {
+  bench_table_t *table = state;
+  ht_delete_all(&table->table);
+  free(table->keys);
+  free(table);
+}
+
+const wl_target_t bench_table_target = {"ht", bench_table_create,
+                                        bench_table_apply, bench_table_destroy,
+                                        NULL};
+
+/*
+ * Vkladanie nových kľúčov (prvok a kópia kľúča, dve alokácie) a zrušenie
+ * tabuľky pre jednotlivé alokátory. Aréna sa medzi kolami resetuje.
+ */
+BENCH(bench_allocators, "Item allocation under each allocator (keys=2048)")
+const int count = 2048;
+const int rounds = 100;
+char (*keys)[BENCH_KEY_SIZE] = malloc(sizeof(*keys) * count);
+ht_table_t *table = malloc(sizeof(ht_table_t));
+if (keys == NULL || table == NULL) {
+  free(keys);
+  free(table);
+  return;
+}
+for (int i = 0; i < count; i++)
+  bench_key(keys[i], i, WL_UNIFORM);
+counting_allocator_t counting;
+counting_init(&counting, NULL);
+arena_t arena;
+arena_init(&arena, 64 * 1024, NULL);
+const char *names[] = {"default", "counting", "arena"};
+const allocator_t *allocators[] = {NULL, &counting.allocator, &arena.allocator};
+for (int a = 0; a < 3; a++) {
+  double insert = 0;
+  double dispose = 0;
+  for (int r = 0; r < rounds; r++) {
+    ht_init(table);
+    double start = bench_now();
+    for (int i = 0; i < count; i++)
+      ht_increment_with(table, keys[i], 1, allocators[a]);
+    insert += bench_now() - start;
+    start = bench_now();
+    ht_delete_all_with(table, allocators[a]);
+    if (allocators[a] == &arena.allocator)
+      arena_reset(&arena);
+    dispose += bench_now() - start;
+  }
+  char label[48];
+  snprintf(label, sizeof(label), "%s ht_increment", names[a]);
+  bench_report(label, (long)rounds * count, insert);
+  snprintf(label, sizeof(label), "%s ht_delete_all", names[a]);
+  bench_report(label, (long)rounds * count, dispose);
+}
+printf("  counting: %ld allocations, peak %ld KB\n",
+       atomic_load(&counting.allocations),
+       atomic_load(&counting.peak_bytes) / 1024);
+arena_dispose(&arena);
+free(table);
+free(keys);
+ENDBENCH
+
+BENCH(bench_workloads, "Seeded workloads (keys=4096, 1M ops per run)")
+wl_run_suite("hashtable", &bench_table_target, 4096, 1000000, NULL);
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && strcmp(argv[1], "--json") == 0) {
+    dump_buffer_t json;
+    dump_init(&json, stdout);
+    wl_run_suite("hashtable", &bench_table_target, 4096, 1000000, &json);
+    dump_flush(&json);
+    dump_dispose(&json);
+    return 0;
+  }
+
+  init_bench();
+  bench_allocators();
+  bench_workloads();
+}
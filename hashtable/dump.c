@@ -0,0 +1,65 @@
+/*
+ * Výpis tabuľky do výstupného buffera
+ *
+ * Používa buffer z ../btree/dump.h: riadky sa skladajú v pamäti a do
+ * súboru sa zapisujú po veľkých blokoch namiesto printf pre každý prvok.
+ */
+
+#include "dump.h"
+#include <float.h>
+
+// Počet platných číslic, ktoré hodnotu v JSON zapíšu bez straty presnosti
+#ifdef HT_VALUE_DOUBLE
+#define HT_DUMP_DIGITS DBL_DECIMAL_DIG
+#else
+#define HT_DUMP_DIGITS FLT_DECIMAL_DIG
+#endif
+
+/*
+ * Textový výpis zoznamov tabuľky v tvare ht_print_table: riadok
+ * "index: (kľúč,hodnota)(kľúč,hodnota)..." pre každý index 0 až HT_SIZE-1.
+ */
+void ht_dump_table(dump_buffer_t *dump, ht_table_t *table)
+{
+  for (int i = 0; i < HT_SIZE; i++)
+  {
+    dump_integer(dump, i);
+    dump_text(dump, ": ");
+    for (ht_item_t *item = (*table)[i]; item != NULL; item = item->next)
+    {
+      dump_char(dump, '(');
+      dump_text(dump, item->key);
+      dump_char(dump, ',');
+      dump_fixed(dump, item->value, 2);
+      dump_char(dump, ')');
+    }
+    dump_char(dump, '\n');
+  }
+}
+
+/*
+ * Výpis tabuľky ako JSON: pole HT_SIZE zoznamov, zoznam je pole objektov
+ * {"key", "value"} v poradí od začiatku zoznamu.
+ */
+void ht_dump_json(dump_buffer_t *dump, ht_table_t *table)
+{
+  dump_char(dump, '[');
+  for (int i = 0; i < HT_SIZE; i++)
+  {
+    if (i > 0)
+      dump_char(dump, ',');
+    dump_char(dump, '[');
+    for (ht_item_t *item = (*table)[i]; item != NULL; item = item->next)
+    {
+      if (item != (*table)[i])
+        dump_char(dump, ',');
+      dump_text(dump, "{\"key\":");
+      dump_json_string(dump, item->key);
+      dump_text(dump, ",\"value\":");
+      dump_number(dump, item->value, HT_DUMP_DIGITS);
+      dump_char(dump, '}');
+    }
+    dump_char(dump, ']');
+  }
+  dump_char(dump, ']');
+}
@@ -0,0 +1,14 @@
+/*
+ * Hlavičkový súbor pre výpis tabuľky do výstupného buffera.
+ */
+
+#ifndef IAL_HASHTABLE_DUMP_H
+#define IAL_HASHTABLE_DUMP_H
+
+#include "hashtable.h"
+#include "../btree/dump.h"
+
+void ht_dump_table(dump_buffer_t *dump, ht_table_t *table);
+void ht_dump_json(dump_buffer_t *dump, ht_table_t *table);
+
+#endif
@@ -9,6 +9,7 @@
  */
 
 #include "hashtable.h"
+#include "../btree/alloc.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -38,6 +39,15 @@ void ht_init(ht_table_t *table)
     (*table)[i] = NULL;
 }
 
+/*
+ * Uvolnění prvku vyjmutého z tabulky i s klíčem alokátorem, kterým vznikl.
+ */
+void ht_free_item(const allocator_t *allocator, ht_item_t *item)
+{
+  allocator_free(allocator, item->key, strlen(item->key) + 1);
+  allocator_free(allocator, item, sizeof(ht_item_t));
+}
+
 /*
  * Vyhledání prvku v tabulce.
  *
@@ -66,21 +76,34 @@ ht_item_t *ht_search(ht_table_t *table, char *key)
  * Při implementaci využijte funkci ht_search. Pri vkládání prvku do seznamu
  * synonym zvolte nejefektivnější možnost a vložte prvek na začátek seznamu.
  */
-void ht_insert(ht_table_t *table, char *key, float value)
+void ht_insert(ht_table_t *table, char *key, ht_value_t value)
+{
+  ht_insert_with(table, key, value, NULL);
+}
+
+/*
+ * Vložení prvku, jehož prvek i klíč alokuje alokátor allocator.
+ */
+void ht_insert_with(ht_table_t *table, char *key, ht_value_t value,
+                    const allocator_t *allocator)
 {
   int auxVar = get_hash(key);
   ht_item_t *exist = ht_search(table, key);
 
   if (exist == NULL)
   {
-    ht_item_t *new = (ht_item_t *)malloc(sizeof(ht_item_t));
+    ht_item_t *new = allocator_alloc(allocator, sizeof(ht_item_t));
     if (new == NULL)
       return;
 
-    char *key_word = (char *)malloc(sizeof(char) * (strlen(key) + 1));
+    size_t length = strlen(key) + 1;
+    char *key_word = allocator_alloc(allocator, length);
     if (key_word == NULL)
+    {
+      allocator_free(allocator, new, sizeof(ht_item_t));
       return;
-    strcpy(key_word, key);
+    }
+    memcpy(key_word, key, length);
     // Naplnenie hodnotami
     new->key = key_word;
     new->value = value;
@@ -101,7 +124,7 @@ void ht_insert(ht_table_t *table, char *key, float value)
  *
  * Při implementaci využijte funkci ht_search.
  */
-float *ht_get(ht_table_t *table, char *key)
+ht_value_t *ht_get(ht_table_t *table, char *key)
 {
   ht_item_t *element = ht_search(table, key);
   if (element == NULL)
@@ -109,6 +132,48 @@ float *ht_get(ht_table_t *table, char *key)
   return &(element->value);
 }
 
+/*
+ * Přičtení delta k hodnotě prvku (např. počtu výskytů klíče).
+ *
+ * Neexistující prvek se vloží s hodnotou delta. Na rozdíl od dvojice ht_get
+ * a ht_insert se klíč rozptýlí a seznam synonym projde jen jednou. Vrací
+ * ukazatel na hodnotu prvku, nebo NULL při nedostatku paměti.
+ */
+ht_value_t *ht_increment(ht_table_t *table, char *key, ht_value_t delta)
+{
+  return ht_increment_with(table, key, delta, NULL);
+}
+
+ht_value_t *ht_increment_with(ht_table_t *table, char *key, ht_value_t delta,
+                              const allocator_t *allocator)
+{
+  int hash = get_hash(key);
+  for (ht_item_t *item = (*table)[hash]; item != NULL; item = item->next)
+  {
+    if (strcmp(item->key, key) == 0)
+    {
+      item->value += delta;
+      return &item->value;
+    }
+  }
+
+  ht_item_t *new = allocator_alloc(allocator, sizeof(ht_item_t));
+  if (new == NULL)
+    return NULL;
+  size_t length = strlen(key) + 1;
+  new->key = allocator_alloc(allocator, length);
+  if (new->key == NULL)
+  {
+    allocator_free(allocator, new, sizeof(ht_item_t));
+    return NULL;
+  }
+  memcpy(new->key, key, length);
+  new->value = delta;
+  new->next = (*table)[hash];
+  (*table)[hash] = new;
+  return &new->value;
+}
+
 /*
  * Smazání prvku z tabulky.
  *
@@ -118,6 +183,12 @@ float *ht_get(ht_table_t *table, char *key)
  * Při implementaci NEPOUŽÍVEJTE funkci ht_search.
  */
 void ht_delete(ht_table_t *table, char *key)
+{
+  ht_delete_with(table, key, NULL);
+}
+
+void ht_delete_with(ht_table_t *table, char *key,
+                    const allocator_t *allocator)
 {
   int hash = get_hash(key);
   ht_item_t *item = (*table)[hash];
@@ -131,8 +202,7 @@ void ht_delete(ht_table_t *table, char *key)
         (*table)[hash] = item->next;
       else
         prev->next = item->next;
-      free(item->key);
-      free(item);
+      ht_free_item(allocator, item);
       return;
     }
     prev = item;
@@ -147,6 +217,11 @@ void ht_delete(ht_table_t *table, char *key)
  * inicializaci.
  */
 void ht_delete_all(ht_table_t *table)
+{
+  ht_delete_all_with(table, NULL);
+}
+
+void ht_delete_all_with(ht_table_t *table, const allocator_t *allocator)
 {
   ht_item_t *item;
   ht_item_t *futur;
@@ -157,8 +232,7 @@ void ht_delete_all(ht_table_t *table)
     while (item != NULL)
     {
       futur = item->next;
-      free(item->key);
-      free(item);
+      ht_free_item(allocator, item);
       item = futur;
     }
     (*table)[i] = NULL;
@@ -21,10 +21,18 @@
  */
 extern int HT_SIZE;
 
+// Hodnota prvku: float, pri preklade s -DHT_VALUE_DOUBLE double (napr. pre
+// počty výskytov, ktoré float nad 2^24 nevyjadrí presne)
+#ifdef HT_VALUE_DOUBLE
+typedef double ht_value_t;
+#else
+typedef float ht_value_t;
+#endif
+
 // Prvok tabuľky
 typedef struct ht_item {
   char *key;            // kľúč prvku
-  float value;          // hodnota prvku
+  ht_value_t value;     // hodnota prvku
   struct ht_item *next; // ukazateľ na ďalšie synonymum
 } ht_item_t;
 
@@ -34,9 +42,22 @@ typedef ht_item_t *ht_table_t[MAX_HT_SIZE];
 int get_hash(char *key);
 void ht_init(ht_table_t *table);
 ht_item_t *ht_search(ht_table_t *table, char *key);
-void ht_insert(ht_table_t *table, char *key, float data);
-float *ht_get(ht_table_t *table, char *key);
+void ht_insert(ht_table_t *table, char *key, ht_value_t data);
+ht_value_t *ht_get(ht_table_t *table, char *key);
+ht_value_t *ht_increment(ht_table_t *table, char *key, ht_value_t delta);
 void ht_delete(ht_table_t *table, char *key);
 void ht_delete_all(ht_table_t *table);
 
+// Varianty s alokátorom prvkov a kľúčov (../btree/alloc.h), NULL = malloc a
+// free; tabuľka sa mení aj ruší tým istým alokátorom, akým vznikla
+struct allocator;
+void ht_insert_with(ht_table_t *table, char *key, ht_value_t data,
+                    const struct allocator *allocator);
+ht_value_t *ht_increment_with(ht_table_t *table, char *key, ht_value_t delta,
+                              const struct allocator *allocator);
+void ht_delete_with(ht_table_t *table, char *key,
+                    const struct allocator *allocator);
+void ht_delete_all_with(ht_table_t *table, const struct allocator *allocator);
+void ht_free_item(const struct allocator *allocator, ht_item_t *item);
+
 #endif
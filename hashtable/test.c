@@ -1,4 +1,6 @@
 #include "hashtable.h"
+#include "../btree/alloc.h"
+#include "dump.h"
 #include "test_util.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -76,6 +78,56 @@ INSERT_TEST_DATA(test_table)
 ht_delete_all(test_table);
 ENDTEST
 
+TEST(test_increment, "Increment existing and new items")
+ht_init(test_table);
+INSERT_TEST_DATA(test_table)
+ht_increment(test_table, "Ethereum", 1);
+ht_increment(test_table, "Monero", 2);
+ht_print_item_value(ht_increment(test_table, "Monero", 3));
+ENDTEST
+
+TEST(test_dump_json, "Dump the table as JSON")
+ht_init(test_table);
+INSERT_TEST_DATA(test_table)
+ht_insert(test_table, "Wrapped \"BTC\"\t", 53180.25);
+dump_buffer_t dump;
+dump_init(&dump, stdout);
+ht_dump_json(&dump, test_table);
+dump_char(&dump, '\n');
+dump_flush(&dump);
+dump_dispose(&dump);
+ENDTEST
+
+TEST(test_allocator, "Allocate items with counting and arena allocators")
+const int count = sizeof(TEST_DATA) / sizeof(TEST_DATA[0]);
+counting_allocator_t counting;
+counting_init(&counting, NULL);
+const allocator_t *allocator = &counting.allocator;
+ht_init(test_table);
+for (int i = 0; i < count; i++)
+  ht_insert_with(test_table, TEST_DATA[i].key, TEST_DATA[i].value, allocator);
+ht_delete_with(test_table, "Tether", allocator);
+ht_increment_with(test_table, "Monero", 5.0, allocator);
+printf("Counting: %ld allocations, %ld releases\n",
+       atomic_load(&counting.allocations), atomic_load(&counting.releases));
+ht_delete_all_with(test_table, allocator);
+printf("After delete all: %ld releases, %ld live bytes\n",
+       atomic_load(&counting.releases), atomic_load(&counting.live_bytes));
+
+arena_t arena;
+arena_init(&arena, 1024, allocator);
+long before = atomic_load(&counting.allocations);
+for (int i = 0; i < count; i++)
+  ht_insert_with(test_table, TEST_DATA[i].key, TEST_DATA[i].value,
+                 &arena.allocator);
+printf("Arena chunks for %d items: %ld\n", count,
+       atomic_load(&counting.allocations) - before);
+ht_delete_all_with(test_table, &arena.allocator);
+arena_dispose(&arena);
+printf("After arena dispose: %ld live bytes\n",
+       atomic_load(&counting.live_bytes));
+ENDTEST
+
 int main(int argc, char *argv[]) {
   init_uninitialized_item();
   init_test();
@@ -90,6 +142,9 @@ int main(int argc, char *argv[]) {
   test_get();
   test_delete();
   test_delete_all();
+  test_increment();
+  test_dump_json();
+  test_allocator();
 
   free(uninitialized_item);
 }
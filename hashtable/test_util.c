@@ -1,11 +1,12 @@
 #include "test_util.h"
 #include "hashtable.h"
+#include "dump.h"
 #include <stdio.h>
 #include <stdlib.h>
 
 ht_item_t *uninitialized_item;
 
-void ht_print_item_value(float *value) {
+void ht_print_item_value(ht_value_t *value) {
   if (value != NULL) {
     printf("%.2f\n", *value);
   } else {
@@ -25,29 +26,31 @@ void ht_print_table(ht_table_t *table) {
   int max_count = 0;
   int sum_count = 0;
 
-  printf("------------HASH TABLE--------------\n");
   for (int i = 0; i < HT_SIZE; i++) {
-    printf("%i: ", i);
     int count = 0;
-    ht_item_t *item = (*table)[i];
-    while (item != NULL) {
-      printf("(%s,%.2f)", item->key, item->value);
+    for (ht_item_t *item = (*table)[i]; item != NULL; item = item->next) {
       if (item != uninitialized_item) {
         count++;
       }
-      item = item->next;
     }
-    printf("\n");
     if (count > max_count) {
       max_count = count;
     }
     sum_count += count;
   }
 
-  printf("------------------------------------\n");
-  printf("Total items in hash table: %i\n", sum_count);
-  printf("Maximum hash collisions: %i\n", max_count == 0 ? 0 : max_count - 1);
-  printf("------------------------------------\n");
+  dump_buffer_t dump;
+  dump_init(&dump, stdout);
+  dump_text(&dump, "------------HASH TABLE--------------\n");
+  ht_dump_table(&dump, table);
+  dump_text(&dump, "------------------------------------\n");
+  dump_text(&dump, "Total items in hash table: ");
+  dump_integer(&dump, sum_count);
+  dump_text(&dump, "\nMaximum hash collisions: ");
+  dump_integer(&dump, max_count == 0 ? 0 : max_count - 1);
+  dump_text(&dump, "\n------------------------------------\n");
+  dump_flush(&dump);
+  dump_dispose(&dump);
 }
 
 void init_uninitialized_item() {
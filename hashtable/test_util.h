@@ -19,7 +19,7 @@
 
 extern ht_item_t *uninitialized_item;
 
-void ht_print_item_value(float *value);
+void ht_print_item_value(ht_value_t *value);
 void ht_print_item(ht_item_t *item);
 void ht_print_table(ht_table_t *table);
 void ht_insert_many(ht_table_t *table, const ht_item_t items[], int count);
@@ -0,0 +1,112 @@
+/*
+ * Záznam volání ht_* (viz ../btree/trace.h)
+ *
+ * Program se linkuje s volbami -Wl,--wrap=ht_init,--wrap=ht_search,...
+ * (TRACE_WRAP v Makefile); volání z ostatních souborů pak projdou obaly
+ * __wrap_ht_*, které operaci zapíšou a zavolají původní __real_ht_*.
+ * Varianty s alokátorem (ht_*_with) se zapíší jako odpovídající operace
+ * bez něj.
+ */
+
+#include "hashtable.h"
+#include "../btree/trace.h"
+
+void __real_ht_init(ht_table_t *table);
+ht_item_t *__real_ht_search(ht_table_t *table, char *key);
+void __real_ht_insert(ht_table_t *table, char *key, ht_value_t value);
+ht_value_t *__real_ht_get(ht_table_t *table, char *key);
+ht_value_t *__real_ht_increment(ht_table_t *table, char *key,
+                                ht_value_t delta);
+void __real_ht_delete(ht_table_t *table, char *key);
+void __real_ht_delete_all(ht_table_t *table);
+void __real_ht_insert_with(ht_table_t *table, char *key, ht_value_t value,
+                           const struct allocator *allocator);
+ht_value_t *__real_ht_increment_with(ht_table_t *table, char *key,
+                                     ht_value_t delta,
+                                     const struct allocator *allocator);
+void __real_ht_delete_with(ht_table_t *table, char *key,
+                           const struct allocator *allocator);
+void __real_ht_delete_all_with(ht_table_t *table,
+                               const struct allocator *allocator);
+
+static void ht_trace(trace_kind_t kind, ht_table_t *table, const char *key,
+                     double value)
+{
+  if (!trace_active())
+    return;
+  trace_lock();
+  trace_record_ht(kind, trace_handle(table), key, value);
+  trace_unlock();
+}
+
+void __wrap_ht_init(ht_table_t *table)
+{
+  ht_trace(TRACE_HT_INIT, table, NULL, HT_SIZE);
+  __real_ht_init(table);
+}
+
+ht_item_t *__wrap_ht_search(ht_table_t *table, char *key)
+{
+  ht_trace(TRACE_HT_SEARCH, table, key, 0);
+  return __real_ht_search(table, key);
+}
+
+void __wrap_ht_insert(ht_table_t *table, char *key, ht_value_t value)
+{
+  ht_trace(TRACE_HT_INSERT, table, key, value);
+  __real_ht_insert(table, key, value);
+}
+
+ht_value_t *__wrap_ht_get(ht_table_t *table, char *key)
+{
+  ht_trace(TRACE_HT_GET, table, key, 0);
+  return __real_ht_get(table, key);
+}
+
+ht_value_t *__wrap_ht_increment(ht_table_t *table, char *key,
+                                ht_value_t delta)
+{
+  ht_trace(TRACE_HT_INCREMENT, table, key, delta);
+  return __real_ht_increment(table, key, delta);
+}
+
+void __wrap_ht_delete(ht_table_t *table, char *key)
+{
+  ht_trace(TRACE_HT_DELETE, table, key, 0);
+  __real_ht_delete(table, key);
+}
+
+void __wrap_ht_delete_all(ht_table_t *table)
+{
+  ht_trace(TRACE_HT_DELETE_ALL, table, NULL, 0);
+  __real_ht_delete_all(table);
+}
+
+void __wrap_ht_insert_with(ht_table_t *table, char *key, ht_value_t value,
+                           const struct allocator *allocator)
+{
+  ht_trace(TRACE_HT_INSERT, table, key, value);
+  __real_ht_insert_with(table, key, value, allocator);
+}
+
+ht_value_t *__wrap_ht_increment_with(ht_table_t *table, char *key,
+                                     ht_value_t delta,
+                                     const struct allocator *allocator)
+{
+  ht_trace(TRACE_HT_INCREMENT, table, key, delta);
+  return __real_ht_increment_with(table, key, delta, allocator);
+}
+
+void __wrap_ht_delete_with(ht_table_t *table, char *key,
+                           const struct allocator *allocator)
+{
+  ht_trace(TRACE_HT_DELETE, table, key, 0);
+  __real_ht_delete_with(table, key, allocator);
+}
+
+void __wrap_ht_delete_all_with(ht_table_t *table,
+                               const struct allocator *allocator)
+{
+  ht_trace(TRACE_HT_DELETE_ALL, table, NULL, 0);
+  __real_ht_delete_all_with(table, allocator);
+}
@@ -0,0 +1,246 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "wordfreq.h"
+#include "../../btree/bench_util.h"
+#include "../../btree/pool.h"
+#include "test_util.h"
+#include "topk.h"
+#include <math.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+const size_t text_size = 64 << 20;
+
+void init_bench() {
+  printf("Word Frequencies - benchmark\n");
+  printf("----------------------------\n");
+  printf("\n");
+}
+
+static void bench_tokens(const char *label, wf_table_t *table, double seconds) {
+  bench_report(label, table->tokens, seconds);
+  printf("  %-32s %10.2f M tokens/s\n", "throughput",
+         table->tokens / seconds / 1e6);
+}
+
+BENCH(bench_increment, "Single-pass ht_increment vs ht_get + ht_insert (1M words)")
+const int words = 1 << 20;
+char *text = wf_generate_text(8 << 20);
+char **tokens = malloc(words * sizeof(char *));
+char *cursor = text;
+for (int i = 0; i < words; i++) {
+  // Slova generovaneho textu su oddelene medzerou, ciarkou alebo bodkou
+  cursor += strspn(cursor, " ,.-\n");
+  tokens[i] = cursor;
+  cursor += strcspn(cursor, " ,.-\n");
+  *cursor++ = '\0';
+}
+for (int mode = 0; mode < 2; mode++) {
+  ht_table_t table;
+  ht_init(&table);
+  double start = bench_now();
+  for (int i = 0; i < words; i++) {
+    if (mode == 0) {
+      ht_increment(&table, tokens[i], 1);
+    } else {
+      ht_value_t *count = ht_get(&table, tokens[i]);
+      ht_insert(&table, tokens[i], count != NULL ? *count + 1 : 1);
+    }
+  }
+  bench_report(mode == 0 ? "ht_increment" : "ht_get + ht_insert", words,
+               bench_now() - start);
+  ht_delete_all(&table);
+}
+free(tokens);
+free(text);
+ENDBENCH
+
+BENCH(bench_count, "Count words and bigrams of 64 MB: in memory and from a file, 1-4 threads")
+const char *path = "bench_words.txt";
+char *text = wf_generate_text(text_size);
+FILE *file = fopen(path, "w");
+fwrite(text, 1, text_size, file);
+fclose(file);
+wf_table_t *table = malloc(sizeof(wf_table_t));
+for (int ngram = 1; ngram <= 2; ngram++) {
+  char label[48];
+  wf_init(table);
+  double start = bench_now();
+  wf_count(table, text, text_size, ngram);
+  snprintf(label, sizeof(label), "n=%d wf_count", ngram);
+  bench_tokens(label, table, bench_now() - start);
+  wf_dispose(table);
+  for (int threads = 1; threads <= 4; threads *= 2) {
+    bst_pool_t *pool = bst_pool_create(threads);
+    int fd = open(path, O_RDONLY);
+    start = bench_now();
+    wf_count_fd(table, fd, ngram, pool);
+    snprintf(label, sizeof(label), "n=%d wf_count_fd %d threads", ngram,
+             threads);
+    bench_tokens(label, table, bench_now() - start);
+    close(fd);
+    bst_pool_destroy(pool);
+    if (threads < 4) {
+      wf_dispose(table);
+    }
+  }
+  wf_entry_t *entries;
+  for (int k = 10; k <= 1000; k *= 100) {
+    start = bench_now();
+    int count = wf_top(table, k, &entries);
+    snprintf(label, sizeof(label), "n=%d wf_top %d", ngram, k);
+    bench_report(label, count, bench_now() - start);
+    free(entries);
+  }
+  wf_dispose(table);
+}
+free(table);
+free(text);
+remove(path);
+ENDBENCH
+
+/*
+ * Tabuľka distinct kľúčov "k<i>" s počtami podľa Zipfovho rozdelenia a
+ * prúd kľúčov s rovnakým rozdelením.
+ */
+static char **bench_zipf_keys(int distinct) {
+  char **keys = malloc(distinct * sizeof(char *));
+  for (int i = 0; i < distinct; i++) {
+    keys[i] = malloc(16);
+    snprintf(keys[i], 16, "k%d", i);
+  }
+  return keys;
+}
+
+static int bench_zipf(int distinct) {
+  // Inverzia spojitej aproximacie Zipfovho rozdelenia s exponentom 1
+  double u = (bench_rand() >> 11) * (1.0 / 9007199254740992.0);
+  int index = (int)exp(u * log(distinct + 1.0)) - 1;
+  return index < distinct ? index : distinct - 1;
+}
+
+static int bench_compare_entries(const void *a, const void *b) {
+  const wf_entry_t *x = a;
+  const wf_entry_t *y = b;
+  if (x->count != y->count) {
+    return x->count > y->count ? -1 : 1;
+  }
+  return strcmp(x->token, y->token);
+}
+
+BENCH(bench_topk, "Top 100 of 1M distinct keys: heap, bounded tree, full sort")
+const int distinct = 1 << 20;
+char **keys = bench_zipf_keys(distinct);
+wf_table_t *table = malloc(sizeof(wf_table_t));
+wf_init(table);
+bench_seed(11);
+for (int i = 0; i < distinct; i++) {
+  wf_add(table, keys[i], 1 + bench_zipf(distinct) % 1000);
+}
+topk_entry_t *heap_entries;
+double start = bench_now();
+int count = topk_wf(table, 100, &heap_entries);
+bench_report("topk_wf (heap)", distinct, bench_now() - start);
+wf_entry_t *tree_entries;
+start = bench_now();
+wf_top(table, 100, &tree_entries);
+bench_report("wf_top (bounded tree)", distinct, bench_now() - start);
+start = bench_now();
+wf_entry_t *all;
+int size = 0;
+all = malloc(distinct * sizeof(wf_entry_t));
+for (int s = 0; s < WF_SHARDS; s++) {
+  for (int b = 0; b < HT_SIZE; b++) {
+    for (ht_item_t *item = table->shards[s][b]; item != NULL; item = item->next) {
+      all[size++] = (wf_entry_t){item->key, (long)item->value};
+    }
+  }
+}
+qsort(all, size, sizeof(wf_entry_t), bench_compare_entries);
+bench_report("collect + qsort", distinct, bench_now() - start);
+int differences = 0;
+for (int i = 0; i < count; i++) {
+  differences += strcmp(heap_entries[i].token, all[i].token) != 0 ||
+                 strcmp(tree_entries[i].token, all[i].token) != 0;
+}
+printf("  %-32s %d\n", "differences from qsort", differences);
+free(all);
+free(heap_entries);
+free(tree_entries);
+wf_dispose(table);
+free(table);
+for (int i = 0; i < distinct; i++) {
+  free(keys[i]);
+}
+free(keys);
+ENDBENCH
+
+BENCH(bench_sketch, "Space-Saving vs exact counting of 4M Zipf keys over 256k distinct")
+const int distinct = 1 << 18;
+const int stream = 4 << 20;
+const int counters[] = {1000, 10000};
+char **keys = bench_zipf_keys(distinct);
+int *order = malloc(stream * sizeof(int));
+bench_seed(12);
+for (int i = 0; i < stream; i++) {
+  order[i] = bench_zipf(distinct);
+}
+wf_table_t *table = malloc(sizeof(wf_table_t));
+wf_init(table);
+double start = bench_now();
+for (int i = 0; i < stream; i++) {
+  wf_add(table, keys[order[i]], 1);
+}
+bench_report("exact wf_add", stream, bench_now() - start);
+for (int c = 0; c < 2; c++) {
+  char label[48];
+  topk_sketch_t sketch;
+  topk_sketch_init(&sketch, counters[c], 16);
+  start = bench_now();
+  for (int i = 0; i < stream; i++) {
+    topk_sketch_add(&sketch, keys[order[i]], 1);
+  }
+  snprintf(label, sizeof(label), "sketch %d counters", counters[c]);
+  bench_report(label, stream, bench_now() - start);
+  // Presnost odhadov najcastejsich 100 klucov
+  topk_entry_t *entries;
+  int count = topk_sketch_top(&sketch, 100, &entries);
+  int outside = 0;
+  long worst = 0;
+  for (int i = 0; i < count; i++) {
+    ht_value_t *exact = NULL;
+    for (int s = 0; s < WF_SHARDS && exact == NULL; s++) {
+      exact = ht_get(&table->shards[s], (char *)entries[i].token);
+    }
+    long value = exact != NULL ? (long)*exact : 0;
+    outside += value > entries[i].count ||
+               value < entries[i].count - entries[i].error;
+    if (entries[i].count - value > worst) {
+      worst = entries[i].count - value;
+    }
+  }
+  printf("  %-32s bound %ld, worst top-100 overestimate %ld, outside %d\n",
+         "error", topk_sketch_bound(&sketch), worst, outside);
+  free(entries);
+  topk_sketch_dispose(&sketch);
+}
+wf_dispose(table);
+free(table);
+free(order);
+for (int i = 0; i < distinct; i++) {
+  free(keys[i]);
+}
+free(keys);
+ENDBENCH
+
+int main(int argc, char *argv[]) {
+  init_bench();
+
+  bench_increment();
+  bench_count();
+  bench_topk();
+  bench_sketch();
+}
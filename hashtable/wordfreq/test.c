@@ -0,0 +1,230 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "wordfreq.h"
+#include "../../btree/pool.h"
+#include "topk.h"
+#include "test_util.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+const char *sample_text =
+    "The cat and the hat. THE end! A cat, a hat, and the bat; "
+    "the cat sat on the hat.";
+
+void init_test() {
+  printf("Word Frequencies - testing script\n");
+  printf("---------------------------------\n");
+  printf("\n");
+}
+
+/*
+ * Počet rozdielov medzi úplnými zoradenými výsledkami dvoch tabuliek.
+ */
+int wf_count_differences(wf_table_t *table, wf_table_t *other) {
+  wf_entry_t *entries;
+  wf_entry_t *others;
+  int count = wf_top(table, -1, &entries);
+  int other_count = wf_top(other, -1, &others);
+  int differences = abs(count - other_count);
+  for (int i = 0; i < count && i < other_count; i++) {
+    differences += entries[i].count != others[i].count ||
+                   strcmp(entries[i].token, others[i].token) != 0;
+  }
+  free(entries);
+  free(others);
+  return differences;
+}
+
+TEST(test_empty, "Count an empty text")
+wf_count_string(test_table, "", 1);
+wf_print_top(test_table, -1);
+ENDTEST
+
+TEST(test_count_words, "Count words of a short text")
+wf_count_string(test_table, sample_text, 1);
+wf_print_top(test_table, -1);
+ENDTEST
+
+TEST(test_count_bigrams, "Count bigrams of a short text")
+wf_count_string(test_table, sample_text, 2);
+wf_print_top(test_table, 6);
+ENDTEST
+
+TEST(test_top_ties, "Top 3 keeps the alphabetically first of equal counts")
+wf_count_string(test_table, "d c b a c b a b a a e e e", 1);
+wf_print_top(test_table, 3);
+ENDTEST
+
+TEST(test_long_words, "Truncate words longer than WF_WORD_MAX")
+char text[3 * WF_WORD_MAX];
+memset(text, 'x', sizeof(text) - 1);
+text[sizeof(text) - 1] = '\0';
+text[WF_WORD_MAX + 10] = ' ';
+wf_count_string(test_table, text, 1);
+wf_entry_t *entries;
+int count = wf_top(test_table, -1, &entries);
+for (int i = 0; i < count; i++) {
+  printf("Length %zu, count %ld\n", strlen(entries[i].token), entries[i].count);
+}
+free(entries);
+ENDTEST
+
+TEST(test_merge, "Merge two tables")
+wf_table_t *other = malloc(sizeof(wf_table_t));
+wf_init(other);
+wf_count_string(test_table, "one two two three three three", 1);
+wf_count_string(other, "three four four one", 1);
+wf_merge(test_table, other);
+wf_print_top(test_table, -1);
+wf_print_top(other, -1);
+free(other);
+ENDTEST
+
+TEST(test_count_fd, "Count a 3 MB file in parallel chunks (words and trigrams)")
+const size_t length = 3 * (1 << 20) + 12345;
+char *text = wf_generate_text(length);
+FILE *file = fopen("test_words.txt", "w");
+fwrite(text, 1, length, file);
+fclose(file);
+bst_pool_t *pool = bst_pool_create(3);
+for (int ngram = 1; ngram <= 3; ngram += 2) {
+  wf_table_t *expected = malloc(sizeof(wf_table_t));
+  wf_init(expected);
+  wf_count(expected, text, length, ngram);
+  wf_dispose(test_table);
+  int fd = open("test_words.txt", O_RDONLY);
+  bool valid = wf_count_fd(test_table, fd, ngram, pool);
+  close(fd);
+  printf("n = %d: valid %s, tokens %ld, differences from a single pass: %d\n",
+         ngram, valid ? "yes" : "no", test_table->tokens,
+         wf_count_differences(test_table, expected));
+  wf_dispose(expected);
+  free(expected);
+}
+wf_print_top(test_table, 5);
+bst_pool_destroy(pool);
+free(text);
+remove("test_words.txt");
+ENDTEST
+
+TEST(test_topk_table, "Top 3 items of a hash table by value")
+ht_table_t table;
+ht_init(&table);
+const char *keys[] = {"pear", "fig", "apple", "kiwi", "lime", "plum"};
+const int counts[] = {4, 9, 4, 1, 9, 7};
+for (int i = 0; i < 6; i++) {
+  ht_insert(&table, (char *)keys[i], counts[i]);
+}
+topk_entry_t *entries;
+int count = topk_table(&table, 3, &entries);
+topk_print(entries, count);
+free(entries);
+count = topk_table(&table, 10, &entries);
+topk_print(entries, count);
+free(entries);
+ht_delete_all(&table);
+ENDTEST
+
+TEST(test_topk_wf, "Top 4 words of a text agree with wf_top")
+wf_count_string(test_table, sample_text, 1);
+topk_entry_t *entries;
+int count = topk_wf(test_table, 4, &entries);
+topk_print(entries, count);
+free(entries);
+wf_print_top(test_table, 4);
+ENDTEST
+
+TEST(test_topk_tree, "Top 3 letters of a frequency tree")
+bst_node_t *tree;
+bst_init(&tree);
+const char letters[] = "hello world";
+for (int i = 0; letters[i] != '\0'; i++) {
+  bst_node_content_t *content = NULL;
+  if (bst_search(tree, letters[i], &content)) {
+    (*(int *)content->value)++;
+  } else {
+    int *value = malloc(sizeof(int));
+    *value = 1;
+    bst_insert(&tree, letters[i],
+               (bst_node_content_t){.value = value, .type = INTEGER});
+  }
+}
+topk_entry_t *entries;
+int count = topk_tree(tree, 3, &entries);
+topk_print(entries, count);
+free(entries);
+bst_dispose(&tree);
+ENDTEST
+
+static void topk_visit_sketch(char *token, void *data) {
+  topk_sketch_add(data, token, 1);
+}
+
+TEST(test_topk_sketch_small, "Space-Saving with 3 counters on a short stream")
+topk_sketch_t sketch;
+topk_sketch_init(&sketch, 3, 16);
+const char *stream[] = {"a", "b", "a", "c", "d", "a", "b", "e", "a", "b"};
+for (int i = 0; i < 10; i++) {
+  topk_sketch_add(&sketch, stream[i], 1);
+}
+topk_entry_t *entries;
+int count = topk_sketch_top(&sketch, 3, &entries);
+topk_print(entries, count);
+printf("Total: %ld, error bound: %ld\n", sketch.total,
+       topk_sketch_bound(&sketch));
+free(entries);
+topk_sketch_dispose(&sketch);
+ENDTEST
+
+TEST(test_topk_sketch_bounds, "Space-Saving bigrams of 1 MB with 64 counters")
+const size_t length = 1 << 20;
+char *text = wf_generate_text(length);
+wf_count(test_table, text, length, 2);
+topk_sketch_t sketch;
+topk_sketch_init(&sketch, 64, WF_NGRAM_MAX * (WF_WORD_MAX + 1));
+wf_tokenize(text, length, 2, topk_visit_sketch, &sketch);
+topk_entry_t *entries;
+int count = topk_sketch_top(&sketch, 64, &entries);
+// Kazdy odhad musi ohranicit presny pocet
+int outside = 0;
+for (int i = 0; i < count; i++) {
+  ht_value_t *exact = NULL;
+  for (int s = 0; s < WF_SHARDS && exact == NULL; s++) {
+    exact = ht_get(&test_table->shards[s], (char *)entries[i].token);
+  }
+  long value = exact != NULL ? (long)*exact : 0;
+  outside += value > entries[i].count ||
+             value < entries[i].count - entries[i].error;
+}
+printf("Counters: %d, keys outside their bounds: %d\n", count, outside);
+printf("Error bound %s total / counters\n",
+       topk_sketch_bound(&sketch) <= sketch.total / 64 ? "<=" : ">");
+topk_print(entries, 5);
+free(entries);
+topk_entry_t *exact;
+count = topk_wf(test_table, 5, &exact);
+topk_print(exact, count);
+free(exact);
+topk_sketch_dispose(&sketch);
+free(text);
+ENDTEST
+
+int main(int argc, char *argv[]) {
+  init_test();
+
+  test_empty();
+  test_count_words();
+  test_count_bigrams();
+  test_top_ties();
+  test_long_words();
+  test_merge();
+  test_count_fd();
+  test_topk_table();
+  test_topk_wf();
+  test_topk_tree();
+  test_topk_sketch_small();
+  test_topk_sketch_bounds();
+}
@@ -0,0 +1,72 @@
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void wf_print_top(wf_table_t *table, int k) {
+  wf_entry_t *entries;
+  int count = wf_top(table, k, &entries);
+  printf("Tokens: %ld, top %d:\n", table->tokens, count);
+  for (int i = 0; i < count; i++) {
+    printf("  %-24s %ld\n", entries[i].token, entries[i].count);
+  }
+  free(entries);
+}
+
+void topk_print(topk_entry_t *entries, int count) {
+  printf("Top %d:\n", count);
+  for (int i = 0; i < count; i++) {
+    char key[16];
+    if (entries[i].token == NULL) {
+      snprintf(key, sizeof(key), "'%c'", (int)entries[i].key);
+    }
+    printf("  %-24s %ld", entries[i].token != NULL ? entries[i].token : key,
+           entries[i].count);
+    if (entries[i].error != 0) {
+      printf(" (error <= %ld)", entries[i].error);
+    }
+    printf("\n");
+  }
+}
+
+void wf_count_string(wf_table_t *table, const char *text, int ngram) {
+  wf_count(table, text, strlen(text), ngram);
+}
+
+/*
+ * Pseudonáhodný text zo slov malej slovnej zásoby s nerovnomernými
+ * frekvenciami, oddelených medzerami, čiarkami a koncami riadkov.
+ */
+char *wf_generate_text(size_t length) {
+  static const char *words[] = {"the", "of",   "and",   "a",    "to",
+                                "in",  "is",   "you",   "that", "it",
+                                "he",  "was",  "for",   "on",   "are",
+                                "as",  "with", "his",   "they", "I",
+                                "at",  "be",   "this",  "have", "from",
+                                "or",  "one",  "had",   "by",   "Word",
+                                "but", "not",  "what",  "all",  "were"};
+  const int count = sizeof(words) / sizeof(words[0]);
+  const char *separators[] = {" ", " ", " ", ", ", ".\n", " -- "};
+  char *text = malloc(length + 1);
+  unsigned int seed = 7;
+  size_t size = 0;
+  while (true) {
+    seed = seed * 1103515245 + 12345;
+    // Mensie indexy su castejsie
+    int index = (seed >> 16) % count;
+    index = index * index / count;
+    seed = seed * 1103515245 + 12345;
+    const char *separator = separators[(seed >> 16) % 6];
+    size_t word = strlen(words[index]);
+    size_t gap = strlen(separator);
+    if (size + word + gap > length) {
+      break;
+    }
+    memcpy(text + size, words[index], word);
+    memcpy(text + size + word, separator, gap);
+    size += word + gap;
+  }
+  memset(text + size, ' ', length - size);
+  text[length] = '\0';
+  return text;
+}
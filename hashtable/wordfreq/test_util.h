@@ -0,0 +1,26 @@
+#ifndef IAL_HASHTABLE_WORDFREQ_TEST_UTIL_H
+#define IAL_HASHTABLE_WORDFREQ_TEST_UTIL_H
+
+#include "topk.h"
+#include "wordfreq.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(NAME, DESCRIPTION)                                                \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    wf_table_t *test_table = malloc(sizeof(wf_table_t));                       \
+    wf_init(test_table);
+
+#define ENDTEST                                                                \
+  printf("\n");                                                                \
+  wf_dispose(test_table);                                                      \
+  free(test_table);                                                            \
+  }
+
+void wf_print_top(wf_table_t *table, int k);
+void topk_print(topk_entry_t *entries, int count);
+void wf_count_string(wf_table_t *table, const char *text, int ngram);
+char *wf_generate_text(size_t length);
+
+#endif
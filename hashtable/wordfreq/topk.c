@@ -0,0 +1,422 @@
+/*
+ * Výber najčastejších kľúčov
+ *
+ * Presný výber prejde všetky kľúče a drží len k najlepších v halde s
+ * najhorším na vrchole, takže stojí O(n log k) času a O(k) pamäti namiesto
+ * zoradenia všetkých n kľúčov. Zdrojom je ht_table_t, tabuľka frekvencií
+ * z wordfreq.h alebo strom z letter_count (hodnoty typu INTEGER).
+ *
+ * Približný výber (Space-Saving) počíta prúd kľúčov v pevnom počte
+ * počítadiel; počítadlá sú v halde podľa počtu a kľúče sa hľadajú v
+ * rozptylovej tabuľke s otvoreným adresovaním.
+ */
+
+#include "topk.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Poradie položiek: vyšší počet skôr, pri zhode menší kľúč.
+ */
+static bool topk_better(const topk_entry_t *a, const topk_entry_t *b)
+{
+  if (a->count != b->count)
+    return a->count > b->count;
+  if (a->token != NULL && b->token != NULL)
+    return strcmp(a->token, b->token) < 0;
+  return a->key < b->key;
+}
+
+static void topk_sift_down(topk_entry_t *entries, int size, int i)
+{
+  topk_entry_t entry = entries[i];
+  while (2 * i + 1 < size)
+  {
+    // Horsi z potomkov postupuje nahor
+    int child = 2 * i + 1;
+    if (child + 1 < size && topk_better(&entries[child], &entries[child + 1]))
+      child++;
+    if (!topk_better(&entry, &entries[child]))
+      break;
+    entries[i] = entries[child];
+    i = child;
+  }
+  entries[i] = entry;
+}
+
+/*
+ * Inicializácia haldy pre k najlepších položiek. Vracia false pri
+ * nedostatku pamäti alebo pre k < 1.
+ */
+bool topk_init(topk_heap_t *heap, int k)
+{
+  heap->size = 0;
+  heap->capacity = k > 0 ? k : 0;
+  heap->entries = k > 0 ? malloc(k * sizeof(topk_entry_t)) : NULL;
+  return heap->entries != NULL;
+}
+
+/*
+ * Ponúknutie položky; do plnej haldy sa dostane, len ak je lepšia než
+ * najhoršia z nich.
+ */
+void topk_offer(topk_heap_t *heap, topk_entry_t entry)
+{
+  topk_entry_t *entries = heap->entries;
+  if (heap->size < heap->capacity)
+  {
+    int i = heap->size++;
+    while (i > 0 && topk_better(&entries[(i - 1) / 2], &entry))
+    {
+      entries[i] = entries[(i - 1) / 2];
+      i = (i - 1) / 2;
+    }
+    entries[i] = entry;
+  }
+  else if (heap->capacity > 0 && topk_better(&entry, &entries[0]))
+  {
+    entries[0] = entry;
+    topk_sift_down(entries, heap->size, 0);
+  }
+}
+
+/*
+ * Zoradenie položiek haldy od najlepšej a ich odovzdanie volajúcemu (pole
+ * uvoľní funkciou free). Vracia počet položiek; halda zostane prázdna.
+ */
+int topk_finish(topk_heap_t *heap, topk_entry_t **entries)
+{
+  int size = heap->size;
+  // Najhorsia z vrcholu ide na koniec zmensujucej sa haldy
+  for (int end = size - 1; end > 0; end--)
+  {
+    topk_entry_t worst = heap->entries[0];
+    heap->entries[0] = heap->entries[end];
+    heap->entries[end] = worst;
+    topk_sift_down(heap->entries, end, 0);
+  }
+  *entries = heap->entries;
+  heap->entries = NULL;
+  heap->size = 0;
+  heap->capacity = 0;
+  return size;
+}
+
+void topk_dispose(topk_heap_t *heap)
+{
+  free(heap->entries);
+  heap->entries = NULL;
+  heap->size = 0;
+  heap->capacity = 0;
+}
+
+static void topk_offer_table(topk_heap_t *heap, ht_table_t *table)
+{
+  for (int b = 0; b < HT_SIZE; b++)
+  {
+    for (ht_item_t *item = (*table)[b]; item != NULL; item = item->next)
+    {
+      topk_entry_t entry = {(long)item->value, 0, item->key, 0};
+      topk_offer(heap, entry);
+    }
+  }
+}
+
+/*
+ * Najčastejších k kľúčov tabuľky (hodnota prvku je počet). Výsledok je
+ * nové pole *entries zoradené od najčastejšieho, funkcia vracia jeho dĺžku.
+ */
+int topk_table(ht_table_t *table, int k, topk_entry_t **entries)
+{
+  topk_heap_t heap;
+  *entries = NULL;
+  if (!topk_init(&heap, k))
+    return 0;
+  topk_offer_table(&heap, table);
+  return topk_finish(&heap, entries);
+}
+
+/*
+ * Totéž pre tabuľku frekvencií.
+ */
+int topk_wf(wf_table_t *table, int k, topk_entry_t **entries)
+{
+  topk_heap_t heap;
+  *entries = NULL;
+  if (!topk_init(&heap, k))
+    return 0;
+  for (int s = 0; s < WF_SHARDS; s++)
+    topk_offer_table(&heap, &table->shards[s]);
+  return topk_finish(&heap, entries);
+}
+
+/*
+ * Totéž pre strom s hodnotami typu INTEGER (napr. z letter_count); uzly s
+ * inou hodnotou sa preskočia. Strom sa prechádza s vlastným zásobníkom,
+ * hĺbka stromu preto nie je obmedzená zásobníkom volaní. Ak sa zásobník
+ * nepodarí alokovať alebo zväčšiť, vracia -1 a *entries zostane NULL;
+ * neúplný výsledok sa nevracia.
+ */
+int topk_tree(bst_node_t *tree, int k, topk_entry_t **entries)
+{
+  topk_heap_t heap;
+  *entries = NULL;
+  if (!topk_init(&heap, k))
+    return 0;
+
+  bst_node_t **stack = NULL;
+  int size = 0;
+  int capacity = 0;
+  if (tree != NULL)
+  {
+    stack = malloc((capacity = 32) * sizeof(bst_node_t *));
+    if (stack == NULL)
+    {
+      topk_dispose(&heap);
+      return -1;
+    }
+    stack[size++] = tree;
+  }
+  while (size > 0)
+  {
+    bst_node_t *node = stack[--size];
+    if (node->content.type == INTEGER && node->content.value != NULL)
+    {
+      topk_entry_t entry = {*(int *)node->content.value, 0, NULL, node->key};
+      topk_offer(&heap, entry);
+    }
+    if (size + 2 > capacity)
+    {
+      capacity *= 2;
+      bst_node_t **grown = realloc(stack, capacity * sizeof(bst_node_t *));
+      if (grown == NULL)
+      {
+        free(stack);
+        topk_dispose(&heap);
+        return -1;
+      }
+      stack = grown;
+    }
+    if (node->right != NULL)
+      stack[size++] = node->right;
+    if (node->left != NULL)
+      stack[size++] = node->left;
+  }
+  free(stack);
+  return topk_finish(&heap, entries);
+}
+
+/*
+ * FNV-1a nad najviac length bajtmi kľúča.
+ */
+static uint64_t topk_hash(const char *key, int length)
+{
+  uint64_t hash = 14695981039346656037u;
+  for (int i = 0; i < length && key[i] != '\0'; i++)
+  {
+    hash ^= (unsigned char)key[i];
+    hash *= 1099511628211u;
+  }
+  return hash;
+}
+
+/*
+ * Inicializácia náčrtu s counters počítadlami pre kľúče dlhé najviac
+ * key_max - 1 bajtov. Všetka pamäť sa alokuje tu. Vracia false pri
+ * nedostatku pamäti alebo neplatných parametroch.
+ */
+bool topk_sketch_init(topk_sketch_t *sketch, int counters, int key_max)
+{
+  int slots = 1;
+  while (counters > 0 && slots < 2 * counters)
+    slots *= 2;
+  sketch->capacity = counters;
+  sketch->key_max = key_max;
+  sketch->size = 0;
+  sketch->total = 0;
+  sketch->index_mask = slots - 1;
+  sketch->counters = malloc(counters * sizeof(topk_counter_t));
+  sketch->keys = malloc((size_t)counters * key_max);
+  sketch->heap = malloc(counters * sizeof(int));
+  sketch->index = calloc(slots, sizeof(int));
+  if (counters < 1 || key_max < 2 || sketch->counters == NULL ||
+      sketch->keys == NULL || sketch->heap == NULL || sketch->index == NULL)
+  {
+    topk_sketch_dispose(sketch);
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Posun počítadla na pozícii i haldy nadol po zvýšení jeho počtu.
+ */
+static void topk_sketch_sift_down(topk_sketch_t *sketch, int i)
+{
+  int *heap = sketch->heap;
+  topk_counter_t *counters = sketch->counters;
+  int counter = heap[i];
+  while (2 * i + 1 < sketch->size)
+  {
+    int child = 2 * i + 1;
+    if (child + 1 < sketch->size &&
+        counters[heap[child + 1]].count < counters[heap[child]].count)
+      child++;
+    if (counters[heap[child]].count >= counters[counter].count)
+      break;
+    heap[i] = heap[child];
+    counters[heap[i]].position = i;
+    i = child;
+  }
+  heap[i] = counter;
+  counters[counter].position = i;
+}
+
+/*
+ * Posun nového počítadla na pozícii i haldy nahor.
+ */
+static void topk_sketch_sift_up(topk_sketch_t *sketch, int i)
+{
+  int *heap = sketch->heap;
+  topk_counter_t *counters = sketch->counters;
+  int counter = heap[i];
+  while (i > 0 && counters[heap[(i - 1) / 2]].count > counters[counter].count)
+  {
+    heap[i] = heap[(i - 1) / 2];
+    counters[heap[i]].position = i;
+    i = (i - 1) / 2;
+  }
+  heap[i] = counter;
+  counters[counter].position = i;
+}
+
+/*
+ * Odstránenie počítadla z rozptylovej tabuľky. Nasledujúce položky toho
+ * istého úseku sa posunú späť do uvoľneného miesta, ak ich domovský index
+ * neleží medzi ním a ich pozíciou, aby ich hľadanie nenarazilo na dieru.
+ */
+static void topk_sketch_unindex(topk_sketch_t *sketch, int counter)
+{
+  int mask = sketch->index_mask;
+  int hole = sketch->counters[counter].hash & mask;
+  while (sketch->index[hole] != counter + 1)
+    hole = (hole + 1) & mask;
+
+  int next = (hole + 1) & mask;
+  while (sketch->index[next] != 0)
+  {
+    int home = sketch->counters[sketch->index[next] - 1].hash & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask))
+    {
+      sketch->index[hole] = sketch->index[next];
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+  sketch->index[hole] = 0;
+}
+
+/*
+ * Pripočítanie count výskytov kľúča.
+ */
+void topk_sketch_add(topk_sketch_t *sketch, const char *key, long count)
+{
+  int length = sketch->key_max - 1;
+  uint64_t hash = topk_hash(key, length);
+  int mask = sketch->index_mask;
+  int slot = hash & mask;
+  sketch->total += count;
+
+  for (; sketch->index[slot] != 0; slot = (slot + 1) & mask)
+  {
+    int counter = sketch->index[slot] - 1;
+    if (sketch->counters[counter].hash == hash &&
+        strncmp(sketch->keys + (size_t)counter * sketch->key_max, key,
+                length) == 0)
+    {
+      sketch->counters[counter].count += count;
+      topk_sketch_sift_down(sketch, sketch->counters[counter].position);
+      return;
+    }
+  }
+
+  int counter;
+  int position;
+  long minimum = 0;
+  if (sketch->size < sketch->capacity)
+  {
+    counter = sketch->size;
+    position = sketch->size++;
+  }
+  else
+  {
+    // Nahradenie pocitadla s najmensim poctom, ktory sa stane chybou
+    counter = sketch->heap[0];
+    position = 0;
+    minimum = sketch->counters[counter].count;
+    topk_sketch_unindex(sketch, counter);
+    slot = hash & mask;
+    while (sketch->index[slot] != 0)
+      slot = (slot + 1) & mask;
+  }
+
+  char *stored = sketch->keys + (size_t)counter * sketch->key_max;
+  int i = 0;
+  for (; i < length && key[i] != '\0'; i++)
+    stored[i] = key[i];
+  stored[i] = '\0';
+  sketch->counters[counter] =
+      (topk_counter_t){minimum + count, minimum, hash, position};
+  sketch->heap[position] = counter;
+  sketch->index[slot] = counter + 1;
+  if (position == 0)
+    topk_sketch_sift_down(sketch, 0);
+  else
+    topk_sketch_sift_up(sketch, position);
+}
+
+/*
+ * Najväčšia možná chyba počtu: najmenší počet, ktorý zdedí nahradzujúci
+ * kľúč (0, kým je voľné počítadlo). Nepresiahne total / counters.
+ */
+long topk_sketch_bound(topk_sketch_t *sketch)
+{
+  if (sketch->size < sketch->capacity)
+    return 0;
+  return sketch->counters[sketch->heap[0]].count;
+}
+
+/*
+ * Najčastejších k kľúčov náčrtu s odhadom počtu a chyby, zoradených ako pri
+ * presnom výbere. Kľúče patria náčrtu a platia do ďalšieho pripočítania.
+ */
+int topk_sketch_top(topk_sketch_t *sketch, int k, topk_entry_t **entries)
+{
+  topk_heap_t heap;
+  *entries = NULL;
+  if (!topk_init(&heap, k))
+    return 0;
+  for (int i = 0; i < sketch->size; i++)
+  {
+    topk_counter_t *counter = &sketch->counters[i];
+    topk_entry_t entry = {counter->count, counter->error,
+                          sketch->keys + (size_t)i * sketch->key_max, 0};
+    topk_offer(&heap, entry);
+  }
+  return topk_finish(&heap, entries);
+}
+
+void topk_sketch_dispose(topk_sketch_t *sketch)
+{
+  free(sketch->counters);
+  free(sketch->keys);
+  free(sketch->heap);
+  free(sketch->index);
+  sketch->counters = NULL;
+  sketch->keys = NULL;
+  sketch->heap = NULL;
+  sketch->index = NULL;
+  sketch->size = 0;
+  sketch->capacity = 0;
+  sketch->total = 0;
+}
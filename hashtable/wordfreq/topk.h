@@ -0,0 +1,75 @@
+/*
+ * Hlavičkový súbor pre výber najčastejších kľúčov (top-K).
+ */
+
+#ifndef IAL_HASHTABLE_TOPK_H
+#define IAL_HASHTABLE_TOPK_H
+
+#include "../../btree/btree.h"
+#include "../hashtable.h"
+#include "wordfreq.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Položka výsledku
+typedef struct topk_entry {
+  long count;                   // počet výskytov (pri náčrte horný odhad)
+  long error;                   // o koľko môže count prevyšovať skutočnosť
+  const char *token;            // reťazcový kľúč, alebo NULL
+  bst_key_t key;                // celočíselný kľúč, ak token == NULL
+} topk_entry_t;
+
+/*
+ * Presný výber: halda najviac k najlepších položiek, na vrchole najhoršia.
+ * Položka horšia než vrchol plnej haldy sa zahodí jedným porovnaním.
+ * Poradie: vyšší počet skôr, pri zhode menší kľúč.
+ */
+typedef struct topk_heap {
+  topk_entry_t *entries;
+  int size;
+  int capacity;                 // k
+} topk_heap_t;
+
+bool topk_init(topk_heap_t *heap, int k);
+void topk_offer(topk_heap_t *heap, topk_entry_t entry);
+int topk_finish(topk_heap_t *heap, topk_entry_t **entries);
+void topk_dispose(topk_heap_t *heap);
+
+int topk_table(ht_table_t *table, int k, topk_entry_t **entries);
+int topk_wf(wf_table_t *table, int k, topk_entry_t **entries);
+int topk_tree(bst_node_t *tree, int k, topk_entry_t **entries);
+
+/*
+ * Približný výber z prúdu kľúčov algoritmom Space-Saving s pevným počtom
+ * počítadiel, nezávisle od počtu rôznych kľúčov. Nesledovaný kľúč nahradí
+ * počítadlo s najmenším počtom m a zdedí ho ako chybu. Pre každý kľúč platí
+ * count - error <= skutočný počet <= count a chyba nepresiahne
+ * topk_sketch_bound <= total / counters; každý kľúč s počtom nad touto
+ * hranicou má počítadlo. Kľúče sa ukladajú skrátené na key_max - 1 bajtov.
+ */
+typedef struct topk_counter {
+  long count;
+  long error;
+  uint64_t hash;
+  int position;                 // index v halde
+} topk_counter_t;
+
+typedef struct topk_sketch {
+  topk_counter_t *counters;
+  char *keys;                   // kľúč počítadla i na keys + i * key_max
+  int *heap;                    // počítadlá podľa počtu, na vrchole najmenší
+  int *index;                   // rozptylová tabuľka: počítadlo + 1, 0 voľné
+  int index_mask;
+  int size;
+  int capacity;                 // počet počítadiel
+  int key_max;
+  long total;                   // súčet všetkých pripočítaných počtov
+} topk_sketch_t;
+
+bool topk_sketch_init(topk_sketch_t *sketch, int counters, int key_max);
+void topk_sketch_add(topk_sketch_t *sketch, const char *key, long count);
+long topk_sketch_bound(topk_sketch_t *sketch);
+int topk_sketch_top(topk_sketch_t *sketch, int k, topk_entry_t **entries);
+void topk_sketch_dispose(topk_sketch_t *sketch);
+
+#endif
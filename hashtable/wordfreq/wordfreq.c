@@ -0,0 +1,502 @@
+/*
+ * Počítanie frekvencií slov a n-gramov
+ *
+ * Slovo je najdlhší úsek písmen, číslic a bajtov nad 0x7f (znaky UTF-8),
+ * veľké písmená ASCII sa prevedú na malé. N-gram je n po sebe idúcich slov
+ * oddelených jednou medzerou. Počty sa v jednom priechode pripočítavajú do
+ * tabuliek z hashtable.c funkciou ht_increment; hodnota prvku má byť double
+ * (preklad s -DHT_VALUE_DOUBLE), aby počty nad 2^24 zostali presné.
+ *
+ * Vstup z deskriptora sa číta po častiach a časti počítajú vlákna fondu
+ * (../../btree/pool.h) do vlastných tabuliek, ktoré sa na konci zlúčia.
+ * Zoradený výsledok dáva wf_top cez binárny vyhľadávací strom z ../../btree.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "wordfreq.h"
+#include "../../btree/btree.h"
+#include "../../btree/pool.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Veľkosť jednej časti vstupu spracovanej jednou úlohou fondu
+#define WF_CHUNK (1 << 20)
+
+// Najviac bajtov prenesených z konca jednej časti na začiatok ďalšej
+#define WF_CARRY_MAX 4096
+
+// Kľúč n-gramu: slová, medzery medzi nimi a ukončovacia nula
+#define WF_KEY_MAX (WF_NGRAM_MAX * (WF_WORD_MAX + 1))
+
+// Počet skupín tabuliek zlučovaných súbežne
+#define WF_MERGE_GROUPS 16
+
+// Faktor automatického vyvažovania stromu kandidátov vo wf_top
+#define WF_REBALANCE_FACTOR 2
+
+static bool wf_word_char(char c)
+{
+  unsigned char u = c;
+  return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') ||
+         (u >= '0' && u <= '9') || u >= 0x80;
+}
+
+/*
+ * Výber tabuľky pre kľúč (FNV-1a). Nezávisí od get_hash, ktorá kľúč potom
+ * rozptýli v rámci vybranej tabuľky.
+ */
+static unsigned wf_shard(const char *key)
+{
+  uint32_t hash = 2166136261u;
+  for (; *key != '\0'; key++)
+  {
+    hash ^= (unsigned char)*key;
+    hash *= 16777619u;
+  }
+  return hash % WF_SHARDS;
+}
+
+static int wf_clamp_ngram(int ngram)
+{
+  if (ngram < 1)
+    return 1;
+  return ngram > WF_NGRAM_MAX ? WF_NGRAM_MAX : ngram;
+}
+
+/*
+ * Inicializácia prázdnej tabuľky frekvencií.
+ */
+void wf_init(wf_table_t *table)
+{
+  for (int s = 0; s < WF_SHARDS; s++)
+    ht_init(&table->shards[s]);
+  table->tokens = 0;
+}
+
+/*
+ * Pripočítanie count výskytov kľúča token. Vracia false pri nedostatku
+ * pamäti.
+ */
+bool wf_add(wf_table_t *table, char *token, long count)
+{
+  return ht_increment(&table->shards[wf_shard(token)], token, count) != NULL;
+}
+
+/*
+ * Rozdelenie úseku text na n-gramy. Slová začínajúce pred pozíciou begin sú
+ * len kontextom n-gramov z predchádzajúcej časti vstupu a samy sa
+ * nepočítajú. Vracia počet započítaných slov.
+ */
+static long wf_scan(const char *text, size_t length, size_t begin, int ngram,
+                    wf_visit_t visit, void *data)
+{
+  // Poslednych ngram slov v kruhovom poli
+  size_t starts[WF_NGRAM_MAX];
+  size_t lengths[WF_NGRAM_MAX];
+  char key[WF_KEY_MAX];
+  long words = 0;
+  long tokens = 0;
+  size_t i = 0;
+
+  while (true)
+  {
+    while (i < length && !wf_word_char(text[i]))
+      i++;
+    if (i == length)
+      break;
+    size_t start = i;
+    while (i < length && wf_word_char(text[i]))
+      i++;
+
+    int slot = words % ngram;
+    starts[slot] = start;
+    lengths[slot] = i - start < WF_WORD_MAX ? i - start : WF_WORD_MAX;
+    words++;
+    if (start < begin)
+      continue;
+    tokens++;
+    if (words < ngram)
+      continue;
+
+    size_t size = 0;
+    for (int w = 0; w < ngram; w++)
+    {
+      int from = (words - ngram + w) % ngram;
+      if (w > 0)
+        key[size++] = ' ';
+      for (size_t c = 0; c < lengths[from]; c++)
+      {
+        char ch = text[starts[from] + c];
+        key[size++] = ch >= 'A' && ch <= 'Z' ? ch - 'A' + 'a' : ch;
+      }
+    }
+    key[size] = '\0';
+    visit(key, data);
+  }
+  return tokens;
+}
+
+static void wf_visit_add(char *token, void *data)
+{
+  wf_add(data, token, 1);
+}
+
+/*
+ * Počítanie n-gramov úseku text do tabuľky (viď wf_scan).
+ */
+static void wf_count_span(wf_table_t *table, const char *text, size_t length,
+                          size_t begin, int ngram)
+{
+  table->tokens += wf_scan(text, length, begin, ngram, wf_visit_add, table);
+}
+
+/*
+ * Rozdelenie textu na n-gramy pre iného príjemcu než tabuľku (napr. náčrt
+ * z topk.h). Vracia počet slov.
+ */
+long wf_tokenize(const char *text, size_t length, int ngram, wf_visit_t visit,
+                 void *data)
+{
+  return wf_scan(text, length, 0, wf_clamp_ngram(ngram), visit, data);
+}
+
+/*
+ * Počítanie n-gramov celého textu v jednom vlákne.
+ */
+void wf_count(wf_table_t *table, const char *text, size_t length, int ngram)
+{
+  wf_count_span(table, text, length, 0, wf_clamp_ngram(ngram));
+}
+
+/*
+ * Zlúčenie zodpovedajúcich si tabuliek: prvky chýbajúce v into sa do nej
+ * prepoja bez kopírovania, počty ostatných sa pripočítajú. Rovnaký kľúč
+ * má v oboch tabuľkách rovnaký index, netreba ho znovu rozptyľovať. Prvky
+ * alokuje ht_increment výchozím alokátorom, rovnako ich uvoľní aj
+ * wf_dispose.
+ */
+static void wf_merge_shard(ht_table_t *into, ht_table_t *from)
+{
+  for (int b = 0; b < HT_SIZE; b++)
+  {
+    ht_item_t *item = (*from)[b];
+    while (item != NULL)
+    {
+      ht_item_t *next = item->next;
+      ht_item_t *same = (*into)[b];
+      while (same != NULL && strcmp(same->key, item->key) != 0)
+        same = same->next;
+      if (same != NULL)
+      {
+        same->value += item->value;
+        ht_free_item(NULL, item);
+      }
+      else
+      {
+        item->next = (*into)[b];
+        (*into)[b] = item;
+      }
+      item = next;
+    }
+    (*from)[b] = NULL;
+  }
+}
+
+/*
+ * Presun všetkých počtov z other do table; other zostane prázdna.
+ */
+void wf_merge(wf_table_t *table, wf_table_t *other)
+{
+  for (int s = 0; s < WF_SHARDS; s++)
+    wf_merge_shard(&table->shards[s], &other->shards[s]);
+  table->tokens += other->tokens;
+  other->tokens = 0;
+}
+
+// Zlúčenie jednej skupiny tabuliek všetkých vlákien
+typedef struct wf_merge_job {
+  wf_table_t *table;
+  wf_table_t *others;
+  int count;
+  int group;
+} wf_merge_job_t;
+
+static void wf_merge_task(void *arg, int worker)
+{
+  (void)worker;
+  wf_merge_job_t *job = arg;
+  int first = job->group * WF_SHARDS / WF_MERGE_GROUPS;
+  int last = (job->group + 1) * WF_SHARDS / WF_MERGE_GROUPS;
+  for (int t = 0; t < job->count; t++)
+  {
+    for (int s = first; s < last; s++)
+      wf_merge_shard(&job->table->shards[s], &job->others[t].shards[s]);
+  }
+}
+
+// Časť vstupu a tabuľky vlákien, do ktorých ju úloha započíta
+typedef struct wf_job {
+  const char *text;
+  size_t length;
+  size_t begin;
+  int ngram;
+  wf_table_t *tables;
+} wf_job_t;
+
+static void wf_task(void *arg, int worker)
+{
+  wf_job_t *job = arg;
+  wf_count_span(&job->tables[worker], job->text, job->length, job->begin,
+                job->ngram);
+}
+
+/*
+ * Rozdelenie prečítaných dát na časť pre úlohu a prenos do ďalšej časti.
+ *
+ * Vracia dĺžku časti, ktorá končí pred nedokončeným slovom; do *carry zapíše
+ * začiatok prenosu, ktorý obsahuje ešte ngram-1 predchádzajúcich slov ako
+ * kontext. Slovo dlhšie ako polovica prenosu sa rozdelí a pri dlhých
+ * medzerách sa kontext skráti, prenos sa tak vždy vojde do WF_CARRY_MAX.
+ */
+static size_t wf_split(const char *text, size_t total, int ngram,
+                       size_t *carry)
+{
+  size_t boundary = total;
+  while (boundary > 0 && total - boundary < WF_CARRY_MAX / 2 &&
+         wf_word_char(text[boundary - 1]))
+    boundary--;
+  if (boundary > 0 && wf_word_char(text[boundary - 1]))
+    boundary = total;
+
+  size_t start = boundary;
+  for (int w = 1; w < ngram; w++)
+  {
+    size_t i = start;
+    while (i > 0 && !wf_word_char(text[i - 1]))
+      i--;
+    while (i > 0 && wf_word_char(text[i - 1]))
+      i--;
+    if (total - i > WF_CARRY_MAX)
+      break;
+    start = i;
+  }
+  *carry = start;
+  return boundary;
+}
+
+/*
+ * Počítanie n-gramov z deskriptora fd až do konca vstupu; počty sa pripočítajú
+ * do table.
+ *
+ * Číta sa po častiach do dvoch sád vyrovnávacích pamätí: kým vlákna fondu
+ * počítajú jednu sadu, hlavné vlákno číta do druhej. Každé vlákno počíta do
+ * vlastnej tabuľky, takže sa nezamyká; tabuľky sa na konci zlúčia po
+ * skupinách tiež vo fonde. Vracia false pri chybe čítania alebo nedostatku
+ * pamäti; table potom zostane nezmenená. Deskriptor funkcia nezatvára.
+ */
+bool wf_count_fd(wf_table_t *table, int fd, int ngram, struct bst_pool *pool)
+{
+  ngram = wf_clamp_ngram(ngram);
+  int workers = bst_pool_size(pool);
+  size_t slot_size = WF_CARRY_MAX + WF_CHUNK;
+  char *buffers = malloc(2 * workers * slot_size);
+  wf_job_t *jobs = malloc(2 * workers * sizeof(wf_job_t));
+  wf_table_t *tables = malloc(workers * sizeof(wf_table_t));
+  bool valid = buffers != NULL && jobs != NULL && tables != NULL;
+  bool end = !valid;
+  for (int w = 0; tables != NULL && w < workers; w++)
+    wf_init(&tables[w]);
+
+  // Predchadzajuca cast, z ktorej sa prenasa koniec
+  const char *previous = NULL;
+  size_t previous_total = 0;
+  size_t previous_length = 0;
+  size_t previous_carry = 0;
+  int set = 0;
+
+  while (!end)
+  {
+    int count = 0;
+    for (; count < workers && !end; count++)
+    {
+      int slot = set * workers + count;
+      char *buffer = buffers + slot * slot_size;
+      size_t total = 0;
+      size_t begin = 0;
+      if (previous != NULL)
+      {
+        total = previous_total - previous_carry;
+        memcpy(buffer, previous + previous_carry, total);
+        begin = previous_length - previous_carry;
+      }
+
+      size_t limit = total + WF_CHUNK;
+      while (total < limit)
+      {
+        ssize_t bytes = read(fd, buffer + total, limit - total);
+        if (bytes < 0 && errno == EINTR)
+          continue;
+        if (bytes <= 0)
+        {
+          valid = bytes == 0;
+          end = true;
+          break;
+        }
+        total += bytes;
+      }
+
+      size_t length = total;
+      size_t carry = total;
+      if (!end)
+        length = wf_split(buffer, total, ngram, &carry);
+      jobs[slot] = (wf_job_t){buffer, length, begin, ngram, tables};
+      previous = buffer;
+      previous_total = total;
+      previous_length = length;
+      previous_carry = carry;
+    }
+
+    // Druha sada musi byt spocitana, kym sa do nej zacne znova citat
+    bst_pool_wait(pool);
+    for (int i = 0; i < count && valid; i++)
+      bst_pool_submit(pool, wf_task, &jobs[set * workers + i]);
+    set = 1 - set;
+  }
+  bst_pool_wait(pool);
+
+  if (valid)
+  {
+    wf_merge_job_t groups[WF_MERGE_GROUPS];
+    for (int g = 0; g < WF_MERGE_GROUPS; g++)
+    {
+      groups[g] = (wf_merge_job_t){table, tables, workers, g};
+      bst_pool_submit(pool, wf_merge_task, &groups[g]);
+    }
+    bst_pool_wait(pool);
+    for (int w = 0; w < workers; w++)
+      table->tokens += tables[w].tokens;
+  }
+
+  for (int w = 0; tables != NULL && w < workers; w++)
+    wf_dispose(&tables[w]);
+  free(buffers);
+  free(jobs);
+  free(tables);
+  return valid;
+}
+
+// Položky porovnávané funkciou wf_compare; kľúč uzla je index do poľa
+static _Thread_local const wf_entry_t *wf_order;
+
+/*
+ * Poradie výsledku: vyšší počet skôr, pri zhode abecedne.
+ */
+static int wf_compare(bst_key_t a, bst_key_t b)
+{
+  const wf_entry_t *x = &wf_order[a];
+  const wf_entry_t *y = &wf_order[b];
+  if (x->count != y->count)
+    return x->count > y->count ? -1 : 1;
+  return strcmp(x->token, y->token);
+}
+
+/*
+ * Najčastejších k kľúčov zoradených podľa počtu (pri zhode abecedne); pre
+ * záporné k všetky kľúče. Výsledok je nové pole *entries (uvoľní ho
+ * volajúci), funkcia vracia jeho dĺžku.
+ *
+ * Kandidáti sa udržujú v binárnom vyhľadávacom strome s najviac k uzlami,
+ * ktorého kľúče sú indexy do poľa položiek a poradie dáva wf_compare.
+ * Najhorší kandidát je najpravejší uzol; lepší kľúč ho nahradí na jeho
+ * indexe. Strom sa vkladá s pravidlom automatického vyvažovania
+ * (bst_insert_key_rebalance), ktorému sa pred každým vložením zadá
+ * skutočný počet uzlov, takže jeho výška zostane O(log k) aj pri kľúčoch
+ * prichádzajúcich v poradí. Zložitosť je O(n log k) amortizovane pre
+ * n rôznych kľúčov a pamäť O(k).
+ */
+int wf_top(wf_table_t *table, int k, wf_entry_t **entries)
+{
+  *entries = NULL;
+  if (k < 0)
+  {
+    k = 0;
+    for (int s = 0; s < WF_SHARDS; s++)
+      for (int b = 0; b < HT_SIZE; b++)
+        for (ht_item_t *item = table->shards[s][b]; item != NULL;
+             item = item->next)
+          k++;
+  }
+  if (k == 0)
+    return 0;
+
+  // Index k je miesto pre porovnavaneho kandidata
+  wf_entry_t *slots = malloc((k + 1) * sizeof(wf_entry_t));
+  if (slots == NULL)
+    return 0;
+  wf_order = slots;
+  bst_node_t *tree;
+  bst_init(&tree);
+  bst_rebalance_t policy = {WF_REBALANCE_FACTOR, 0};
+  int size = 0;
+
+  for (int s = 0; s < WF_SHARDS; s++)
+  {
+    for (int b = 0; b < HT_SIZE; b++)
+    {
+      for (ht_item_t *item = table->shards[s][b]; item != NULL;
+           item = item->next)
+      {
+        wf_entry_t entry = {item->key, (long)item->value};
+        int slot = size;
+        if (size == k)
+        {
+          bst_node_t *worst = tree;
+          while (worst->right != NULL)
+            worst = worst->right;
+          slots[k] = entry;
+          if (wf_compare(k, worst->key) >= 0)
+            continue;
+          slot = worst->key;
+          bst_delete_key(&tree, slot, wf_compare);
+        }
+        else
+          size++;
+        slots[slot] = entry;
+        bst_node_content_t content = {.value = NULL, .type = INTEGER};
+        policy.count = size - 1;
+        bst_insert_key_rebalance(&tree, slot, content, wf_compare, NULL,
+                                 &policy);
+      }
+    }
+  }
+
+  bst_items_t items = {NULL, 0, 0};
+  bst_inorder(tree, &items);
+  wf_entry_t *result = malloc(items.size * sizeof(wf_entry_t));
+  if (result != NULL)
+  {
+    for (int i = 0; i < items.size; i++)
+      result[i] = slots[items.nodes[i]->key];
+    *entries = result;
+  }
+  else
+    size = 0;
+  free(items.nodes);
+  bst_dispose(&tree);
+  free(slots);
+  return size;
+}
+
+/*
+ * Zrušenie všetkých počtov; tabuľka zostane v stave po inicializácii.
+ */
+void wf_dispose(wf_table_t *table)
+{
+  for (int s = 0; s < WF_SHARDS; s++)
+    ht_delete_all(&table->shards[s]);
+  table->tokens = 0;
+}
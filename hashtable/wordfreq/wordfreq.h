@@ -0,0 +1,53 @@
+/*
+ * Hlavičkový súbor pre počítanie frekvencií slov a n-gramov.
+ */
+
+#ifndef IAL_HASHTABLE_WORDFREQ_H
+#define IAL_HASHTABLE_WORDFREQ_H
+
+#include "../hashtable.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+struct bst_pool;
+
+// Počet tabuliek, medzi ktoré sa kľúče rozdelia podľa rozptylovej funkcie
+#define WF_SHARDS 256
+
+// Dlhšie slová sa skrátia na prvých WF_WORD_MAX bajtov
+#define WF_WORD_MAX 64
+
+// Najväčšie n pre n-gramy
+#define WF_NGRAM_MAX 8
+
+/*
+ * Tabuľka frekvencií. Jedna ht_table_t má najviac MAX_HT_SIZE zoznamov, čo
+ * pre korpus so stovkami tisíc rôznych slov nestačí; kľúče sa preto najprv
+ * rozdelia medzi WF_SHARDS tabuliek. HT_SIZE sa počas života tabuľky nesmie
+ * meniť.
+ */
+typedef struct wf_table {
+  ht_table_t shards[WF_SHARDS];
+  long tokens;                  // počet spracovaných slov
+} wf_table_t;
+
+// Položka výsledku: kľúč patrí tabuľke a platí do wf_dispose
+typedef struct wf_entry {
+  const char *token;            // slovo alebo n-gram (slová oddelené medzerou)
+  long count;                   // počet výskytov
+} wf_entry_t;
+
+// Funkcia volaná pre každý n-gram textu; kľúč platí len počas volania
+typedef void (*wf_visit_t)(char *token, void *data);
+
+void wf_init(wf_table_t *table);
+bool wf_add(wf_table_t *table, char *token, long count);
+long wf_tokenize(const char *text, size_t length, int ngram, wf_visit_t visit,
+                 void *data);
+void wf_count(wf_table_t *table, const char *text, size_t length, int ngram);
+bool wf_count_fd(wf_table_t *table, int fd, int ngram, struct bst_pool *pool);
+void wf_merge(wf_table_t *table, wf_table_t *other);
+int wf_top(wf_table_t *table, int k, wf_entry_t **entries);
+void wf_dispose(wf_table_t *table);
+
+#endif